@@ -23,6 +23,7 @@ SOURCES += main.cpp\
     model/datetime.cpp \
     model/calendar.cpp \
     model/calendarsmodel.cpp \
+    model/calendarcombiner.cpp \
     model/resource.cpp \
     model/resourcesmodel.cpp \
     model/task.cpp \
@@ -34,13 +35,25 @@ SOURCES += main.cpp\
     delegate/xtimeedit.cpp \
     gui/ganttchart.cpp \
     gui/ganttscale.cpp \
+    gui/rowgeometry.cpp \
+    gui/ganttrenderer.cpp \
+    gui/ganttexport.cpp \
     delegate/xdateedit.cpp \
     delegate/timespanspinbox.cpp \
     delegate/xdatetimeedit.cpp \
     model/predecessors.cpp \
     model/ganttdata.cpp \
+    model/ganttbatch.cpp \
+    model/labelcache.cpp \
     model/taskresources.cpp \
-    model/resourcefree.cpp
+    model/resourcefree.cpp \
+    model/taskstore.cpp \
+    model/taskintervals.cpp \
+    model/tag.cpp \
+    model/journal.cpp \
+    model/plansnapshot.cpp \
+    model/planloader.cpp \
+    model/plancompress.cpp
 
 HEADERS  += \
     gui/mainwindow.h \
@@ -54,6 +67,7 @@ HEADERS  += \
     model/datetime.h \
     model/calendar.h \
     model/calendarsmodel.h \
+    model/calendarcombiner.h \
     model/resource.h \
     model/resourcesmodel.h \
     model/task.h \
@@ -70,17 +84,34 @@ HEADERS  += \
     delegate/xtimeedit.h \
     gui/ganttchart.h \
     gui/ganttscale.h \
+    gui/rowgeometry.h \
+    gui/ganttrenderer.h \
+    gui/ganttexport.h \
     delegate/xdateedit.h \
     delegate/timespanspinbox.h \
     delegate/xdatetimeedit.h \
     command/commandpropertieschange.h \
     command/commandtaskindent.h \
     command/commandtaskoutdent.h \
+    command/undocommand.h \
+    command/commandbatch.h \
+    command/commandtaskpaste.h \
     model/task_schedule.h \
     model/predecessors.h \
     model/ganttdata.h \
+    model/ganttbatch.h \
+    model/labelcache.h \
+    model/journal.h \
+    model/plansnapshot.h \
+    model/planloader.h \
+    model/plancompress.h \
     model/taskresources.h \
-    model/resourcefree.h
+    model/resourcefree.h \
+    model/taskstore.h \
+    model/taskintervals.h \
+    model/objectpool.h \
+    model/tag.h \
+    model/scanner.h
 
 FORMS += \
     gui/mainwindow.ui \
@@ -0,0 +1,96 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef COMMANDBATCH_H
+#define COMMANDBATCH_H
+
+#include <QList>
+
+#include "command/undocommand.h"
+
+#include "model/plan.h"
+
+/*************************************************************************************************/
+/************ Command batching many commands into one QUndoStack entry, scheduled once ***********/
+/*************************************************************************************************/
+
+class CommandBatch : public UndoCommand
+{
+public:
+  CommandBatch( const QString& text )
+  {
+    // set private variables, commands are done as added so first redo when pushed is skipped
+    m_done = true;
+    setText( text );
+    account();
+  }
+
+  ~CommandBatch()
+  {
+    // batch owns its commands
+    qDeleteAll( m_commands );
+  }
+
+  int   count() const { return m_commands.size(); }
+
+  void  add( UndoCommand* command )
+  {
+    // do command now so later commands in batch see its changes
+    command->redo();
+    m_commands.append( command );
+    account();
+  }
+
+  void  redo()
+  {
+    // redo all commands in order, holding scheduling & model signals until all done
+    if ( m_done ) { m_done = false; return; }
+    plan->holdSchedule();
+    for( int c = 0 ; c < m_commands.size() ; c++ ) m_commands.at(c)->redo();
+    plan->releaseSchedule();
+  }
+
+  void  undo()
+  {
+    // undo all commands in reverse order, holding scheduling & model signals until all done
+    plan->holdSchedule();
+    for( int c = m_commands.size() - 1 ; c >= 0 ; c-- ) m_commands.at(c)->undo();
+    plan->releaseSchedule();
+  }
+
+protected:
+  int  recordBytes() const
+  {
+    // return approx memory of batch, the commands account for themselves
+    return sizeof(*this) + m_commands.size() * sizeof(UndoCommand*);
+  }
+
+  void  compactRecord()
+  {
+    // compact all commands in batch
+    foreach( UndoCommand* command, m_commands ) command->compact();
+  }
+
+private:
+  QList<UndoCommand*>  m_commands;   // commands in batch, in order done
+  bool                 m_done;       // true when commands already done so next redo skipped
+};
+
+#endif // COMMANDBATCH_H
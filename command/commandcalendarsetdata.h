@@ -21,7 +21,7 @@
 #ifndef COMMANDCALENDARSETDATA_H
 #define COMMANDCALENDARSETDATA_H
 
-#include <QUndoCommand>
+#include "command/undocommand.h"
 
 #include "model/plan.h"
 #include "model/calendar.h"
@@ -31,22 +31,35 @@
 /*********************** Command for setting Calendar data via QUndoStack ************************/
 /*************************************************************************************************/
 
-class CommandCalendarSetData : public QUndoCommand
+class CommandCalendarSetData : public UndoCommand
 {
 public:
   CommandCalendarSetData( const QModelIndex& index, const QVariant& value )
   {
-    // set private variables for new and old values
+    // set private variables for new value
     m_row     = index.row();
     m_column  = index.column();
-    m_old_cal = *( plan->calendar( m_column ) );
     m_value   = value;
 
+    // record only the calendar data the new value will overwrite
+    Calendar* cal = plan->calendar( m_column );
+    if ( m_row == Calendar::SECTION_NAME )   m_old_value = cal->m_name;
+    if ( m_row == Calendar::SECTION_ANCHOR ) m_old_value = cal->m_cycleAnchor;
+    if ( m_row == Calendar::SECTION_CYCLELENGTH )
+    {
+      // reducing cycle length loses the normal days beyond the new length
+      m_old_value = cal->m_cycleLength;
+      m_old_days  = cal->m_normal.mid( value.toInt() );
+    }
+    if ( m_row >= Calendar::SECTION_NORMAL1 )
+      m_old_days = cal->m_normal.mid( m_row - Calendar::SECTION_NORMAL1, 1 );
+
     // construct command description
     setText( QString("Calendar %1 %2 = %3")
              .arg( m_column+1 )
              .arg( Calendar::headerData( m_row ).toString() )
              .arg( value.toString() ) );
+    account();
   }
 
   void  redo()
@@ -62,35 +75,78 @@ public:
 
   void  undo()
   {
-    // revert calendar to old definition, checking if table model number of rows changes
-    int oldRows = plan->calendars()->rowCount();
-    *( plan->calendar( m_column ) ) = m_old_cal;
-    int newRows = plan->calendars()->rowCount();
-    if ( oldRows != newRows )
+    // revert calendar to old values
+    Calendar* cal = plan->calendar( m_column );
+    if ( m_row == Calendar::SECTION_NAME )   cal->m_name = m_old_value.toUInt();
+    if ( m_row == Calendar::SECTION_ANCHOR ) cal->m_cycleAnchor = m_old_value.toInt();
+    if ( m_row >= Calendar::SECTION_NORMAL1 )
+      cal->m_normal[ m_row - Calendar::SECTION_NORMAL1 ] = m_old_days.at( 0 );
+
+    if ( m_row == Calendar::SECTION_CYCLELENGTH )
     {
-      // table model number of rows has changed, so needs special handling
-      plan->calendar( m_column )->m_cycleLength = m_value.toInt();
+      // check if table model number of rows changes, as needs special handling
+      int oldLength = m_old_value.toInt();
+      int newLength = cal->m_cycleLength;
+      int oldRows   = plan->calendars()->rowCount();
+      cal->m_cycleLength = oldLength;
+      int newRows   = plan->calendars()->rowCount();
+      cal->m_cycleLength = newLength;
 
       if ( newRows > oldRows ) plan->calendars()->beginInsert( newRows - oldRows );
       if ( newRows < oldRows ) plan->calendars()->beginRemove( oldRows - newRows );
 
-      *( plan->calendar( m_column ) ) = m_old_cal;
+      cal->m_normal.resize( qMin( oldLength, newLength ) );
+      cal->m_normal     += m_old_days;
+      cal->m_cycleLength = oldLength;
 
       if ( newRows > oldRows ) plan->calendars()->endInsert();
       if ( newRows < oldRows ) plan->calendars()->endRemove();
     }
 
-    // ensure table row is refreshed, and plan re-scheduled if needed
+    // ensure combined calendars, table row are refreshed, and plan re-scheduled if needed
+    plan->calendars()->combiner().invalidate();
     plan->calendars()->emitDataChangedColumn( m_column );
     if ( m_row == Calendar::SECTION_NAME ) plan->calendars()->emitNameChanged();
     if ( m_row != Calendar::SECTION_NAME ) plan->schedule();
   }
 
+  int   journalType() const { return JOURNAL_CALENDAR_SETDATA; }
+
+  void  writeJournal( QDataStream& out ) const
+  {
+    // write arguments needed to re-create command
+    out << qint32( m_row ) << qint32( m_column ) << m_value;
+  }
+
+  int   id() const { return ID_CALENDAR_SETDATA; }
+
+  bool  mergeWith( const QUndoCommand* other )
+  {
+    // merge rapid successive edits to same cell, except cycle length as changes table rows
+    const CommandCalendarSetData* edit = static_cast<const CommandCalendarSetData*>( other );
+    if ( edit->m_row != m_row || edit->m_column != m_column ||
+         m_row == Calendar::SECTION_CYCLELENGTH ) return false;
+    if ( !isRapid( edit ) ) return false;
+
+    m_value = edit->m_value;
+    setText( edit->text() );
+    account();
+    return true;
+  }
+
+protected:
+  int  recordBytes() const
+  {
+    // return approx memory of undo record
+    return sizeof(*this) + sizeOf( m_value ) + m_old_days.size() * sizeof(Day*);
+  }
+
 private:
-  int       m_row;
-  int       m_column;
-  Calendar  m_old_cal;  // need whole copy for undo since reducing cycle length will lose data
-  QVariant  m_value;
+  int            m_row;
+  int            m_column;
+  QVariant       m_value;
+  QVariant       m_old_value;  // old name tag, anchor date, or cycle length
+  QVector<Day*>  m_old_days;   // old normal day, or normal days lost by reducing cycle length
 };
 
 #endif // COMMANDCALENDARSETDATA_H
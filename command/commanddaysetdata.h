@@ -21,32 +21,51 @@
 #ifndef COMMANDDAYSETDATA_H
 #define COMMANDDAYSETDATA_H
 
-#include <QUndoCommand>
+#include "command/undocommand.h"
 
 #include "model/plan.h"
 #include "model/day.h"
 #include "model/daysmodel.h"
+#include "model/calendarsmodel.h"
 
 /*************************************************************************************************/
 /*********************** Command for setting Day type data via QUndoStack ************************/
 /*************************************************************************************************/
 
-class CommandDaySetData : public QUndoCommand
+class CommandDaySetData : public UndoCommand
 {
 public:
   CommandDaySetData( const QModelIndex& index, const QVariant& value )
   {
-    // set private variables for new and old values
+    // set private variables for new value
     m_row     = index.row();
     m_column  = index.column();
-    m_old_day = *( plan->day( m_row ) );
     m_value   = value;
 
+    // record only the day type data the new value will overwrite
+    Day* day = plan->day( m_row );
+    if ( m_column == Day::SECTION_NAME ) m_old_value = day->m_name;
+    if ( m_column == Day::SECTION_WORK ) m_old_value = day->m_work;
+    if ( m_column == Day::SECTION_PERIODS )
+    {
+      // reducing number of periods loses the periods beyond the new number
+      m_old_value = day->m_periods;
+      for( int p = value.toInt() ; p < day->m_periods ; p++ )
+        m_old_times << day->m_start.at(p) << day->m_end.at(p);
+    }
+    if ( m_column >= Day::SECTION_START )
+    {
+      int p = ( m_column - Day::SECTION_START ) / 2;
+      if ( ( m_column - Day::SECTION_START ) % 2 == 0 ) m_old_value = day->m_start.at(p);
+      else                                              m_old_value = day->m_end.at(p);
+    }
+
     // construct command description
     setText( QString("Day %1 %2 = %3")
              .arg( m_row+1 )
              .arg( Day::headerData( m_column ).toString() )
              .arg( value.toString() ) );
+    account();
   }
 
   void  redo()
@@ -62,35 +81,89 @@ public:
 
   void  undo()
   {
-    // revert day type to old definition, checking if table model number of columns changes
-    int oldColumns = plan->days()->columnCount();
-    *( plan->day( m_row ) ) = m_old_day;
-    int newColumns = plan->days()->columnCount();
-    if ( oldColumns != newColumns )
+    // revert day type to old values
+    Day* day = plan->day( m_row );
+    if ( m_column == Day::SECTION_NAME ) day->m_name = m_old_value.toUInt();
+    if ( m_column == Day::SECTION_WORK ) day->m_work = m_old_value.toFloat();
+    if ( m_column >= Day::SECTION_START )
     {
-      // table model number of columns has changed, so needs special handling
-      plan->day( m_row )->m_periods = m_value.toInt();
+      int p = ( m_column - Day::SECTION_START ) / 2;
+      if ( ( m_column - Day::SECTION_START ) % 2 == 0 ) day->m_start[p] = m_old_value.toInt();
+      else                                              day->m_end[p]   = m_old_value.toInt();
+      day->calcMinutes();
+    }
+
+    if ( m_column == Day::SECTION_PERIODS )
+    {
+      // check if table model number of columns changes, as needs special handling
+      int oldPeriods = m_old_value.toInt();
+      int newPeriods = day->m_periods;
+      int oldColumns = plan->days()->columnCount();
+      day->m_periods = oldPeriods;
+      int newColumns = plan->days()->columnCount();
+      day->m_periods = newPeriods;
 
       if ( newColumns > oldColumns ) plan->days()->beginInsert( newColumns - oldColumns );
       if ( newColumns < oldColumns ) plan->days()->beginRemove( oldColumns - newColumns );
 
-      *( plan->day( m_row ) ) = m_old_day;
+      day->m_start.resize( qMin( oldPeriods, newPeriods ) );
+      day->m_end.resize( qMin( oldPeriods, newPeriods ) );
+      for( int t = 0 ; t < m_old_times.size() ; t += 2 )
+      {
+        day->m_start.append( m_old_times.at(t) );
+        day->m_end.append( m_old_times.at(t+1) );
+      }
+      day->m_periods = oldPeriods;
+      day->calcMinutes();
 
       if ( newColumns > oldColumns ) plan->days()->endInsert();
       if ( newColumns < oldColumns ) plan->days()->endRemove();
     }
 
-    // ensure table row is refreshed, and plan re-scheduled if needed
+    // ensure combined calendars, table row are refreshed, and plan re-scheduled if needed
+    plan->calendars()->combiner().invalidate();
     plan->days()->emitDataChangedRow( m_row );
     if ( m_column == Day::SECTION_NAME ) plan->days()->emitNameChanged();
     if ( m_column != Day::SECTION_NAME ) plan->schedule();
   }
 
+  int   journalType() const { return JOURNAL_DAY_SETDATA; }
+
+  void  writeJournal( QDataStream& out ) const
+  {
+    // write arguments needed to re-create command
+    out << qint32( m_row ) << qint32( m_column ) << m_value;
+  }
+
+  int   id() const { return ID_DAY_SETDATA; }
+
+  bool  mergeWith( const QUndoCommand* other )
+  {
+    // merge rapid successive edits to same cell, except periods as changes table columns
+    const CommandDaySetData* edit = static_cast<const CommandDaySetData*>( other );
+    if ( edit->m_row != m_row || edit->m_column != m_column ||
+         m_column == Day::SECTION_PERIODS ) return false;
+    if ( !isRapid( edit ) ) return false;
+
+    m_value = edit->m_value;
+    setText( edit->text() );
+    account();
+    return true;
+  }
+
+protected:
+  int  recordBytes() const
+  {
+    // return approx memory of undo record
+    return sizeof(*this) + sizeOf( m_value ) + m_old_times.size() * sizeof(Time);
+  }
+
 private:
-  int       m_row;
-  int       m_column;
-  Day       m_old_day;  // need whole copy for undo since reducing number of periods will lose data
-  QVariant  m_value;
+  int            m_row;
+  int            m_column;
+  QVariant       m_value;
+  QVariant       m_old_value;  // old name tag, work, number of periods, or period start/end
+  QVector<Time>  m_old_times;  // start & end pairs of periods lost by reducing number of periods
 };
 
 #endif // COMMANDDAYSETDATA_H
@@ -21,7 +21,7 @@
 #ifndef COMMANDPROPERTIESCHANGE_H
 #define COMMANDPROPERTIESCHANGE_H
 
-#include <QUndoCommand>
+#include "command/undocommand.h"
 
 #include "model/plan.h"
 //#include "model/tasksmodel.h"
@@ -30,7 +30,7 @@
 /************************ Command plan properties changes for QUndoStack *************************/
 /*************************************************************************************************/
 
-class CommandPropertiesChange : public QUndoCommand
+class CommandPropertiesChange : public UndoCommand
 {
 public:
   CommandPropertiesChange( QString   title_new, QString   title_old,
@@ -61,6 +61,7 @@ public:
     desc.chop( 1 );
     desc.append( " updated" );
     setText( desc );
+    account();
   }
 
   void  redo()
@@ -93,6 +94,32 @@ public:
          m_start_new != m_start_old ) plan->schedule();
   }
 
+  int   journalType() const { return JOURNAL_PROPERTIES; }
+
+  void  writeJournal( QDataStream& out ) const
+  {
+    // write arguments needed to re-create command
+    out << m_title_new << m_title_old << m_start_new << m_start_old
+        << qint32( m_cal_new ) << qint32( m_cal_old ) << m_dtf_new << m_dtf_old
+        << m_notes_new << m_notes_old;
+  }
+
+protected:
+  int  recordBytes() const
+  {
+    // return approx memory of undo record
+    return sizeof(*this) + sizeOf( m_title_new ) + sizeOf( m_title_old ) +
+           sizeOf( m_dtf_new ) + sizeOf( m_dtf_old ) + sizeOf( m_notes_new ) + sizeOf( m_notes_old );
+  }
+
+  void  compactRecord()
+  {
+    // unchanged properties are never applied, so their text is not needed
+    if ( m_title_new == m_title_old ) m_title_new = m_title_old = QString();
+    if ( m_dtf_new   == m_dtf_old   ) m_dtf_new   = m_dtf_old   = QString();
+    if ( m_notes_new == m_notes_old ) m_notes_new = m_notes_old = QString();
+  }
+
 private:
   QString   m_title_new;
   QString   m_title_old;
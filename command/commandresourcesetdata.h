@@ -21,7 +21,7 @@
 #ifndef COMMANDRESOURCESETDATA_H
 #define COMMANDRESOURCESETDATA_H
 
-#include <QUndoCommand>
+#include "command/undocommand.h"
 
 #include "model/plan.h"
 #include "model/resource.h"
@@ -31,7 +31,7 @@
 /*********************** Command for setting Resource data via QUndoStack ************************/
 /*************************************************************************************************/
 
-class CommandResourceSetData : public QUndoCommand
+class CommandResourceSetData : public UndoCommand
 {
 public:
   CommandResourceSetData( const QModelIndex& index, const QVariant& value )
@@ -47,6 +47,7 @@ public:
              .arg( m_row )
              .arg( Resource::headerData( m_column ).toString() )
              .arg( value.toString() ) );
+    account();
   }
 
   void  redo()
@@ -76,6 +77,36 @@ public:
     if ( plan->resource( m_row )->isNull() ) plan->signalPlanUpdated();
   }
 
+  int   journalType() const { return JOURNAL_RESOURCE_SETDATA; }
+
+  void  writeJournal( QDataStream& out ) const
+  {
+    // write arguments needed to re-create command
+    out << qint32( m_row ) << qint32( m_column ) << m_new_value;
+  }
+
+  int   id() const { return ID_RESOURCE_SETDATA; }
+
+  bool  mergeWith( const QUndoCommand* other )
+  {
+    // merge rapid successive edits to same cell, keeping original old value for undo
+    const CommandResourceSetData* edit = static_cast<const CommandResourceSetData*>( other );
+    if ( edit->m_row != m_row || edit->m_column != m_column ) return false;
+    if ( !isRapid( edit ) ) return false;
+
+    m_new_value = edit->m_new_value;
+    setText( edit->text() );
+    account();
+    return true;
+  }
+
+protected:
+  int  recordBytes() const
+  {
+    // return approx memory of undo record
+    return sizeof(*this) + sizeOf( m_new_value ) + sizeOf( m_old_value );
+  }
+
 private:
   int       m_row;
   int       m_column;
@@ -21,9 +21,10 @@
 #ifndef COMMANDTASKOUTDENT_H
 #define COMMANDTASKOUTDENT_H
 
-#include <QUndoCommand>
 #include <QSet>
 
+#include "command/undocommand.h"
+
 #include "model/plan.h"
 #include "model/tasksmodel.h"
 #include "model/task.h"
@@ -32,7 +33,7 @@
 /************************* Command for outdenting Tasks via QUndoStack ***************************/
 /*************************************************************************************************/
 
-class CommandTaskOutdent : public QUndoCommand
+class CommandTaskOutdent : public UndoCommand
 {
 public:
   CommandTaskOutdent( QSet<int> rows )
@@ -42,13 +43,17 @@ public:
 
     // construct command description
     setText( "Outdent" );
+    account();
   }
 
   void  redo()
   {
     // outdent tasks
     foreach( int row, m_rows )
+    {
       plan->task(row)->setIndent( plan->task(row)->indent() - 1 );
+      plan->tasks()->emitDataChangedRow( row );
+    }
 
     // remove any forbidden predecessors
     plan->tasks()->setSummaries();
@@ -58,9 +63,15 @@ public:
       Task*  task = plan->task(t);
       QString  old_preds = task->predecessorsString();
       QString  new_preds = task->predecessorsClean();
-      if ( old_preds != new_preds ) m_old_preds.insert( t, old_preds );
+      if ( old_preds != new_preds )
+      {
+        m_old_preds.insert( t, old_preds );
+        plan->tasks()->emitDataChangedRow( t );
+      }
     }
 
+    // predecessors record size depends on forbidden predecessors removed
+    account();
     plan->schedule();
   }
 
@@ -68,7 +79,10 @@ public:
   {
     // revert by indenting tasks
     foreach( int row, m_rows )
+    {
       plan->task(row)->setIndent( plan->task(row)->indent() + 1 );
+      plan->tasks()->emitDataChangedRow( row );
+    }
 
     // revert any predecessor changes
     QHashIterator<int, QString> i(m_old_preds);
@@ -76,12 +90,30 @@ public:
     {
         i.next();
         plan->task( i.key() )->setPredecessors( i.value() );
+        plan->tasks()->emitDataChangedRow( i.key() );
     }
 
     plan->tasks()->setSummaries();
     plan->schedule();
   }
 
+  int   journalType() const { return JOURNAL_TASK_OUTDENT; }
+
+  void  writeJournal( QDataStream& out ) const
+  {
+    // write arguments needed to re-create command
+    out << m_rows;
+  }
+
+protected:
+  int  recordBytes() const
+  {
+    // return approx memory of undo record
+    int size = sizeof(*this) + m_rows.size() * sizeof(int);
+    foreach( const QString& preds, m_old_preds ) size += sizeof(int) + sizeOf( preds );
+    return size;
+  }
+
 private:
   QSet<int>            m_rows;
   QHash<int, QString>  m_old_preds;
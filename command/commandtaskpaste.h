@@ -0,0 +1,143 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef COMMANDTASKPASTE_H
+#define COMMANDTASKPASTE_H
+
+#include <QVector>
+
+#include "command/undocommand.h"
+
+#include "model/plan.h"
+#include "model/tasksmodel.h"
+#include "model/task.h"
+
+/*************************************************************************************************/
+/********************* Command for pasting block of Task data via QUndoStack *********************/
+/*************************************************************************************************/
+
+class CommandTaskPaste : public UndoCommand
+{
+public:
+  CommandTaskPaste( int row, int column, const QVector< QVector<QVariant> >& values, int newRows )
+  {
+    // set private variables for new values, invalid values leave cell unchanged
+    m_row     = row;
+    m_column  = column;
+    m_values  = values;
+    m_newRows = newRows;
+
+    // keep old copies of existing tasks being pasted over
+    int  existing = values.size() - newRows;
+    m_old_tasks.reserve( existing );
+    for( int r = 0 ; r < existing ; r++ )
+      m_old_tasks.append( *( plan->task( m_row + r ) ) );
+
+    // construct command description
+    setText( QString("Paste %1 tasks from %2").arg( values.size() ).arg( m_row ) );
+    account();
+  }
+
+  void  redo()
+  {
+    // hold scheduling & row signals so whole paste is scheduled and signalled once
+    plan->holdSchedule();
+    if ( m_newRows > 0 ) plan->tasks()->appendRows( m_newRows );
+
+    // set titles first so all pasted tasks exist before any predecessors refer to them
+    int  title = Task::SECTION_TITLE - m_column;
+    if ( title >= 0 )
+      for( int r = 0 ; r < m_values.size() ; r++ )
+        if ( title < m_values.at(r).size() && m_values.at(r).at(title).isValid() )
+          plan->task( m_row + r )->setData( Task::SECTION_TITLE, m_values.at(r).at(title) );
+
+    for( int r = 0 ; r < m_values.size() ; r++ )
+    {
+      Task*  task = plan->task( m_row + r );
+      for( int c = 0 ; c < m_values.at(r).size() ; c++ )
+        if ( c != title && m_values.at(r).at(c).isValid() )
+          task->setData( m_column + c, m_values.at(r).at(c) );
+      plan->tasks()->emitDataChangedRow( m_row + r );
+    }
+
+    // remove any forbidden predecessors now summaries known, then schedule once
+    plan->tasks()->setSummaries();
+    for( int r = 0 ; r < m_values.size() ; r++ )
+      plan->task( m_row + r )->predecessorsClean();
+
+    plan->schedule();
+    plan->releaseSchedule();
+    plan->signalPlanUpdated();
+  }
+
+  void  undo()
+  {
+    // revert existing tasks back to old values, and remove appended tasks
+    plan->holdSchedule();
+    for( int r = 0 ; r < m_old_tasks.size() ; r++ )
+    {
+      *( plan->task( m_row + r ) ) = m_old_tasks.at(r);
+      plan->task( m_row + r )->bumpVersion();
+      plan->tasks()->emitDataChangedRow( m_row + r );
+    }
+    if ( m_newRows > 0 ) plan->tasks()->removeLastRows( m_newRows );
+
+    // re-schedule once
+    plan->tasks()->setSummaries();
+    plan->schedule();
+    plan->releaseSchedule();
+    plan->signalPlanUpdated();
+  }
+
+  int   journalType() const { return JOURNAL_TASK_PASTE; }
+
+  void  writeJournal( QDataStream& out ) const
+  {
+    // write arguments needed to re-create command
+    out << qint32( m_row ) << qint32( m_column ) << m_values << qint32( m_newRows );
+  }
+
+protected:
+  int  recordBytes() const
+  {
+    // return approx memory of undo record
+    int size = sizeof(*this);
+    foreach( const Task& task, m_old_tasks ) size += task.bytes();
+    foreach( const QVector<QVariant>& row, m_values )
+      foreach( const QVariant& value, row ) size += sizeOf( value );
+    return size;
+  }
+
+  void  compactRecord()
+  {
+    // old task caches are re-calculated when needed after undo, so not needed
+    for( int r = 0 ; r < m_old_tasks.size() ; r++ )
+      m_old_tasks[r].releaseCaches();
+  }
+
+private:
+  int                           m_row;        // first task row pasted
+  int                           m_column;     // first task column pasted
+  int                           m_newRows;    // number of null tasks appended for paste
+  QVector< QVector<QVariant> >  m_values;     // pasted values, invalid for unchanged cells
+  QVector<Task>                 m_old_tasks;  // copies of existing tasks pasted over
+};
+
+#endif // COMMANDTASKPASTE_H
@@ -21,7 +21,7 @@
 #ifndef COMMANDTASKSETDATA_H
 #define COMMANDTASKSETDATA_H
 
-#include <QUndoCommand>
+#include "command/undocommand.h"
 
 #include "model/plan.h"
 #include "model/tasksmodel.h"
@@ -31,22 +31,26 @@
 /************************* Command for setting Task data via QUndoStack **************************/
 /*************************************************************************************************/
 
-class CommandTaskSetData : public QUndoCommand
+class CommandTaskSetData : public UndoCommand
 {
 public:
   CommandTaskSetData( const QModelIndex& index, const QVariant& value )
   {
-    // set private variables for new and old values
-    m_row      = index.row();
-    m_column   = index.column();
-    m_old_task = *( plan->task( m_row ) );
-    m_value    = value;
+    // set private variables for new value, and old value & indent which are all an edit changes
+    Task*  task  = plan->task( index.row() );
+    m_row        = index.row();
+    m_column     = index.column();
+    m_old_value  = task->dataUndoRole( m_column );
+    m_old_indent = task->indent();
+    m_was_null   = task->isNull();
+    m_value      = value;
 
     // construct command description
     setText( QString("Task %1 %2 = %3")
              .arg( m_row+1 )
              .arg( Task::headerData( m_column ).toString() )
              .arg( value.toString() ) );
+    account();
   }
 
   void  redo()
@@ -67,8 +71,11 @@ public:
 
   void  undo()
   {
-    // revert task back to old values
-    *( plan->task( m_row ) ) = m_old_task;
+    // revert task back to old value and indent, and if back to null task summaries may change
+    Task*  task = plan->task( m_row );
+    task->restoreData( m_column, m_old_value );
+    task->setIndent( m_old_indent );
+    if ( m_was_null && task->isNull() ) plan->tasks()->setSummaries();
 
     // ensure table row is refreshed, and plan re-scheduled if needed
     plan->tasks()->emitDataChangedRow( m_row );
@@ -84,11 +91,43 @@ public:
     }
   }
 
+  int   journalType() const { return JOURNAL_TASK_SETDATA; }
+
+  void  writeJournal( QDataStream& out ) const
+  {
+    // write arguments needed to re-create command
+    out << qint32( m_row ) << qint32( m_column ) << m_value;
+  }
+
+  int   id() const { return ID_TASK_SETDATA; }
+
+  bool  mergeWith( const QUndoCommand* other )
+  {
+    // merge rapid successive edits to same cell, keeping original old value for undo
+    const CommandTaskSetData* edit = static_cast<const CommandTaskSetData*>( other );
+    if ( edit->m_row != m_row || edit->m_column != m_column ) return false;
+    if ( !isRapid( edit ) ) return false;
+
+    m_value = edit->m_value;
+    setText( edit->text() );
+    account();
+    return true;
+  }
+
+protected:
+  int  recordBytes() const
+  {
+    // return approx memory of undo record, only the old & new cell values
+    return sizeof(*this) + sizeOf( m_value ) + sizeOf( m_old_value );
+  }
+
 private:
-  Task      m_old_task;
   int       m_row;
   int       m_column;
   QVariant  m_value;
+  QVariant  m_old_value;
+  short     m_old_indent;
+  bool      m_was_null;
 };
 
 #endif // COMMANDTASKSETDATA_H
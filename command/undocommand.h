@@ -0,0 +1,112 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef UNDOCOMMAND_H
+#define UNDOCOMMAND_H
+
+#include <QUndoCommand>
+#include <QVariant>
+#include <QDateTime>
+#include <QDataStream>
+
+/*************************************************************************************************/
+/************** Base for plan undo commands, accounting memory held by undo records **************/
+/*************************************************************************************************/
+
+class UndoCommand : public QUndoCommand
+{
+public:
+  UndoCommand() { m_bytes = 0; m_compacted = false; m_when = QDateTime::currentMSecsSinceEpoch(); }
+  ~UndoCommand() { total() -= m_bytes; }
+
+  int            bytes() const { return m_bytes; }               // return approx memory held by command
+  bool           isCompacted() const { return m_compacted; }     // return if command already compacted
+  static qint64  totalBytes() { return total(); }                // return approx memory held by all commands
+
+  enum CommandIds               // ids for QUndoStack to try merging successive commands of same type
+  {
+    ID_TASK_SETDATA      = 1,
+    ID_RESOURCE_SETDATA  = 2,
+    ID_CALENDAR_SETDATA  = 3,
+    ID_DAY_SETDATA       = 4
+  };
+
+  static const qint64  MERGE_MSECS = 2000;   // successive edits to same cell within this time are merged
+
+  enum JournalTypes             // types of commands written to plan journal, values must never change
+  {
+    JOURNAL_NONE              = 0,
+    JOURNAL_TASK_SETDATA      = 1,
+    JOURNAL_RESOURCE_SETDATA  = 2,
+    JOURNAL_CALENDAR_SETDATA  = 3,
+    JOURNAL_DAY_SETDATA       = 4,
+    JOURNAL_TASK_INDENT       = 5,
+    JOURNAL_TASK_OUTDENT      = 6,
+    JOURNAL_PROPERTIES        = 7,
+    JOURNAL_TASK_PASTE        = 8
+  };
+
+  virtual int   journalType() const { return JOURNAL_NONE; }   // return journal type, none if not journalled
+  virtual void  writeJournal( QDataStream& ) const {}          // write arguments to re-create command
+  qint64        when() const { return m_when; }                // return when created or last merged
+  void          setWhen( qint64 w ) { m_when = w; }            // set when, so journal replay merges the same
+
+  void  compact()
+  {
+    // release any memory not needed to undo or redo, and update accounting
+    if ( m_compacted ) return;
+    compactRecord();
+    m_compacted = true;
+    account();
+  }
+
+protected:
+  virtual int   recordBytes() const = 0;                         // return approx memory of undo record
+  virtual void  compactRecord() {}                               // release memory not needed for undo
+
+  void  account()
+  {
+    // update memory accounting, must be called once command constructed
+    total() -= m_bytes;
+    m_bytes  = recordBytes() + text().size() * sizeof(QChar);
+    total() += m_bytes;
+  }
+
+  bool  isRapid( const UndoCommand* other )
+  {
+    // return true if other command pushed soon after this one, updating time for any further merge
+    if ( other->m_when - m_when > MERGE_MSECS ) return false;
+    m_when = other->m_when;
+    return true;
+  }
+
+  static int  sizeOf( const QString& s ) { return sizeof(QString) + s.size() * sizeof(QChar); }
+  static int  sizeOf( const QVariant& v )
+    { return sizeof(QVariant) + ( v.type() == QVariant::String ? v.toString().size() * sizeof(QChar) : 0 ); }
+
+private:
+  static qint64&  total() { static qint64 t = 0; return t; }     // running total of all commands memory
+
+  int     m_bytes;       // approx memory held by this command when last accounted
+  bool    m_compacted;   // true once command compacted
+  qint64  m_when;        // when command created, or last merged, in msecs since epoch
+};
+
+#endif // UNDOCOMMAND_H
@@ -23,10 +23,12 @@
 #include "model/tasksmodel.h"
 #include "model/task.h"
 #include "model/plan.h"
+#include "model/ganttbatch.h"
 
 #include <QPaintEvent>
 #include <QPainter>
 #include <QTableView>
+#include <QHeaderView>
 
 /*************************************************************************************************/
 /*********************** GanttChart provides a view of the plan gantt chart **********************/
@@ -100,6 +102,7 @@ void GanttChart::setTable( QTableView* table )
 
   // set private variables with table & plan associated with gantt
   m_table    = table;
+  m_rows.setHeader( m_table ? m_table->verticalHeader() : nullptr );
 
   // connect signals for newly associated m_table
   if ( m_table )
@@ -121,7 +124,13 @@ void GanttChart::setTable( QTableView* table )
   }
 
   // connect plan model gantt changes for general task updates
-  connect( plan->tasks(), SIGNAL(ganttChanged()), this, SLOT(slotTasksChanged()),
+  connect( plan->tasks(), SIGNAL(ganttChanged(int,int)), this, SLOT(slotTasksChanged(int,int)),
+           Qt::UniqueConnection );
+
+  // connect plan model resets & layout changes, as row positions may change without count changing
+  connect( plan->tasks(), SIGNAL(modelReset()), this, SLOT(slotTasksReset()),
+           Qt::UniqueConnection );
+  connect( plan->tasks(), SIGNAL(layoutChanged()), this, SLOT(slotTasksReset()),
            Qt::UniqueConnection );
 }
 
@@ -135,16 +144,27 @@ void GanttChart::slotTasksScrolled( int value )
   update();
 }
 
+/****************************************** tasksReset *******************************************/
+
+void GanttChart::slotTasksReset()
+{
+  // rows may have been re-ordered, hidden or shown, so rebuild row positions and redraw whole chart
+  m_rows.invalidate();
+  update();
+}
+
 /******************************************* taskMoved *******************************************/
 
 void GanttChart::slotTaskMoved( int logicalIndex, int oldVisualIndex, int newVisualIndex )
 {
   Q_UNUSED(logicalIndex);
-  Q_UNUSED(oldVisualIndex);
-  Q_UNUSED(newVisualIndex);
 
-  // update whole chart (could do less?) to reflect row moved on tasks m_table
-  update();
+  // update chart between old and new positions to reflect row moved on tasks m_table
+  int top    = m_rows.y( m_rows.logical( qMin( oldVisualIndex, newVisualIndex ) ) );
+  m_rows.invalidate();
+  int bottom = m_rows.y( m_rows.logical( qMax( oldVisualIndex, newVisualIndex ) ) );
+  bottom    += m_rows.height( m_rows.logical( qMax( oldVisualIndex, newVisualIndex ) ) );
+  update( 0, top - 4, width(), bottom - top + 8 );
 }
 
 /******************************************* taskHeight ******************************************/
@@ -155,15 +175,42 @@ void GanttChart::slotTaskHeightChanged( int row, int oldHeight, int newHeight )
   Q_UNUSED(newHeight);
 
   // update chart at and below row when task m_table row height change
-  update( 0, m_table->rowViewportPosition(row) - 4, width(), height() );
+  m_rows.invalidate();
+  update( 0, m_rows.y(row) - 4, width(), height() );
 }
 
 /****************************************** taskInserted *****************************************/
 
-void GanttChart::slotTasksChanged()
+void GanttChart::slotTasksChanged( int first, int last )
 {
-  // update whole chart
-  update();
+  // update whole chart if no table to locate rows
+  if ( !m_table )
+  {
+    update();
+    return;
+  }
+
+  // if rows not moved they are in order so vertical extent is given by end rows
+  int top, bottom;
+  if ( !m_table->verticalHeader()->sectionsMoved() )
+  {
+    top    = m_rows.y( first );
+    bottom = m_rows.y( last ) + m_rows.height( last );
+  }
+  else
+  {
+    top    = height();
+    bottom = 0;
+    for( int row=first ; row<=last ; row++ )
+    {
+      int y = m_rows.y( row );
+      top    = qMin( top, y );
+      bottom = qMax( bottom, y + m_rows.height( row ) );
+    }
+  }
+
+  // update only chart area covering the changed rows
+  update( 0, top - 4, width(), bottom - top + 8 );
 }
 
 /******************************************* paintEvent ******************************************/
@@ -178,8 +225,12 @@ void GanttChart::paintEvent( QPaintEvent* event )
 
   QPainter p( this );
   shadeNonWorkingDays( &p, x, y, w, h );
-  drawTasks( &p, y, h );
-  drawDependencies( &p, y, h );
+
+  // collect tasks and dependencies drawing into batches then submit together
+  GanttBatch  batch( &p, &m_labels );
+  drawTasks( &batch, x, y, w, h );
+  drawDependencies( &batch, x, y, w, h );
+  batch.submit();
 
   // draw current date-time line
   int now = int( ( XDateTime::currentDateTime() - m_start ) / m_minsPP);
@@ -187,94 +238,187 @@ void GanttChart::paintEvent( QPaintEvent* event )
   p.drawLine( now, y, now, y+h );
 }
 
+/****************************************** visibleRange *****************************************/
+
+void GanttChart::visibleRange( int x, int w, DateTime& from, DateTime& to )
+{
+  // date-time range between x-coords, widened by a day as bars may be stretched within
+  // their day and by a margin for milestone and summary shapes drawn beyond their ends
+  DateTime  margin = 1440u + DateTime( 16 * m_minsPP );
+  DateTime  left   = m_start + DateTime( m_minsPP * qMax( x, 0 ) );
+  from = left > margin ? left - margin : 0u;
+  to   = m_start + DateTime( m_minsPP * ( x + w ) ) + margin;
+}
+
 /**************************************** drawDependencies ***************************************/
 
-void GanttChart::drawDependencies( QPainter* p, int y, int h )
+void GanttChart::drawDependencies( GanttBatch* b, int x, int y, int w, int h )
 {
-  Q_UNUSED( p );
-  Q_UNUSED( y );
-  Q_UNUSED( h );
-  // determine first and last task visible
-  int first = m_table->rowAt( y );
-  int last  = m_table->rowAt( y+h );
+  // determine first and last visual rows visible
+  int first = m_rows.visualAt( y );
+  int last  = m_rows.visualAt( y+h );
   if ( first < 0 ) first = 0;
-  if ( last  < 0 ) last  = plan->tasks()->rowCount() - 1;
+  if ( last  < 0 ) last  = m_rows.count() - 1;
 
-  // for each task
-  for( int t=0 ; t<=plan->tasks()->rowCount()-1 ; t++ )
+  // when zoomed out arrows are sub-pixel so only draw plain links between visible rows
+  if ( isZoomedOut() )
   {
-    Task*        task  = plan->task(t);
-    int          thisY = m_table->rowViewportPosition(t) + ( m_table->rowHeight(t) / 2 );
-    QStringList  preds = task->predecessorsString().split(",", QString::SkipEmptyParts);
+    drawLinks( b, first, last );
+    return;
+  }
+
+  DateTime  from, to;
+  visibleRange( x, w, from, to );
+  const TaskStore&  store = plan->tasks()->store();
+
+  // for each non-null task
+  for( int t=0 ; t<store.size() ; t++ )
+  {
+    if ( store.isNull(t) || m_rows.height(t) == 0 ) continue;
+    Task*  task = plan->task(t);
+    int    tv   = m_rows.visual(t);
 
     // and each task predecessor
-    foreach( QString pred, preds )
+    foreach( const Predecessors::Predecessor& pred, task->predecessors().list() )
+    {
+      int num = store.id( pred.task );
+      if ( num < 0 || m_rows.height(num) == 0 ) continue;
+
+      // if link outside rows or date-times to be drawn, move on to next
+      int nv = m_rows.visual(num);
+      if ( tv < first && nv < first ) continue;
+      if ( tv > last  && nv > last  ) continue;
+      if ( qMax( store.ganttEnd(t), store.ganttEnd(num) ) < from ) continue;
+      if ( qMin( store.ganttStart(t), store.ganttStart(num) ) > to ) continue;
+
+      int thisY  = m_rows.centre(t);
+      int otherY = m_rows.centre(num);
+
+      if ( pred.type == Predecessors::TYPE_FINISH_START )
+        task->ganttData()->drawDependencyFS( b, thisY, otherY, num, m_start, m_minsPP );
+
+      if ( pred.type == Predecessors::TYPE_START_FINISH )
+        task->ganttData()->drawDependencySF( b, thisY, otherY, num, m_start, m_minsPP );
+
+      if ( pred.type == Predecessors::TYPE_FINISH_FINISH )
+        task->ganttData()->drawDependencyFF( b, thisY, otherY, num, m_start, m_minsPP );
+
+      if ( pred.type == Predecessors::TYPE_START_START )
+        task->ganttData()->drawDependencySS( b, thisY, otherY, num, m_start, m_minsPP );
+    }
+  }
+}
+
+/******************************************* drawLinks *******************************************/
+
+void GanttChart::drawLinks( GanttBatch* b, int first, int last )
+{
+  // draw plain line from predecessor end to task start for links between visible rows
+  const TaskStore&  store = plan->tasks()->store();
+  for( int visual=first ; visual<=last ; visual++ )
+  {
+    int t = m_rows.logical( visual );
+    if ( store.isNull(t) || m_rows.height(t) == 0 ) continue;
+    if ( store.ganttStart(t) == XDateTime::NULL_DATETIME ) continue;
+    Task*  task = plan->task(t);
+    int    thisX = int( ( double( store.ganttStart(t) ) - m_start ) / m_minsPP );
+    int    thisY = m_rows.centre(t);
+
+    foreach( const Predecessors::Predecessor& pred, task->predecessors().list() )
     {
-      // extract task number at beginning of predecessor string and type
-      QString type = Predecessors::LABEL_FINISH_START;   // default predecessor type
-      int     num = 0;
-      for( int c=0 ; c<pred.length() ; c++ )
-      {
-        if ( pred.at(c).isDigit() )
-          num = num*10 + pred.at(c).digitValue();
-        else
-        {
-          // not a digit, so must be a type
-          type = QString( pred.at(c) ) + QString( pred.at(c+1) );
-          break;
-        }
-      }
-
-      // if link outside range to be drawn, move on to next
-      if ( t < first && num < first ) continue;
-      if ( t > last  && num > last  ) continue;
-
-      int otherY = m_table->rowViewportPosition(num) + ( m_table->rowHeight(num) / 2 );
-
-      if ( type == Predecessors::LABEL_FINISH_START )
-        task->ganttData()->drawDependencyFS( p, thisY, otherY, num, m_start, m_minsPP );
-
-      if ( type == Predecessors::LABEL_START_FINISH )
-        task->ganttData()->drawDependencySF( p, thisY, otherY, num, m_start, m_minsPP );
-
-      if ( type == Predecessors::LABEL_FINISH_FINISH )
-        task->ganttData()->drawDependencyFF( p, thisY, otherY, num, m_start, m_minsPP );
-
-      if ( type == Predecessors::LABEL_START_START )
-        task->ganttData()->drawDependencySS( p, thisY, otherY, num, m_start, m_minsPP );
+      int num = store.id( pred.task );
+      int nv  = m_rows.visual( num );
+      if ( nv < first || nv > last || m_rows.height(num) == 0 ) continue;
+      if ( store.ganttEnd(num) == XDateTime::NULL_DATETIME ) continue;
+
+      int otherX = int( ( double( store.ganttEnd(num) ) - m_start ) / m_minsPP );
+      b->addLine( GanttBatch::LINK, otherX, m_rows.centre(num), thisX, thisY );
     }
   }
 }
 
 /******************************************* drawTasks *******************************************/
 
-void GanttChart::drawTasks( QPainter* p, int y, int h )
+void GanttChart::drawTasks( GanttBatch* b, int x, int y, int w, int h )
 {
-  // determine first and last task to draw
-  int first = m_table->rowAt( y );
-  int last  = m_table->rowAt( y+h );
+  // determine first and last visual rows to draw
+  int first = m_rows.visualAt( y );
+  int last  = m_rows.visualAt( y+h );
   if ( first < 0 ) first = 0;
-  if ( last  < 0 ) last  = plan->tasks()->rowCount() - 1;
+  if ( last  < 0 ) last  = m_rows.count() - 1;
+
+  DateTime  from, to;
+  visibleRange( x, w, from, to );
+
+  // when zoomed out draw tasks aggregated into coverage per pixel column without labels or deadlines
+  if ( isZoomedOut() )
+  {
+    drawCoverage( b, x, w, first, last );
+    return;
+  }
 
-  // pen for deadline
-  QPen  pen = QPen( Qt::darkGreen );
-  pen.setWidth( 2 );
+  // draw only gantt tasks intersecting visible date-times that are in visible rows
+  const TaskStore&  store = plan->tasks()->store();
+  foreach( int row, store.between( from, to ) )
+  {
+    int visual = m_rows.visual(row);
+    if ( visual < first || visual > last || m_rows.height(row) == 0 ) continue;
+    plan->task(row)->ganttData()->drawTask( b, m_rows.centre(row), m_start, m_minsPP,
+                                            plan->task(row)->dataDisplayRole( Task::SECTION_RES ).toString() );
+  }
 
-  // for each non-null row draw the gantt task & deadline
-  for( int row=first ; row<=last ; row++ )
+  // for each visible non-null row draw labels of tasks ending before visible date-times & deadlines
+  for( int visual=first ; visual<=last ; visual++ )
   {
+    int row = m_rows.logical( visual );
+    if ( store.isNull(row) || m_rows.height(row) == 0 ) continue;
     Task*  task = plan->task(row);
-    if ( task->isNull() ) continue;
-    int y = m_table->rowViewportPosition(row) + ( m_table->rowHeight(row) / 2 );
-    task->ganttData()->drawTask( p, y, m_start, m_minsPP,
-                                 plan->task(row)->dataDisplayRole( Task::SECTION_RES ).toString() );
-
-    if ( task->deadline() == XDateTime::NULL_DATETIME ) continue;
-    int x = task->ganttData()->x( task->deadline(), m_start, m_minsPP );
-    p->setPen( pen );
-    p->drawLine( x, y-4, x, y+4 );
-    p->drawLine( x-4, y, x, y+4 );
-    p->drawLine( x+4, y, x, y+4 );
+    int y = m_rows.centre(row);
+    if ( store.ganttStart(row) != XDateTime::NULL_DATETIME && store.ganttEnd(row) < from )
+      task->ganttData()->drawLabel( b, y, m_start, m_minsPP,
+                                    task->dataDisplayRole( Task::SECTION_RES ).toString() );
+
+    if ( task->deadline() < from || task->deadline() > to ) continue;
+    int dx = task->ganttData()->x( task->deadline(), m_start, m_minsPP );
+    b->addLine( GanttBatch::DEADLINE, dx, y-4, dx, y+4 );
+    b->addLine( GanttBatch::DEADLINE, dx-4, y, dx, y+4 );
+    b->addLine( GanttBatch::DEADLINE, dx+4, y, dx, y+4 );
+  }
+}
+
+/****************************************** drawCoverage *****************************************/
+
+void GanttChart::drawCoverage( GanttBatch* b, int x, int w, int first, int last )
+{
+  // vertical extent of task bars covering each exposed pixel column, top greater than bottom if none
+  QVector<int>  top( w, height() ), bottom( w, 0 );
+  int  h = b->painter()->fontMetrics().lineSpacing() * 2 / 5;   // half task bar height
+
+  // add each visible task gantt start to end, clipped to exposed columns, stretching is sub-pixel
+  const TaskStore&  store = plan->tasks()->store();
+  for( int visual=first ; visual<=last ; visual++ )
+  {
+    int row = m_rows.logical( visual );
+    if ( store.isNull(row) || m_rows.height(row) == 0 ) continue;
+    if ( store.ganttStart(row) == XDateTime::NULL_DATETIME ) continue;
+
+    int xs = qMax( int( ( double( store.ganttStart(row) ) - m_start ) / m_minsPP ) - x, 0 );
+    int xe = qMin( int( ( double( store.ganttEnd(row) ) - m_start ) / m_minsPP ) - x, w - 1 );
+    int y  = m_rows.centre(row);
+    for( int col=xs ; col<=xe ; col++ )
+    {
+      top[col]    = qMin( top[col], y - h );
+      bottom[col] = qMax( bottom[col], y + h );
+    }
+  }
+
+  // draw each covered column once, neighbouring columns of same extent as one rectangle
+  for( int col=0 ; col<w ; col++ )
+  {
+    if ( top[col] > bottom[col] ) continue;
+    int start = col;
+    while ( col+1 < w && top[col+1] == top[start] && bottom[col+1] == bottom[start] ) col++;
+    b->addRect( GanttBatch::COVERAGE, x + start, top[start], col - start + 1, bottom[start] - top[start] );
   }
 }
 
@@ -295,28 +439,14 @@ void GanttChart::shadeNonWorkingDays( QPainter* p, int x, int y, int w, int h )
   Date  dateStart = ( m_start + int( m_minsPP * (x-1) ) ) / 1440u;
   if ( dateStart > XDate::MAX_DATE ) dateStart = XDate::MIN_DATE;
   Date  dateEnd   = ( m_start + int( m_minsPP * (x+w) ) ) / 1440u;
-  int    xs = -1, xe;
   QBrush brush( QColor("#F5F5F5") );
 
-  // for each date check if working and shade accordingly
-  for( Date date = dateStart; date <= dateEnd; date++ )
+  // shade each run of non-working days from calendar cache
+  foreach( const Calendar::Run& run, calendar->nonWorking( dateStart, dateEnd ) )
   {
-    // find m_start of non-working days
-    if ( xs<0 && !calendar->isWorking(date) )
-    {
-      xs = ( date*1440.0 - m_start ) / m_minsPP + 1;
-      if ( xs < 0 ) xs = 0;
-    }
-
-    // find m_end of non-working days and shade the period
-    if ( xs>=0 && calendar->isWorking(date) )
-    {
-      xe = ( date*1440.0 - m_start ) / m_minsPP;
-      p->fillRect( xs, y, xe-xs, h, brush );
-      xs = -1;
-    }
+    int xs = ( run.start*1440.0 - m_start ) / m_minsPP + 1;
+    int xe = ( run.end*1440.0 - m_start ) / m_minsPP;
+    if ( xs < 0 ) xs = 0;
+    p->fillRect( xs, y, xe-xs, h, brush );
   }
-
-  // shade any remaining non-working days
-  if (xs>=0) p->fillRect( xs, y, width(), h, brush );
 }
@@ -24,10 +24,13 @@
 class Calendar;
 class QTableView;
 class PlanModel;
+class GanttBatch;
 
 #include <QWidget>
 
 #include "model/datetime.h"
+#include "rowgeometry.h"
+#include "model/labelcache.h"
 
 /*************************************************************************************************/
 /*********************** GanttChart provides a view of the plan gantt chart **********************/
@@ -48,21 +51,35 @@ public slots:
   void slotTasksScrolled( int );                   // receive vertical scroll events from table
   void slotTaskHeightChanged( int, int, int );     // receive row height change events from table
   void slotTaskMoved( int, int, int );             // receive task row moved events from table
-  void slotTasksChanged();                         // receive task change events from model
+  void slotTasksChanged( int, int );               // receive task rows change events from model
+  void slotTasksReset();                           // receive task rows reset or re-laid out events from model
 
 protected:
   void paintEvent( QPaintEvent* );                 // draw gantt contents
 
 private:
+  static constexpr double  LOD_MINSPP = 1440.0;    // minutes per pixel above which tasks drawn simplified
+  bool  isZoomedOut() const
+    { return m_minsPP > LOD_MINSPP; }              // return true if day less than one pixel wide
+
   DateTime       m_start;                          // start date-time for GanttChart
   DateTime       m_end;                            // start date-time for GanttChart
   double         m_minsPP;                         // minutes per pixel
   QTableView*    m_table;                          // table view associated with the gantt
+  RowGeometry    m_rows;                           // cached row positions of associated table
+  LabelCache     m_labels;                         // laid out task label texts
 
   void shadeNonWorkingDays( QPainter*,
          int, int, int, int );                     // shade gantt chart non working days
-  void drawTasks( QPainter*, int, int );           // draw gantt tasks
-  void drawDependencies( QPainter*, int, int );    // draw gantt tasks dependencies
+  void drawTasks( GanttBatch*,
+         int, int, int, int );                     // draw gantt tasks
+  void drawDependencies( GanttBatch*,
+         int, int, int, int );                     // draw gantt tasks dependencies
+  void drawLinks( GanttBatch*, int, int );         // draw simplified dependencies for zoomed out gantt
+  void drawCoverage( GanttBatch*,
+         int, int, int, int );                     // draw tasks aggregated per column for zoomed out gantt
+  void visibleRange( int, int,
+         DateTime&, DateTime& );                   // date-time range possibly visible between x-coords
 };
 
 #endif // GANTTCHART_H
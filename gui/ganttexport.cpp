@@ -0,0 +1,174 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "ganttexport.h"
+#include "ganttrenderer.h"
+
+#include <QPainter>
+#include <QPdfWriter>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QFileInfo>
+#include <QDir>
+
+/*************************************************************************************************/
+/******************* GanttTile renders one page area into an image on a thread *******************/
+/*************************************************************************************************/
+
+class GanttTile : public QRunnable
+{
+public:
+  GanttTile( const GanttRenderer* renderer, const QRect& area, QImage* image )
+    : m_renderer( renderer ), m_area( area ), m_image( image ) {}
+
+  void run()
+  {
+    // render page area into image, painting onto images is safe away from gui thread
+    QPainter  p( m_image );
+    p.translate( -m_area.topLeft() );
+    m_renderer->render( &p, m_area );
+  }
+
+private:
+  const GanttRenderer*  m_renderer;     // renderer providing table & gantt
+  QRect                 m_area;         // chart area to render
+  QImage*               m_image;        // image to render into
+};
+
+/*************************************************************************************************/
+/*********** GanttExport writes rendered table & gantt to paged PDF or PNG files *****************/
+/*************************************************************************************************/
+
+/****************************************** constructor ******************************************/
+
+GanttExport::GanttExport( const GanttRenderer* renderer )
+{
+  // set renderer providing table & gantt, which must already be prepared
+  m_renderer = renderer;
+}
+
+/********************************************* pages *********************************************/
+
+QList<QRect> GanttExport::pages( const QSize& page ) const
+{
+  // return page areas covering chart, across then down
+  QList<QRect>  areas;
+  QSize         size = m_renderer->size();
+  for( int y=0 ; y<size.height() ; y+=page.height() )
+    for( int x=0 ; x<size.width() ; x+=page.width() )
+      areas.append( QRect( QPoint( x, y ), page ) & QRect( QPoint( 0, 0 ), size ) );
+
+  return areas;
+}
+
+/****************************************** renderPages ******************************************/
+
+bool GanttExport::renderPages( const QList<QRect>& areas,
+                               std::function<bool(int,const QImage&)> write )
+{
+  // render a batch of pages concurrently, then write them in order before the next batch
+  // so only one batch of page images is held in memory at a time
+  QThreadPool  pool;
+  int          batch = qMax( 1, pool.maxThreadCount() );
+  for( int first=0 ; first<areas.size() ; first+=batch )
+  {
+    int              count = qMin( batch, areas.size() - first );
+    QVector<QImage>  images( count );
+    for( int n=0 ; n<count ; n++ )
+    {
+      images[n] = QImage( areas.at(first+n).size(), QImage::Format_ARGB32_Premultiplied );
+      pool.start( new GanttTile( m_renderer, areas.at(first+n), &images[n] ) );
+    }
+    pool.waitForDone();
+
+    for( int n=0 ; n<count ; n++ )
+      if ( !write( first+n, images.at(n) ) ) return false;
+  }
+
+  return true;
+}
+
+/********************************************* toPdf *********************************************/
+
+bool GanttExport::toPdf( const QString& filename )
+{
+  // pdf pages are landscape A3 at screen resolution so one chart pixel is one page pixel
+  QPdfWriter  writer( filename );
+  writer.setPageSize( QPagedPaintDevice::A3 );
+  writer.setPageOrientation( QPageLayout::Landscape );
+  writer.setResolution( 96 );
+  writer.setTitle( QFileInfo( filename ).completeBaseName() );
+
+  QPainter  painter;
+  if ( !painter.begin( &writer ) )
+  {
+    m_error = QString("Failed to write to '%1'").arg( filename );
+    return false;
+  }
+
+  // write each page as it is rendered
+  bool ok = renderPages( pages( QSize( writer.width(), writer.height() ) ),
+    [&writer, &painter]( int n, const QImage& image )
+    {
+      if ( n > 0 ) writer.newPage();
+      painter.drawImage( 0, 0, image );
+      return true;
+    } );
+
+  painter.end();
+  return ok;
+}
+
+/********************************************* toPng *********************************************/
+
+bool GanttExport::toPng( const QString& filename )
+{
+  // single page written to filename, otherwise pages numbered after base name
+  QList<QRect>  areas = pages( QSize( PNG_PAGE, PNG_PAGE ) );
+  QFileInfo     info( filename );
+  QString       base  = info.dir().filePath( info.completeBaseName() );
+
+  return renderPages( areas, [this, &areas, &filename, &base]( int n, const QImage& image )
+    {
+      QString name = filename;
+      if ( areas.size() > 1 ) name = QString("%1-%2.png").arg( base ).arg( n+1, 3, 10, QChar('0') );
+      if ( image.save( name, "PNG" ) ) return true;
+
+      m_error = QString("Failed to write to '%1'").arg( name );
+      return false;
+    } );
+}
+
+/********************************************* page **********************************************/
+
+QImage GanttExport::page( const QSize& size, int n )
+{
+  // return rendered page of given page size, or null image if no such page
+  QList<QRect>  areas = pages( size );
+  if ( n < 0 || n >= areas.size() ) return QImage();
+
+  QImage  image;
+  renderPages( QList<QRect>() << areas.at(n), [&image]( int, const QImage& page )
+    {
+      image = page;
+      return true;
+    } );
+  return image;
+}
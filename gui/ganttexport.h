@@ -0,0 +1,58 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef GANTTEXPORT_H
+#define GANTTEXPORT_H
+
+class GanttRenderer;
+
+#include <QList>
+#include <QRect>
+#include <QImage>
+#include <QString>
+
+#include <functional>
+
+/*************************************************************************************************/
+/*********** GanttExport writes rendered table & gantt to paged PDF or PNG files *****************/
+/*************************************************************************************************/
+
+class GanttExport
+{
+public:
+  GanttExport( const GanttRenderer* );                     // constructor
+
+  bool      toPdf( const QString& );                       // write pages to pdf file
+  bool      toPng( const QString& );                       // write pages to png file(s)
+  QImage    page( const QSize&, int );                     // return rendered page of given page size
+  QString   error() const { return m_error; }              // return description of last failure
+
+  static const int  PNG_PAGE = 2048;                       // png page width & height in pixels
+
+private:
+  QList<QRect>  pages( const QSize& ) const;               // return page areas covering chart
+  bool          renderPages( const QList<QRect>&,
+    std::function<bool(int,const QImage&)> );              // render pages concurrently, write in order
+
+  const GanttRenderer*  m_renderer;     // renderer providing table & gantt
+  QString               m_error;        // description of last failure
+};
+
+#endif // GANTTEXPORT_H
@@ -0,0 +1,250 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "ganttrenderer.h"
+#include "model/plan.h"
+#include "model/task.h"
+#include "model/tasksmodel.h"
+#include "model/ganttbatch.h"
+#include "model/labelcache.h"
+
+#include <QPainter>
+#include <QFontMetrics>
+
+/*************************************************************************************************/
+/*********** GanttRenderer draws task table & gantt for a range without needing widgets **********/
+/*************************************************************************************************/
+
+/****************************************** constructor ******************************************/
+
+GanttRenderer::GanttRenderer( DateTime start, DateTime end, double minsPP, int first, int last )
+{
+  // set date-time range, scale and task rows to render
+  m_start      = start;
+  m_end        = end;
+  m_minsPP     = minsPP;
+  m_first      = first;
+  m_last       = last;
+  m_rowHeight  = 0;
+  m_tableWidth = 0;
+
+  // if no last row given, render up to last non-null task
+  if ( m_last < 0 )
+  {
+    const TaskStore&  store = plan->tasks()->store();
+    m_last = store.size() - 1;
+    while ( m_last > m_first && store.isNull( m_last ) ) m_last--;
+  }
+}
+
+/******************************************** prepare ********************************************/
+
+void GanttRenderer::prepare( const QFont& font )
+{
+  // gather everything needed from plan so rendering only reads prepared data and gantt data
+  m_font = font;
+  QFontMetrics  fm( font );
+  m_rowHeight  = fm.lineSpacing() * 3 / 2;
+  m_tableWidth = fm.width( "Task" );
+
+  // ensure all gantt data stretched now so rendering on other threads only reads it
+  const TaskStore&  store = plan->tasks()->store();
+  for( int id=0 ; id<store.size() ; id++ )
+    plan->task(id)->ganttData()->startX( m_start, m_minsPP );
+
+  int count = m_last - m_first + 1;
+  m_null.resize( count );
+  m_deadlines.resize( count );
+  m_names.clear();
+  m_labels.clear();
+  m_links.clear();
+  for( int i=0 ; i<count ; i++ )
+  {
+    int    row  = m_first + i;
+    Task*  task = plan->task( row );
+    m_null[i]      = store.isNull( row );
+    m_deadlines[i] = -1;
+    if ( m_null[i] )
+    {
+      m_names.append( QString() );
+      m_labels.append( QString() );
+      continue;
+    }
+
+    m_names.append( QString("%1  %2").arg( row+1 ).arg( task->dataDisplayRole( Task::SECTION_TITLE ).toString() ) );
+    m_labels.append( task->dataDisplayRole( Task::SECTION_RES ).toString() );
+    m_tableWidth = qMax( m_tableWidth, fm.width( m_names.last() ) );
+    if ( task->deadline() != XDateTime::NULL_DATETIME )
+      m_deadlines[i] = task->ganttData()->x( task->deadline(), m_start, m_minsPP );
+
+    foreach( const Predecessors::Predecessor& pred, task->predecessors().list() )
+    {
+      Link  link;
+      link.num = store.id( pred.task );
+      if ( link.num < m_first || link.num > m_last ) continue;
+      link.row   = i;
+      link.other = link.num - m_first;
+      link.type  = pred.type;
+      m_links.append( link );
+    }
+  }
+  m_tableWidth = qMin( m_tableWidth, 400 ) + 8;
+
+  // non-working runs, not shaded if one day less than one pixel
+  m_runs.clear();
+  if ( m_minsPP <= 1440.0 )
+    m_runs = plan->calendar()->nonWorking( m_start / 1440u, m_end / 1440u );
+}
+
+/********************************************* size **********************************************/
+
+QSize GanttRenderer::size() const
+{
+  // return pixel size of table & gantt including header row
+  return QSize( m_tableWidth + int( ( m_end - m_start ) / m_minsPP ), rowY( m_last - m_first + 1 ) );
+}
+
+/******************************************** render *********************************************/
+
+void GanttRenderer::render( QPainter* p, const QRect& area ) const
+{
+  // fill background and determine rendered rows intersecting area
+  p->setFont( m_font );
+  p->fillRect( area, Qt::white );
+  int first = qMax( 0, area.top() / m_rowHeight - 1 );
+  int last  = qMin( m_last - m_first, area.bottom() / m_rowHeight );
+
+  // render gantt part of area
+  QRect  gantt = area & QRect( m_tableWidth, 0, size().width() - m_tableWidth, size().height() );
+  if ( !gantt.isEmpty() )
+  {
+    p->save();
+    p->setClipRect( gantt );
+    p->translate( m_tableWidth, 0 );
+    renderGantt( p, gantt.translated( -m_tableWidth, 0 ), first, last );
+    p->restore();
+  }
+
+  // render table part of area
+  if ( area.left() < m_tableWidth )
+  {
+    p->save();
+    p->setClipRect( area & QRect( 0, 0, m_tableWidth, size().height() ) );
+    renderTable( p, first, last );
+    p->restore();
+  }
+}
+
+/****************************************** renderTable ******************************************/
+
+void GanttRenderer::renderTable( QPainter* p, int first, int last ) const
+{
+  // header row then task names with grid lines
+  p->fillRect( 0, 0, m_tableWidth, m_rowHeight, QColor("#F5F5F5") );
+  p->setPen( Qt::black );
+  p->drawText( 4, 0, m_tableWidth-8, m_rowHeight, Qt::AlignLeft | Qt::AlignVCenter, "Task" );
+
+  for( int i=first ; i<=last ; i++ )
+  {
+    int y = rowY( i );
+    p->setPen( Qt::black );
+    p->drawText( 4, y, m_tableWidth-8, m_rowHeight, Qt::AlignLeft | Qt::AlignVCenter, m_names.at(i) );
+    p->setPen( Qt::lightGray );
+    p->drawLine( 0, y + m_rowHeight - 1, m_tableWidth, y + m_rowHeight - 1 );
+  }
+
+  p->setPen( Qt::darkGray );
+  p->drawLine( m_tableWidth-1, 0, m_tableWidth-1, size().height() );
+}
+
+/****************************************** renderGantt ******************************************/
+
+void GanttRenderer::renderGantt( QPainter* p, const QRect& area, int first, int last ) const
+{
+  // shade non-working runs below header
+  QBrush  shade( QColor("#F5F5F5") );
+  foreach( const Calendar::Run& run, m_runs )
+  {
+    int xs = ( run.start*1440.0 - m_start ) / m_minsPP + 1;
+    int xe = ( run.end*1440.0 - m_start ) / m_minsPP;
+    if ( xe < area.left() || xs > area.right() ) continue;
+    p->fillRect( xs, m_rowHeight, xe-xs, area.bottom() - m_rowHeight + 1, shade );
+  }
+
+  // header scale with interval suited to zoom
+  XDateTime::Interval  interval = XDateTime::INTERVAL_YEAR;
+  QString              format   = "yyyy";
+  if ( m_minsPP <= 30.0 )        { interval = XDateTime::INTERVAL_DAY;   format = "dd"; }
+  else if ( m_minsPP <= 240.0 )  { interval = XDateTime::INTERVAL_WEEK;  format = "dd MMM"; }
+  else if ( m_minsPP <= 1440.0 ) { interval = XDateTime::INTERVAL_MONTH; format = "MMM yy"; }
+
+  p->fillRect( area.left(), 0, area.width(), m_rowHeight, QColor("#F5F5F5") );
+  p->setPen( Qt::black );
+  p->drawLine( area.left(), m_rowHeight-1, area.right(), m_rowHeight-1 );
+  DateTime  dt1 = XDateTime::trunc( m_start + DateTime( m_minsPP * qMax( area.left(), 0 ) ), interval );
+  while ( dt1 < m_end )
+  {
+    DateTime  dt2 = XDateTime::next( dt1, interval );
+    int       x1  = dt1 > m_start ? int( ( dt1 - m_start ) / m_minsPP ) : 0;
+    int       x2  = int( ( dt2 - m_start ) / m_minsPP );
+    if ( x1 > area.right() ) break;
+    p->drawLine( x1, 0, x1, m_rowHeight-1 );
+    p->drawText( x1+1, 0, x2-x1-1, m_rowHeight, Qt::AlignCenter, XDate::toString( dt1/1440u, format ) );
+    dt1 = dt2;
+  }
+
+  // tasks, deadlines and dependency links collected into batches
+  LabelCache  labels;
+  GanttBatch  batch( p, &labels );
+  for( int i=first ; i<=last ; i++ )
+  {
+    if ( m_null.at(i) ) continue;
+    int    y    = rowY( i ) + m_rowHeight / 2;
+    Task*  task = plan->task( m_first + i );
+    task->ganttData()->drawTask( &batch, y, m_start, m_minsPP, m_labels.at(i) );
+
+    int dx = m_deadlines.at(i);
+    if ( dx < 0 ) continue;
+    batch.addLine( GanttBatch::DEADLINE, dx, y-4, dx, y+4 );
+    batch.addLine( GanttBatch::DEADLINE, dx-4, y, dx, y+4 );
+    batch.addLine( GanttBatch::DEADLINE, dx+4, y, dx, y+4 );
+  }
+
+  foreach( const Link& link, m_links )
+  {
+    // if link entirely above or below rows in area, move on to next
+    if ( link.row < first && link.other < first ) continue;
+    if ( link.row > last  && link.other > last  ) continue;
+
+    int        thisY  = rowY( link.row ) + m_rowHeight / 2;
+    int        otherY = rowY( link.other ) + m_rowHeight / 2;
+    GanttData* gantt  = plan->task( m_first + link.row )->ganttData();
+    if ( link.type == Predecessors::TYPE_FINISH_START )
+      gantt->drawDependencyFS( &batch, thisY, otherY, link.num, m_start, m_minsPP );
+    if ( link.type == Predecessors::TYPE_START_FINISH )
+      gantt->drawDependencySF( &batch, thisY, otherY, link.num, m_start, m_minsPP );
+    if ( link.type == Predecessors::TYPE_FINISH_FINISH )
+      gantt->drawDependencyFF( &batch, thisY, otherY, link.num, m_start, m_minsPP );
+    if ( link.type == Predecessors::TYPE_START_START )
+      gantt->drawDependencySS( &batch, thisY, otherY, link.num, m_start, m_minsPP );
+  }
+
+  batch.submit();
+}
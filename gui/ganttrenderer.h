@@ -0,0 +1,80 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef GANTTRENDERER_H
+#define GANTTRENDERER_H
+
+class QPainter;
+
+#include <QFont>
+#include <QRect>
+#include <QStringList>
+#include <QVector>
+
+#include "model/datetime.h"
+#include "model/calendar.h"
+
+/*************************************************************************************************/
+/*********** GanttRenderer draws task table & gantt for a range without needing widgets **********/
+/*************************************************************************************************/
+
+class GanttRenderer
+{
+public:
+  GanttRenderer( DateTime, DateTime, double,
+                 int first = 0, int last = -1 );           // constructor for date-times, scale & rows
+
+  void     prepare( const QFont& );                        // gather plan data, call on plan's thread
+  QSize    size() const;                                   // return pixel size of table & gantt
+  void     render( QPainter*, const QRect& ) const;        // render area, thread safe after prepare
+
+private:
+  void     renderTable( QPainter*, int, int ) const;       // render table rows
+  void     renderGantt( QPainter*, const QRect&,
+                        int, int ) const;                  // render gantt scale, shading, tasks & links
+  int      rowY( int i ) const
+             { return m_rowHeight * ( i + 1 ); }           // return top y of i'th rendered row
+
+  struct Link
+  {
+    int    row;                          // rendered row index of task
+    int    other;                        // rendered row index of predecessor
+    int    num;                          // task index of predecessor
+    char   type;                         // predecessor type
+  };
+
+  DateTime                 m_start;          // start date-time of gantt
+  DateTime                 m_end;            // end date-time of gantt
+  double                   m_minsPP;         // minutes per pixel
+  int                      m_first;          // first task row rendered
+  int                      m_last;           // last task row rendered
+  QFont                    m_font;           // font for table & labels
+  int                      m_rowHeight;      // pixel height of each row
+  int                      m_tableWidth;     // pixel width of task table
+
+  QVector<bool>            m_null;           // rendered row is null task
+  QStringList              m_names;          // table text for each rendered row
+  QStringList              m_labels;         // gantt label for each rendered row
+  QVector<int>             m_deadlines;      // deadline x-coord for each rendered row, or -1
+  QVector<Link>            m_links;          // dependency links between rendered rows
+  QVector<Calendar::Run>   m_runs;           // non-working runs across gantt
+};
+
+#endif // GANTTRENDERER_H
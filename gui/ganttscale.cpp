@@ -24,6 +24,7 @@
 #include <QPaintEvent>
 #include <QPainter>
 #include <QMenu>
+#include <QtMath>
 
 /*************************************************************************************************/
 /************************* GanttScale provides a scale for the gantt chart ***********************/
@@ -89,20 +90,25 @@ void   GanttScale::paintEvent( QPaintEvent* event )
     {
       int     width   = x2 - x1 - 1;
       int     descent = p.fontMetrics().descent() + p.fontMetrics().leading() + 1;
-      QString label   = XDate::toString( dt1/1440u, m_format );
-      QRect   rect    = p.boundingRect( x1+1, y, width, h-descent-1, Qt::AlignCenter, label );
+      const QStaticText&  label = m_labels.text( labelText( dt1/1440u ), p.font() );
+      int     labelW  = qCeil( label.size().width() );
+      int     labelH  = p.fontMetrics().height();
 
-      // if bounding rect larger than space available, calc new stretch and redraw
-      if ( width < rect.width() )
+      // if label wider than space available, calc new stretch and redraw
+      if ( labelW > 0 && width < labelW )
       {
-        int newStretch = 1 + m_stretch * width / rect.width();
+        int newStretch = 1 + m_stretch * width / labelW;
         if ( newStretch >= m_stretch ) m_stretch--;
         else m_stretch = newStretch;
         update();
         return;
       }
       else
-        p.drawText( rect.bottomLeft(), label );
+      {
+        // centre label in space above descent, as bounding rect with centre alignment would
+        int top = y + ( h - descent - 1 - labelH ) / 2;
+        p.drawStaticText( x1 + 1 + ( width - labelW ) / 2, top + labelH - 1 - p.fontMetrics().ascent(), label );
+      }
     }
 
     dt1 = dt2;
@@ -140,8 +146,21 @@ void   GanttScale::setInterval( XDateTime::Interval i )
 
 void   GanttScale::setLabelFormat( QString format )
 {
-  // set label text format string
+  // set label text format string, and forget label texts in previous format
   m_format = format;
+  m_labelTexts.clear();
+}
+
+/******************************************* labelText *******************************************/
+
+QString   GanttScale::labelText( Date date )
+{
+  // return label text for interval start date, formatting only once per date
+  auto it = m_labelTexts.find( date );
+  if ( it != m_labelTexts.end() ) return it.value();
+
+  if ( m_labelTexts.size() >= 4096 ) m_labelTexts.clear();
+  return m_labelTexts.insert( date, XDate::toString( date, m_format ) ).value();
 }
 
 /********************************************** menu *********************************************/
@@ -26,8 +26,10 @@ class QMenu;
 
 #include <QWidget>
 #include <QString>
+#include <QHash>
 
 #include "model/datetime.h"
+#include "model/labelcache.h"
 
 /*************************************************************************************************/
 /************************* GanttScale provides a scale for the gantt chart ***********************/
@@ -47,11 +49,15 @@ protected:
   void     paintEvent( QPaintEvent* );             // draw GanttScale contents
 
 private:
+  QString  labelText( Date );                      // return label text for interval start date
+
   DateTime              m_start;             // start date-time for GanttScale
   double                m_minsPP;            // minutes per pixel
   XDateTime::Interval   m_interval;          // interval (XDateTime::INTERVAL_xx)
   QString               m_format;            // label text format
   int                   m_stretch;           // label text stretch factor
+  QHash<Date,QString>   m_labelTexts;        // label text for interval start dates in current format
+  LabelCache            m_labels;            // laid out label texts
 
   QMenu*       m_menu;              // menu for popup context menu
 };
@@ -261,107 +261,124 @@ void MainTabWidget::removePlanTab()
   removeTab( this->indexOf( ui->planTab ) );
 }
 
-/***************************************** saveToStream ******************************************/
+/**************************************** saveToSnapshot *****************************************/
 
-void MainTabWidget::saveToStream( QXmlStreamWriter* stream )
+void MainTabWidget::saveToSnapshot( PlanSnapshot* snapshot )
 {
-  // write display data to xml stream
-  stream->writeStartElement( "display-data" );
+  // capture display data now, to be written to xml stream later
+  PlanSnapshot::Part  gantt     = saveTasksGantt();
+  PlanSnapshot::Part  resources = saveTab( ui->resourcesView, "resources-tab" );
+  PlanSnapshot::Part  calendars = saveTab( ui->calendarsView, "calendars-tab" );
+  PlanSnapshot::Part  days      = saveTab( ui->daysView, "days-tab" );
 
-  saveTasksGanttToStream( stream );
-  saveResourcesTabToStream( stream );
-  saveCalendarsTabToStream( stream );
-  saveDaysTabToStream( stream );
-
-  stream->writeEndElement();  // display-data
-}
-
-/************************************ saveTasksGanttToStream *************************************/
-
-void MainTabWidget::saveTasksGanttToStream( QXmlStreamWriter* stream )
-{
-  // write tasks-gantt data to xml stream
-  stream->writeStartElement( "tasks-gantt" );
-
-  stream->writeAttribute( "start", XDateTime::toString( ui->ganttView->start(), "yyyy-MM-ddThh:mm" ) );
-  stream->writeAttribute( "end", XDateTime::toString( ui->ganttView->end(), "yyyy-MM-ddThh:mm" ) );
-  stream->writeAttribute( "minspp", QString::number( ui->ganttView->minsPP() ) );
-  stream->writeAttribute( "nonworking", "TODO" );
-  stream->writeAttribute( "current", "TODO" );
-  stream->writeAttribute( "upper", "TODO" );
-  stream->writeAttribute( "lower", "TODO" );
-  stream->writeAttribute( "splitter", QString::number( ui->tasksGanttSplitter->sizes().at(0) ) );
-
-  stream->writeStartElement( "upper-scale" );
-  stream->writeAttribute( "interval", ui->ganttView->upperInterval() );
-  stream->writeAttribute( "format", ui->ganttView->upperFormat() );
-  stream->writeEndElement();  // upper-scale
-
-  stream->writeStartElement( "lower-scale" );
-  stream->writeAttribute( "interval", ui->ganttView->lowerInterval() );
-  stream->writeAttribute( "format", ui->ganttView->lowerFormat() );
-  stream->writeEndElement();  // lower-scale
-
-  saveColumnsRowsToStream( ui->tasksView, stream );
-  stream->writeEndElement();  // tasks-gantt
+  snapshot->defer( [gantt, resources, calendars, days]( QXmlStreamWriter* stream )
+  {
+    stream->writeStartElement( "display-data" );
+    gantt( stream );
+    resources( stream );
+    calendars( stream );
+    days( stream );
+    stream->writeEndElement();  // display-data
+  } );
 }
 
-/*********************************** saveResourcesTabToStream ************************************/
+/**************************************** saveTasksGantt *****************************************/
 
-void MainTabWidget::saveResourcesTabToStream( QXmlStreamWriter* stream )
+PlanSnapshot::Part MainTabWidget::saveTasksGantt()
 {
-  // write resources-tab data to xml stream
-  stream->writeStartElement( "resources-tab" );
-  saveColumnsRowsToStream( ui->resourcesView, stream );
-  stream->writeEndElement();  // resources-tab
+  // capture tasks-gantt display data, returning part to write it to xml stream
+  QString  start         = XDateTime::toString( ui->ganttView->start(), "yyyy-MM-ddThh:mm" );
+  QString  end           = XDateTime::toString( ui->ganttView->end(), "yyyy-MM-ddThh:mm" );
+  QString  minspp        = QString::number( ui->ganttView->minsPP() );
+  QString  splitter      = QString::number( ui->tasksGanttSplitter->sizes().at(0) );
+  QString  upperInterval = ui->ganttView->upperInterval();
+  QString  upperFormat   = ui->ganttView->upperFormat();
+  QString  lowerInterval = ui->ganttView->lowerInterval();
+  QString  lowerFormat   = ui->ganttView->lowerFormat();
+  PlanSnapshot::Part  table = saveColumnsRows( ui->tasksView );
+
+  return [=]( QXmlStreamWriter* stream )
+  {
+    stream->writeStartElement( "tasks-gantt" );
+    stream->writeAttribute( "start", start );
+    stream->writeAttribute( "end", end );
+    stream->writeAttribute( "minspp", minspp );
+    stream->writeAttribute( "nonworking", "TODO" );
+    stream->writeAttribute( "current", "TODO" );
+    stream->writeAttribute( "upper", "TODO" );
+    stream->writeAttribute( "lower", "TODO" );
+    stream->writeAttribute( "splitter", splitter );
+
+    stream->writeStartElement( "upper-scale" );
+    stream->writeAttribute( "interval", upperInterval );
+    stream->writeAttribute( "format", upperFormat );
+    stream->writeEndElement();  // upper-scale
+
+    stream->writeStartElement( "lower-scale" );
+    stream->writeAttribute( "interval", lowerInterval );
+    stream->writeAttribute( "format", lowerFormat );
+    stream->writeEndElement();  // lower-scale
+
+    table( stream );
+    stream->writeEndElement();  // tasks-gantt
+  };
 }
 
-/*********************************** saveCalendarsTabToStream ************************************/
+/******************************************** saveTab ********************************************/
 
-void MainTabWidget::saveCalendarsTabToStream( QXmlStreamWriter* stream )
+PlanSnapshot::Part MainTabWidget::saveTab( QTableView* table, QString element )
 {
-  // write calendars-tab data to xml stream
-  stream->writeStartElement( "calendars-tab" );
-  saveColumnsRowsToStream( ui->calendarsView, stream );
-  stream->writeEndElement();  // calendars-tab
-}
-
-/*********************************** saveDaysTabToStream ************************************/
+  // capture resources, calendars or days tab display data, returning part to write it
+  PlanSnapshot::Part  columnsRows = saveColumnsRows( table );
 
-void MainTabWidget::saveDaysTabToStream( QXmlStreamWriter* stream )
-{
-  // write days-tab data to xml stream
-  stream->writeStartElement( "days-tab" );
-  saveColumnsRowsToStream( ui->daysView, stream );
-  stream->writeEndElement();  // days-tab
+  return [element, columnsRows]( QXmlStreamWriter* stream )
+  {
+    stream->writeStartElement( element );
+    columnsRows( stream );
+    stream->writeEndElement();
+  };
 }
 
-/************************************** columnsRowsToStream **************************************/
+/**************************************** saveColumnsRows ****************************************/
 
-void MainTabWidget::saveColumnsRowsToStream( QTableView* table, QXmlStreamWriter* stream )
+PlanSnapshot::Part MainTabWidget::saveColumnsRows( QTableView* table )
 {
-  // write tableview column position and size to xml stream
-  stream->writeStartElement( "columns" );
+  // capture tableview column positions & sizes and row sizes as plain numbers on gui thread
+  QVector<int>  positions, sizes, rows;
   for( int i = 0 ; i < table->model()->columnCount() ; i++ )
   {
-    stream->writeStartElement( "column" );
-    stream->writeAttribute( "id", QString::number(i) );
-    stream->writeAttribute( "position", QString::number( table->horizontalHeader()->visualIndex(i) ) );
-    stream->writeAttribute( "size", QString::number( table->horizontalHeader()->sectionSize(i) ) );
-    stream->writeEndElement();  // column
+    positions.append( table->horizontalHeader()->visualIndex(i) );
+    sizes.append( table->horizontalHeader()->sectionSize(i) );
   }
-  stream->writeEndElement();  // columns
-
-  // write tableview row size to xml stream
-  stream->writeStartElement( "rows" );
+  rows.reserve( table->model()->rowCount() );
   for( int i = 0 ; i < table->model()->rowCount() ; i++ )
+    rows.append( table->rowHeight(i) );
+
+  return [positions, sizes, rows]( QXmlStreamWriter* stream )
   {
-    stream->writeStartElement( "row" );
-    stream->writeAttribute( "id", QString::number(i) );
-    stream->writeAttribute( "size", QString::number( table->rowHeight(i) ) );
-    stream->writeEndElement();  // row
-  }
-  stream->writeEndElement();  // rows
+    // write tableview column position and size to xml stream
+    stream->writeStartElement( "columns" );
+    for( int i = 0 ; i < positions.size() ; i++ )
+    {
+      stream->writeStartElement( "column" );
+      stream->writeAttribute( "id", QString::number(i) );
+      stream->writeAttribute( "position", QString::number( positions.at(i) ) );
+      stream->writeAttribute( "size", QString::number( sizes.at(i) ) );
+      stream->writeEndElement();  // column
+    }
+    stream->writeEndElement();  // columns
+
+    // write tableview row size to xml stream
+    stream->writeStartElement( "rows" );
+    for( int i = 0 ; i < rows.size() ; i++ )
+    {
+      stream->writeStartElement( "row" );
+      stream->writeAttribute( "id", QString::number(i) );
+      stream->writeAttribute( "size", QString::number( rows.at(i) ) );
+      stream->writeEndElement();  // row
+    }
+    stream->writeEndElement();  // rows
+  };
 }
 
 /************************************** getGanttAttributes ***************************************/
@@ -396,7 +413,7 @@ void MainTabWidget::updatePlan()
        ui->dateTimeFormat->text()                       != plan->datetimeFormat() ||
        ui->notesEdit->toPlainText()                     != plan->notes() )
   {
-    plan->undostack()->push( new CommandPropertiesChange(
+    plan->push( new CommandPropertiesChange(
       ui->title->text(),                   plan->title(),
       XDateTime::datetime( ui->planStart->dateTime() ), plan->start(),
       ui->defaultCalendar->currentIndex(), plan->index( plan->calendar() ),
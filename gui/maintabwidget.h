@@ -29,6 +29,7 @@ class QXmlStreamWriter;
 class QTableView;
 
 #include "model/datetime.h"
+#include "model/plansnapshot.h"
 
 /*************************************************************************************************/
 /***************************** Tabbed widget containing main screens *****************************/
@@ -50,12 +51,10 @@ public:
   int   indexOfTasksTab();           // return index of tasks tab
   void  removePlanTab();             // remove 'Plan' tab
 
-  void  saveToStream( QXmlStreamWriter* );        // write display data to xml stream
-  void  saveTasksGanttToStream( QXmlStreamWriter* );
-  void  saveResourcesTabToStream( QXmlStreamWriter* );
-  void  saveCalendarsTabToStream( QXmlStreamWriter* );
-  void  saveDaysTabToStream( QXmlStreamWriter* );
-  void  saveColumnsRowsToStream( QTableView*, QXmlStreamWriter* );
+  void  saveToSnapshot( PlanSnapshot* );          // capture display data for writing to xml stream
+  PlanSnapshot::Part  saveTasksGantt();
+  PlanSnapshot::Part  saveTab( QTableView*, QString );
+  PlanSnapshot::Part  saveColumnsRows( QTableView* );
 
   void  getGanttAttributes( DateTime&,
                             DateTime&,
@@ -25,6 +25,12 @@
 #include <QCloseEvent>
 #include <QMessageBox>
 #include <QTableView>
+#include <QScrollArea>
+#include <QLabel>
+#include <QTimer>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QCoreApplication>
 
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
@@ -32,6 +38,46 @@
 #include "model/plan.h"
 #include "model/tasksmodel.h"
 #include "model/task.h"
+#include "model/journal.h"
+#include "model/plansnapshot.h"
+#include "model/planloader.h"
+#include "model/plancompress.h"
+#include "ganttrenderer.h"
+#include "ganttexport.h"
+
+/*************************************************************************************************/
+/*********** PlanSave writes a captured plan snapshot to file on a worker thread *****************/
+/*************************************************************************************************/
+
+class PlanSave : public QRunnable
+{
+public:
+  PlanSave( PlanSnapshot* snapshot, const QString& filename, const QString& who,
+            const QDateTime& when, bool autosave, int edits, QObject* window )
+    : m_snapshot( snapshot ), m_filename( filename ), m_who( who ), m_when( when ),
+      m_autosave( autosave ), m_edits( edits ), m_window( window ) {}
+  ~PlanSave() { delete m_snapshot; }
+
+  void run()
+  {
+    // write snapshot to file, then report result to main window back on gui thread
+    bool  ok = m_snapshot->save( m_filename );
+    QMetaObject::invokeMethod( m_window, "slotSaveFinished", Qt::QueuedConnection,
+                               Q_ARG( QString, m_filename ), Q_ARG( QString, m_who ),
+                               Q_ARG( QDateTime, m_when ), Q_ARG( bool, m_autosave ),
+                               Q_ARG( int, m_edits ),
+                               Q_ARG( QString, ok ? QString() : m_snapshot->error() ) );
+  }
+
+private:
+  PlanSnapshot*  m_snapshot;     // plan captured on gui thread
+  QString        m_filename;     // file to write
+  QString        m_who;          // user saving plan
+  QDateTime      m_when;         // when plan captured
+  bool           m_autosave;     // true if autosave snapshot rather than user save
+  int            m_edits;        // plan edit count when plan captured
+  QObject*       m_window;       // main window to report result to
+};
 
 /*************************************************************************************************/
 /********************* Main application window showing tabbed main screens ***********************/
@@ -44,6 +90,11 @@ MainWindow::MainWindow( QWidget* parent ) : QMainWindow( parent ), ui( new Ui::M
   // initialise private variables
   m_undoview = nullptr;
   m_tabs     = new MainTabWidget();
+  m_savePool = new QThreadPool( this );
+  m_savePool->setMaxThreadCount( 1 );     // one worker so saves complete in order
+  m_savesPending = 0;
+  m_autosaving   = false;
+  m_saveOK       = true;
 
   // setup ui for main window including central widget of tabs
   ui->setupUi( this );
@@ -57,6 +108,16 @@ MainWindow::MainWindow( QWidget* parent ) : QMainWindow( parent ), ui( new Ui::M
 
   // update edit menu with undostack undo & redo actions
   setModels();
+
+  // periodically fold journal of edits into autosave snapshot so recovery replays few records
+  m_snapshotTimer = new QTimer( this );
+  connect( m_snapshotTimer, SIGNAL(timeout()), this, SLOT(slotSnapshotPlan()) );
+  m_snapshotTimer->start( SNAPSHOT_MSECS );
+
+  // offer to recover unsaved edits to untitled plan from an ended session, otherwise start journal
+  qint64  session = Journal::orphanedSession();
+  if ( session != 0 ) Journal::adopt( session );
+  if ( !recoverJournal( QString() ) ) startJournal( QString() );
 }
 
 /******************************************* setModels *******************************************/
@@ -70,6 +131,13 @@ void MainWindow::setModels()
   // ensure window title updated to reflect that there are unsaved changes
   connect( plan->undostack(), SIGNAL(cleanChanged(bool)), this, SLOT(slotCleanChanged(bool)) );
 
+  // ensure user told when undo history dropped to keep undo memory within budget
+  connect( plan, SIGNAL(signalUndoDropped()), this, SLOT(slotUndoDropped()), Qt::UniqueConnection );
+
+  // ensure journal folded into snapshot when plan says needed, once current edit has finished
+  connect( plan, SIGNAL(signalSnapshotNeeded()), this, SLOT(slotSnapshotPlan()),
+           Qt::ConnectionType( Qt::QueuedConnection | Qt::UniqueConnection ) );
+
   // set undostack for edit menu undo/redo
   QAction* undoAction = plan->undostack()->createUndoAction( this );
   undoAction->setShortcut( QKeySequence::Undo );
@@ -125,77 +193,154 @@ void MainWindow::message( QString msg )
 
 bool MainWindow::savePlan( QString filename )
 {
-  // save plan to xml file, first open the file and check we can write to it
-  QFile file( filename );
-  if ( !file.open( QIODevice::WriteOnly ) )
-  {
-    message( QString("Failed to write to '%1'").arg(filename) );
-    return false;
-  }
-
   // make sure plan is up to date from 'Plan' tab widgets before saving
   m_tabs->updatePlan();
 
-  // open an xml stream writer and write simulation data
-  QXmlStreamWriter  stream( &file );
-  QString           who  = qgetenv("USERNAME");
-  QDateTime         when = QDateTime::currentDateTime();
-  stream.setAutoFormatting( true );
-  stream.writeStartDocument();
-  stream.writeStartElement( "projectplanner" );
-  stream.writeAttribute( "version", "2014-10" );
-  stream.writeAttribute( "user", who );
-  stream.writeAttribute( "when", when.toString(Qt::ISODate) );
-  plan->saveToStream( &stream );
-  m_tabs->saveToStream( &stream );
-  stream.writeEndDocument();
-
-  // close the file and display useful message
-  file.close();
+  // save plan to xml file in background, plan properties are updated and journal restarted on
+  // the saved file when save finishes, so returns before the outcome is known and callers that
+  // need it must call waitForSave
+  m_savesPending++;
+  plan->markJournal();
+  writePlan( filename, qgetenv("USERNAME"), QDateTime::currentDateTime(), false );
+  message( QString("Saving plan to '%1'").arg(filename) );
+  return true;
+}
+
+/******************************************* writePlan *******************************************/
+
+void MainWindow::writePlan( QString filename, QString who, QDateTime when, bool autosave )
+{
+  // capture plan and display data on gui thread, cheap as only changed tasks are re-formatted
+  PlanSnapshot*      snapshot = new PlanSnapshot();
+  QXmlStreamWriter*  stream   = snapshot->stream();
+  stream->writeStartDocument();
+  stream->writeStartElement( "projectplanner" );
+  stream->writeAttribute( "version", "2014-10" );
+  stream->writeAttribute( "user", who );
+  stream->writeAttribute( "when", when.toString(Qt::ISODate) );
+  plan->saveToSnapshot( snapshot );
+  m_tabs->saveToSnapshot( snapshot );
+
+  // write xml and file on worker thread so editing can continue meanwhile
+  m_savePool->start( new PlanSave( snapshot, filename, who, when, autosave,
+                                   plan->edits(), this ) );
+}
+
+/**************************************** slotSaveFinished ***************************************/
+
+void MainWindow::slotSaveFinished( QString filename, QString who, QDateTime when,
+                                   bool autosave, int edits, QString error )
+{
+  // slot for background save finished, autosave failures are only shown on status bar
+  if ( autosave )
+  {
+    // journal is kept on its old base until snapshot safely written, then restarted on the
+    // snapshot keeping edits made meanwhile, or if undone below capture snapshot taken again,
+    // unless a user save captured since has replaced the mark and will restart the journal
+    m_autosaving = false;
+    if ( !error.isEmpty() ) message( error );
+    else if ( m_savesPending > 0 ) return;
+    else if ( !plan->rebaseJournal( Journal::filename( planFile() ), filename,
+                                    when.toString( Qt::ISODate ) ) ) slotSnapshotPlan();
+    return;
+  }
+
+  m_savesPending--;
+  if ( !error.isEmpty() )
+  {
+    m_saveOK = false;
+    message( error );
+    QMessageBox::warning( this, "Project Planner", error );
+    return;
+  }
   message( QString("Plan saved to '%1'").arg(filename) );
 
-  // update plan properties
+  // edits now saved, update plan properties, any later save still being written has the mark
+  QString  oldFile = planFile();
   plan->setFileInfo( filename, when, who );
-  plan->undostack()->setClean();
+  if ( m_savesPending == 0 )
+  {
+    // restart journal on saved file keeping edits made while it was written, or if undone below
+    // capture start new journal with those edits kept safe in a new snapshot
+    bool  rebased = plan->rebaseJournal( Journal::filename( filename ), filename,
+                                         when.toString( Qt::ISODate ) );
+    if ( oldFile != filename ) Journal::remove( oldFile );
+    if ( rebased ) QFile::remove( Journal::snapshotName( filename ) );
+    else           startJournal( filename );
+
+    // plan is clean unless edited while being saved
+    if ( plan->edits() == edits )
+      plan->setClean();
+    else if ( !rebased )
+      snapshotPlan();
+  }
+
   setTitle( plan->filename() );
   m_tabs->slotUpdatePlanTab();
-  return true;
+}
+
+/****************************************** waitForSave ******************************************/
+
+bool MainWindow::waitForSave()
+{
+  // wait for background saves to finish and handle results, return false if a save failed
+  m_savePool->waitForDone();
+  QCoreApplication::sendPostedEvents( this, QEvent::MetaCall );
+
+  bool  ok = m_saveOK;
+  m_saveOK = true;
+  return ok;
+}
+
+/******************************************** planFile *******************************************/
+
+QString MainWindow::planFile()
+{
+  // return full path of plan file, or empty if plan untitled
+  if ( plan->filename().isEmpty() ) return QString();
+  return plan->fileLocation() + "/" + plan->filename();
 }
 
 /******************************************** loadPlan *******************************************/
 
 bool MainWindow::loadPlan( QString filename )
 {
-  // open the file and check we can read from it
+  // finish any saves of current plan first, then offer to recover unsaved edits from previous
+  // session, otherwise read plan file
+  waitForSave();
+  QString  oldFile   = planFile();
+  bool     recovered = filename != oldFile && recoverJournal( filename );
+  if ( !recovered && !readPlan( filename ) ) return false;
+
+  // previous plan journal no longer needed, and unless recovered start journal on plan file
+  if ( oldFile != filename ) Journal::remove( oldFile );
+  if ( !recovered ) startJournal( filename );
+  return true;
+}
+
+/******************************************** readPlan *******************************************/
+
+bool MainWindow::readPlan( QString filename )
+{
+  // open the file and read it whole, so plan sections can be parsed concurrently
   QFile file( filename );
   if ( !file.open( QIODevice::ReadOnly ) )
   {
     message( QString("Failed to open '%1'").arg(filename) );
     return false;
   }
+  PlanLoader  loader( file.readAll() );
+  file.close();
 
-  // open an xml stream reader and try to load new plan data
-  QXmlStreamReader  stream( &file );
-  Plan*             newPlan = new Plan();
-  Plan*             oldPlan = plan;
+  // try to load new plan data
+  Plan*  newPlan = new Plan();
+  Plan*  oldPlan = plan;
   plan = newPlan;   // set global plan variable so plan methods work as expected
 
-  while ( !stream.atEnd() && !stream.isStartElement() )
-    stream.readNext();
-
-  if ( stream.isStartElement() )
-  {
-    if ( stream.name() == "projectplanner" )
-      newPlan->loadFromStream( &stream, filename );
-    else
-      stream.raiseError( QString("Unrecognised element '%1'").arg(stream.name().toString()) );
-  }
-
   // check if error occured while loading
-  if ( stream.hasError() )
+  if ( !loader.load( filename ) )
   {
-    file.close();
-    message( QString("Failed to load '%1' (%2)").arg(filename).arg(stream.errorString()) );
+    message( QString("Failed to load '%1' (%2)").arg(filename).arg(loader.errorString()) );
     delete newPlan;
     plan = oldPlan;
     return false;
@@ -204,7 +349,6 @@ bool MainWindow::loadPlan( QString filename )
   // check if plan is ok
   if ( !newPlan->isOK() )
   {
-    file.close();
     message( QString("Invalid plan in '%1'").arg(filename) );
     delete newPlan;
     plan = oldPlan;
@@ -214,8 +358,8 @@ bool MainWindow::loadPlan( QString filename )
   // no errors when loading plan, and plan is ok, so delete old plan, set models, load display data
   delete oldPlan;
   setModels();
-  loadDisplayData( &stream );
-  file.close();
+  QXmlStreamReader  display( loader.displayData() );
+  loadDisplayData( &display );
 
   // schedule, set title, update plan tab etc
   plan->schedule();
@@ -225,6 +369,103 @@ bool MainWindow::loadPlan( QString filename )
   return true;
 }
 
+/***************************************** recoverJournal ****************************************/
+
+bool MainWindow::recoverJournal( QString filename )
+{
+  // check for journal of edits left by previous session still matching the file it was based on
+  QString  journalFile = Journal::filename( filename );
+  QString  base, baseWhen;
+  if ( !Journal::readBase( journalFile, base, baseWhen ) ) return false;
+  if ( base != filename && base != Journal::snapshotName( filename ) ) return false;
+  if ( !base.isEmpty() && savedWhen( base ) != baseWhen ) return false;
+
+  // ask user whether to recover the unsaved edits
+  QString  name = filename.isEmpty() ? QString("untitled plan") : QString("'%1'").arg( filename );
+  if ( QMessageBox::question( this, "Project Planner",
+         QString("Unsaved changes to %1 from a previous session were found.\n"
+                 "Do you want to recover them?").arg( name ),
+         QMessageBox::Yes | QMessageBox::No ) != QMessageBox::Yes ) return false;
+
+  // read base (untitled journal with no snapshot is based on new plan) and replay journal onto it
+  if ( !base.isEmpty() && !readPlan( base ) ) return false;
+  plan->setFileInfo( filename, plan->savedWhen(), plan->savedBy() );
+  int  records = Journal::replay( journalFile );
+
+  // fold recovered edits into new snapshot so journal restarts empty
+  snapshotPlan();
+  setTitle( plan->filename() );
+  m_tabs->slotUpdatePlanTab();
+  message( QString("Recovered %1 journalled changes to %2").arg( records ).arg( name ) );
+  return true;
+}
+
+/****************************************** startJournal *****************************************/
+
+void MainWindow::startJournal( QString filename )
+{
+  // remove any old journal & snapshot and start journal of edits to plan file as last saved
+  Journal::remove( filename );
+  plan->startJournal( Journal::filename( filename ), filename,
+                      plan->savedWhen().toString( Qt::ISODate ) );
+}
+
+/***************************************** discardJournal ****************************************/
+
+void MainWindow::discardJournal()
+{
+  // stop journal and remove it with any snapshot, as plan edits have been saved or discarded
+  plan->journal()->stop();
+  Journal::remove( planFile() );
+}
+
+/****************************************** snapshotPlan *****************************************/
+
+void MainWindow::snapshotPlan()
+{
+  // write plan to autosave snapshot, leaving plan file untouched, journal restarts on it when written
+  QString    filename = Journal::snapshotName( planFile() );
+  QDateTime  when     = QDateTime::currentDateTime();
+  m_autosaving = true;
+  plan->markJournal();
+  writePlan( filename, qgetenv("USERNAME"), when, true );
+}
+
+/**************************************** slotSnapshotPlan ***************************************/
+
+void MainWindow::slotSnapshotPlan()
+{
+  // slot for snapshot timer & plan snapshot needed signal, only snapshot if journal has records
+  // and no save or snapshot is being written, as journal restarts when that finishes
+  if ( m_savesPending > 0 || m_autosaving ) return;
+  if ( plan->journal()->isOpen() && plan->journal()->records() > 0 ) snapshotPlan();
+}
+
+/******************************************* savedWhen *******************************************/
+
+QString MainWindow::savedWhen( QString filename )
+{
+  // return 'when' attribute of plan file root element, or empty if not a plan file
+  QFile file( filename );
+  if ( !file.open( QIODevice::ReadOnly ) ) return QString();
+
+  // root element is within first block of a compressed plan, so only that is uncompressed
+  QByteArray  head = file.peek( 4 );
+  QByteArray  xml;
+  if ( PlanCompress::isCompressed( head ) && !PlanCompress::uncompress( file.readAll(), xml, 1 ) )
+    return QString();
+
+  QXmlStreamReader  stream;
+  if ( xml.isEmpty() ) stream.setDevice( &file );
+  else                 stream.addData( xml );
+  while ( !stream.atEnd() && !stream.isStartElement() )
+    stream.readNext();
+
+  if ( stream.isStartElement() && stream.name() == "projectplanner" )
+    return stream.attributes().value( "when" ).toString();
+  return QString();
+}
+
 /**************************************** loadDisplayData ****************************************/
 
 void MainWindow::loadDisplayData( QXmlStreamReader* stream )
@@ -383,7 +624,7 @@ void MainWindow::setTitle( QString text )
   else
   {
     // add asterisk to filename to indicate if unsaved changes
-    if ( !plan->undostack()->isClean() ) text += "*";
+    if ( !plan->isClean() ) text += "*";
     setWindowTitle( text + " - ProjectPlanner");
   }
 
@@ -456,9 +697,10 @@ void MainWindow::slotFileNew()
 {
   // slot for file new plan action, check whether plan needs update
   m_tabs->updatePlan();
+  waitForSave();
 
   // if undostack state is not 'clean' ask user what to do
-  if ( !plan->undostack()->isClean() )
+  if ( !plan->isClean() )
   {
     bool check = true;
     while ( check )
@@ -468,7 +710,7 @@ void MainWindow::slotFileNew()
       {
         case QMessageBox::Save:
           // if save not successful ask again
-          if ( !slotFileSaveAs() ) break;
+          if ( !slotFileSaveAs() || !waitForSave() ) break;
 
         case QMessageBox::Discard:
           check = false;
@@ -479,11 +721,13 @@ void MainWindow::slotFileNew()
       }
   }
 
-  // delete old plan, and generate new default plan
+  // discard old plan journal, delete old plan, and generate new default plan with new journal
+  discardJournal();
   delete plan;
   plan = new Plan();
   plan->initialise();
   setModels();
+  startJournal( QString() );
   plan->schedule();
   message( "New plan started" );
   setTitle( plan->filename() );
@@ -504,9 +748,10 @@ bool MainWindow::slotFileOpen()
 {
   // slot for file open plan action
   m_tabs->endEdits();
+  waitForSave();
 
   // if undostack state is not 'clean' ask user what to do
-  if ( !plan->undostack()->isClean() )
+  if ( !plan->isClean() )
   {
     bool check = true;
     while ( check )
@@ -516,7 +761,7 @@ bool MainWindow::slotFileOpen()
       {
         case QMessageBox::Save:
           // if save not successful ask again
-          if ( !slotFileSaveAs() ) break;
+          if ( !slotFileSaveAs() || !waitForSave() ) break;
 
         case QMessageBox::Discard:
           check = false;
@@ -529,7 +774,7 @@ bool MainWindow::slotFileOpen()
 
   // get user to select filename and location
   QString filename = QFileDialog::getOpenFileName( this, "Open Plan", plan->fileLocation(),
-                                                   "Plans (*.xml)" );
+                                                   "Plans (*.xml *.xmlz)" );
   if ( filename.isEmpty() )
   {
     message();
@@ -560,7 +805,7 @@ bool MainWindow::slotFileSaveAs()
   // QString filename = QFileDialog::getSaveFileName();
   QString filename = QFileDialog::getSaveFileName( this, "Save Plan As",
                                                    plan->fileLocation() + "/" + plan->filename(),
-                                                   "Plans (*.xml)" );
+                                                   "Plans (*.xml);;Compressed plans (*.xmlz)" );
   if ( !filename.isEmpty() ) return savePlan( filename );
 
   // user cancelled
@@ -572,18 +817,50 @@ bool MainWindow::slotFileSaveAs()
 
 void MainWindow::slotFilePrint()
 {
-  // slot for print action
+  // slot for print action - export task table & gantt as shown to paged pdf or png
   m_tabs->endEdits();
-  qDebug("MainWindow::slotFilePrint() - TODO !!!!");
+  QString filename = QFileDialog::getSaveFileName( this, "Export Gantt", plan->fileLocation(),
+                                                   "PDF (*.pdf);;PNG images (*.png)" );
+  if ( filename.isEmpty() )
+  {
+    message();
+    return;
+  }
+
+  DateTime  start, end;
+  double    mpp;
+  m_tabs->getGanttAttributes( start, end, mpp );
+  GanttRenderer  renderer( start, end, mpp );
+  renderer.prepare( font() );
+
+  GanttExport  exporter( &renderer );
+  bool  ok = filename.endsWith( ".png", Qt::CaseInsensitive ) ? exporter.toPng( filename )
+                                                             : exporter.toPdf( filename );
+  if ( ok ) message( QString("Exported gantt to '%1'").arg( filename ) );
+  else      message( exporter.error() );
 }
 
 /************************************** slotFilePrintPreview *************************************/
 
 void MainWindow::slotFilePrintPreview()
 {
-  // slot for print preview plan action
+  // slot for print preview plan action - show first export page in its own window
   m_tabs->endEdits();
-  qDebug("MainWindow::slotFilePrintPreview() - TODO !!!!");
+  DateTime  start, end;
+  double    mpp;
+  m_tabs->getGanttAttributes( start, end, mpp );
+  GanttRenderer  renderer( start, end, mpp );
+  renderer.prepare( font() );
+
+  QLabel*  label = new QLabel();
+  label->setPixmap( QPixmap::fromImage( GanttExport( &renderer ).page(
+                      QSize( GanttExport::PNG_PAGE, GanttExport::PNG_PAGE ), 0 ) ) );
+  QScrollArea*  preview = new QScrollArea();
+  preview->setAttribute( Qt::WA_DeleteOnClose );
+  preview->setWindowTitle( "Print Preview" );
+  preview->setWidget( label );
+  preview->resize( 800, 600 );
+  preview->show();
 }
 
 /************************************ slotAboutProjectPlanner ************************************/
@@ -682,6 +959,15 @@ void MainWindow::slotCleanChanged( bool )
   setTitle( plan->filename() );
 }
 
+/***************************************** slotUndoDropped ***************************************/
+
+void MainWindow::slotUndoDropped()
+{
+  // tell user undo history was cleared, plan still has unsaved changes
+  message( "Undo history cleared to keep within memory limit" );
+  setTitle( plan->filename() );
+}
+
 /***************************************** slotTabChange *****************************************/
 
 void MainWindow::slotTabChange( int index )
@@ -720,12 +1006,14 @@ void MainWindow::changeEvent( QEvent* event )
 
 void  MainWindow::closeEvent( QCloseEvent* event )
 {
-  // check whether plan needs update
+  // check whether plan needs update, and let any saves finish
   m_tabs->updatePlan();
+  waitForSave();
 
   // if undostack state is 'clean' then accept close event
-  if ( plan->undostack()->isClean() )
+  if ( plan->isClean() )
   {
+    discardJournal();
     event->accept();
     return;
   }
@@ -737,10 +1025,11 @@ void  MainWindow::closeEvent( QCloseEvent* event )
         QMessageBox::Save | QMessageBox::Discard | QMessageBox::Cancel ) )
     {
       case QMessageBox::Save:
-        // if save not successful ask again
-        if ( !slotFileSaveAs() ) break;
+        // if save not successful ask again, only discard journal once plan is safely written
+        if ( !slotFileSaveAs() || !waitForSave() ) break;
 
       case QMessageBox::Discard:
+        discardJournal();
         event->accept();
         return;
 
@@ -29,6 +29,8 @@ class QItemSelection;
 class MainTabWidget;
 class QXmlStreamReader;
 class QTableView;
+class QTimer;
+class QThreadPool;
 
 /*************************************************************************************************/
 /********************* Main application window showing tabbed main screens ***********************/
@@ -45,8 +47,17 @@ public:
   void setModels();                            // set models for views & undostack
   void message( QString = "" );                // show message on status bar and enure is top & active
   void setTitle( QString = "" );               // update main window title to include text
-  bool savePlan( QString );                    // save plan to xml file
-  bool loadPlan( QString );                    // load plan from xml file
+  bool savePlan( QString );                    // start saving plan to xml file, see waitForSave for outcome
+  void writePlan( QString, QString, QDateTime, bool );  // capture plan & display data, write file in background
+  bool waitForSave();                          // wait for background saves, false if any failed
+  bool loadPlan( QString );                    // load plan from xml file, offering to recover unsaved edits
+  bool readPlan( QString );                    // read plan from xml file replacing current plan
+  QString planFile();                          // return full path of plan file, or empty if untitled
+  bool recoverJournal( QString );              // offer to recover journalled edits, true if recovered
+  void startJournal( QString );                // start journal of edits to plan file as last saved
+  void discardJournal();                       // stop & remove journal as edits saved or discarded
+  void snapshotPlan();                         // write autosave snapshot, journal restarts on it once written
+  static QString savedWhen( QString );         // return when plan file was saved, or empty
   void loadDisplayData( QXmlStreamReader* );   // load display data from xml stream
   void loadTableColumnsRows( QList<QTableView*>, QXmlStreamReader*, QString );
 
@@ -59,12 +70,16 @@ public slots:
   void slotUndoStackView( bool );              // slot for actionUndoStackView triggered signal
   void slotUndoStackViewDestroyed();           // slot for undo stack view destroyed signal
   void slotCleanChanged( bool );               // slot for undostack clean state change
+  void slotUndoDropped();                      // slot for plan undo history dropped
   void slotTabChange( int );                   // slot for mainTabWidget current changed signal
   void slotSchedulePlan();                     // slot for schedule plan action
   void slotIndent();                           // slot for indent task(s) action
   void slotOutdent();                          // slot for outdent task(s) action
   void slotStretchTasks( bool );               // slot for stretch tasks action
   void slotNewWindow();                        // slot for new window action
+  void slotSnapshotPlan();                     // slot to fold journal into autosave snapshot if needed
+  void slotSaveFinished( QString, QString, QDateTime,
+                         bool, int, QString );  // slot for background save finished
 
   void slotFileNew();                          // slot for file new plan action
   bool slotFileOpen();                         // slot for file open plan action
@@ -88,6 +103,13 @@ private:
   QUndoView*              m_undoview;          // window to display contents of undostack
   MainTabWidget*          m_tabs;              // tabs for mainwindow central widget
   QList<QPointer<MainTabWidget>>  m_windows;   // list of other tabWidgets
+  QTimer*                 m_snapshotTimer;     // timer to periodically fold journal into snapshot
+  QThreadPool*            m_savePool;          // single worker writing plan files in background
+  int                     m_savesPending;      // number of user saves not yet finished
+  bool                    m_saveOK;            // false if a user save failed since last waited for
+  bool                    m_autosaving;        // true while autosave snapshot being written
+
+  static const int  SNAPSHOT_MSECS = 60000;    // interval between autosave snapshots if edits journalled
 };
 
 #endif // MAINWINDOW_H
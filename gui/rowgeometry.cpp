@@ -0,0 +1,140 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "rowgeometry.h"
+
+#include <QHeaderView>
+
+#include <algorithm>
+
+/*************************************************************************************************/
+/******************* RowGeometry caches table row positions for the gantt chart ******************/
+/*************************************************************************************************/
+
+/****************************************** constructor ******************************************/
+
+RowGeometry::RowGeometry()
+{
+  // initialise private variables
+  m_header = nullptr;
+  m_valid  = false;
+  m_hidden = 0;
+}
+
+/******************************************* setHeader *******************************************/
+
+void RowGeometry::setHeader( QHeaderView* header )
+{
+  // set vertical header and mark cache for rebuild
+  m_header = header;
+  m_valid  = false;
+}
+
+/******************************************** rebuild ********************************************/
+
+void RowGeometry::rebuild()
+{
+  // prefix sums of row heights in visual order, hidden rows having zero height
+  int count = m_header ? m_header->count() : 0;
+  m_top.resize( count + 1 );
+  m_visual.resize( count );
+  m_logical.resize( count );
+
+  m_top[0] = 0;
+  for( int visual=0 ; visual<count ; visual++ )
+  {
+    int row = m_header->logicalIndex( visual );
+    m_logical[visual] = row;
+    m_visual[row]     = visual;
+    m_top[visual+1]   = m_top[visual] +
+                        ( m_header->isSectionHidden( row ) ? 0 : m_header->sectionSize( row ) );
+  }
+
+  m_hidden = m_header ? m_header->hiddenSectionCount() : 0;
+  m_valid  = true;
+}
+
+/********************************************* count *********************************************/
+
+int RowGeometry::count()
+{
+  // return number of rows, rebuilding cache if header row count or rows hidden have changed
+  if ( !m_valid || ( m_header && ( m_header->count() != m_logical.size() ||
+                                   m_header->hiddenSectionCount() != m_hidden ) ) ) rebuild();
+  return m_logical.size();
+}
+
+/******************************************** logical ********************************************/
+
+int RowGeometry::logical( int visual )
+{
+  // return logical row at visual position
+  if ( visual < 0 || visual >= count() ) return -1;
+  return m_logical.at( visual );
+}
+
+/******************************************** visual *********************************************/
+
+int RowGeometry::visual( int row )
+{
+  // return visual position of logical row
+  if ( row < 0 || row >= count() ) return -1;
+  return m_visual.at( row );
+}
+
+/******************************************* visualAt ********************************************/
+
+int RowGeometry::visualAt( int y )
+{
+  // return visual position at viewport y, or -1 if none
+  if ( count() == 0 ) return -1;
+  int pos = y + m_header->offset();
+  if ( pos < 0 || pos >= m_top.last() ) return -1;
+
+  // last row with top at or before position (hidden rows share top with next so are skipped)
+  return int( std::upper_bound( m_top.constBegin(), m_top.constEnd(), pos ) - m_top.constBegin() ) - 1;
+}
+
+/********************************************* rowAt *********************************************/
+
+int RowGeometry::rowAt( int y )
+{
+  // return logical row at viewport y, or -1 if none
+  return logical( visualAt( y ) );
+}
+
+/*********************************************** y ***********************************************/
+
+int RowGeometry::y( int row )
+{
+  // return viewport y of logical row top
+  if ( row < 0 || row >= count() ) return -1;
+  return m_top.at( m_visual.at( row ) ) - m_header->offset();
+}
+
+/******************************************** height *********************************************/
+
+int RowGeometry::height( int row )
+{
+  // return height of logical row, zero if hidden
+  if ( row < 0 || row >= count() ) return 0;
+  int visual = m_visual.at( row );
+  return m_top.at( visual + 1 ) - m_top.at( visual );
+}
@@ -0,0 +1,61 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef ROWGEOMETRY_H
+#define ROWGEOMETRY_H
+
+class QHeaderView;
+
+#include <QVector>
+
+/*************************************************************************************************/
+/******************* RowGeometry caches table row positions for the gantt chart ******************/
+/*************************************************************************************************/
+
+class RowGeometry
+{
+public:
+  RowGeometry();                                   // constructor
+
+  void  setHeader( QHeaderView* );                 // set vertical header providing row sizes
+  void  invalidate() { m_valid = false; }          // mark cache as needing rebuild
+
+  int   count();                                   // return number of rows
+  int   logical( int visual );                     // return logical row at visual position
+  int   visual( int row );                         // return visual position of logical row
+  int   visualAt( int y );                         // return visual position at viewport y, or -1
+  int   rowAt( int y );                            // return logical row at viewport y, or -1
+  int   y( int row );                              // return viewport y of logical row top
+  int   height( int row );                         // return height of logical row, zero if hidden
+  int   centre( int row )
+    { return y( row ) + height( row ) / 2; }       // return viewport y of logical row centre
+
+private:
+  void  rebuild();                                 // rebuild cache from vertical header
+
+  QHeaderView*   m_header;        // vertical header providing row sizes
+  bool           m_valid;         // true if cache matches header
+  int            m_hidden;        // number of hidden rows when cache built
+  QVector<int>   m_top;           // top of each visual row, plus total height at end
+  QVector<int>   m_visual;        // visual position of each logical row
+  QVector<int>   m_logical;       // logical row at each visual position
+};
+
+#endif // ROWGEOMETRY_H
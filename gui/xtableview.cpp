@@ -19,8 +19,14 @@
  ***************************************************************************/
 
 #include "xtableview.h"
+#include "model/tasksmodel.h"
+#include "model/plan.h"
 
 #include <QHeaderView>
+#include <QKeyEvent>
+#include <QApplication>
+#include <QClipboard>
+#include <QMessageBox>
 
 /*************************************************************************************************/
 /*************************** XTableView provides an enhanced QTableView **************************/
@@ -77,3 +83,66 @@ void  XTableView::endEdit()
   QModelIndex index = currentIndex();
   currentChanged( index, index );
 }
+
+/***************************************** keyPressEvent *****************************************/
+
+void  XTableView::keyPressEvent( QKeyEvent* event )
+{
+  // if paste key sequence, paste clipboard text otherwise handle as normal
+  if ( event->matches( QKeySequence::Paste ) )
+  {
+    paste();
+    return;
+  }
+
+  QTableView::keyPressEvent( event );
+}
+
+/********************************************* paste *********************************************/
+
+void  XTableView::paste()
+{
+  // only tasks model currently supports block paste
+  TasksModel*  tasks = dynamic_cast<TasksModel*>( model() );
+  if ( tasks == nullptr ) return;
+
+  // paste at top-left of selection, or current cell if nothing selected
+  QModelIndexList  selected = selectionModel()->selectedIndexes();
+  if ( selected.isEmpty() ) selected.append( currentIndex() );
+  int  top  = selected.first().row(),    bottom = top;
+  int  left = selected.first().column(), right  = left;
+  foreach( const QModelIndex& index, selected )
+  {
+    top    = qMin( top,    index.row() );
+    bottom = qMax( bottom, index.row() );
+    left   = qMin( left,   index.column() );
+    right  = qMax( right,  index.column() );
+  }
+  if ( top < 0 || left < 0 ) return;
+
+  // if clipboard has a single value, fill each selected cell with it, leaving unselected cells
+  // within a non-contiguous selection empty so they are unchanged
+  QList<QStringList>  lines = TasksModel::parseText( QApplication::clipboard()->text() );
+  if ( lines.size() == 2 && lines.last().join( QString() ).isEmpty() ) lines.removeLast();
+  if ( lines.size() == 1 && lines.first().size() == 1 )
+  {
+    QString  value = lines.first().first();
+    lines.clear();
+    for( int r = top ; r <= bottom ; r++ )
+    {
+      QStringList  line;
+      for( int c = left ; c <= right ; c++ ) line << QString();
+      lines << line;
+    }
+    foreach( const QModelIndex& index, selected )
+      lines[ index.row() - top ][ index.column() - left ] = value;
+  }
+
+  // finish any edit in progress, then paste as one batch reporting any validation failures
+  endEdit();
+  plan->beginBatch( "Paste" );
+  QString  error = tasks->paste( top, left, lines );
+  plan->endBatch();
+  if ( !error.isEmpty() )
+    QMessageBox::warning( this, "Project Planner", error );
+}
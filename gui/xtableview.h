@@ -34,6 +34,10 @@ public:
 
   void             endEdit();                        // cancel any ongoing edit in table
   void             setHeaderHeight( int );           // set horizontal header height
+  void             paste();                          // paste clipboard text, or fill selection if single value
+
+protected:
+  void             keyPressEvent( QKeyEvent* );      // reimplement to support paste key sequence
 };
 
 #endif // XTABLEVIEW_H
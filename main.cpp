@@ -20,8 +20,15 @@
 
 #include "gui/mainwindow.h"
 #include "model/plan.h"
+#include "model/planloader.h"
+
+#include "gui/ganttrenderer.h"
+#include "gui/ganttexport.h"
 
 #include <QApplication>
+#include <QGuiApplication>
+#include <QFile>
+#include <QTextStream>
 
 /*************************************************************************************************/
 // ProjectPlanner by Richard Crook
@@ -36,8 +43,64 @@
 
 Plan*        plan;    // global variable
 
+/****************************************** exportPlan *******************************************/
+
+static int exportPlan( QString planFile, QString outFile, double mpp )
+{
+  // load plan without any windows, schedule, and export gantt to pdf or png
+  QTextStream  err( stderr );
+  QFile        file( planFile );
+  if ( !file.open( QIODevice::ReadOnly ) )
+  {
+    err << QString("Failed to open '%1'\n").arg( planFile );
+    return 1;
+  }
+
+  PlanLoader  loader( file.readAll() );
+  if ( !loader.load( planFile ) || !plan->isOK() )
+  {
+    err << QString("Failed to load '%1' (%2)\n").arg( planFile ).arg( loader.errorString() );
+    return 1;
+  }
+  plan->schedule();
+
+  // report plan size and pool use, so headless export runs double as load benchmarks
+  err << QString("Loaded %1 tasks, %2 resources, %3 objects created from %4 pool blocks\n")
+           .arg( plan->numTasks() ).arg( plan->numResources() )
+           .arg( plan->created() ).arg( plan->blocks() );
+
+  // gantt spans plan with a week either side
+  DateTime  start = plan->beginning();
+  DateTime  end   = plan->end();
+  if ( start == XDateTime::NULL_DATETIME || end == XDateTime::NULL_DATETIME ) start = end = plan->start();
+  start = start > 7u*1440u ? start - 7u*1440u : 0u;
+  end   = end + 7u*1440u;
+
+  GanttRenderer  renderer( start, end, mpp );
+  renderer.prepare( QGuiApplication::font() );
+  GanttExport    exporter( &renderer );
+  bool  ok = outFile.endsWith( ".png", Qt::CaseInsensitive ) ? exporter.toPng( outFile )
+                                                            : exporter.toPdf( outFile );
+  if ( ok ) return 0;
+
+  err << exporter.error() << "\n";
+  return 1;
+}
+
+/********************************************* main **********************************************/
+
 int main( int argc, char* argv[] )
 {
+  // "-export plan.xml out.pdf|out.png [minsPerPixel]" exports gantt without needing a display
+  if ( argc >= 4 && QString( argv[1] ) == "-export" )
+  {
+    if ( qgetenv( "QT_QPA_PLATFORM" ).isEmpty() ) qputenv( "QT_QPA_PLATFORM", "offscreen" );
+    QGuiApplication  app( argc, argv );
+    plan = new Plan();
+    double  mpp = argc >= 5 ? QString( argv[4] ).toDouble() : 0.0;
+    return exportPlan( argv[2], argv[3], mpp > 0.0 ? mpp : 240.0 );
+  }
+
   // control and provides info to all Qt applications
   QApplication app( argc, argv );
 
@@ -21,6 +21,8 @@
 #include <QXmlStreamWriter>
 #include <QXmlStreamReader>
 
+#include <algorithm>
+
 #include "plan.h"
 #include "calendarsmodel.h"
 #include "daysmodel.h"
@@ -36,16 +38,26 @@
 Calendar::Calendar()
 {
   // create null calendar
-  m_name        = "Null";
+  m_name        = XTag::tag( "Null" );
   m_cycleAnchor = XDate::date(2000,1,1);   // Saturday 1st Jan 2000
   m_cycleLength = 0;
   m_normal.resize( m_cycleLength );
+
+  // no non-working runs cached yet
+  m_runsVersion = 0;
+  m_runsFirst   = 1;
+  m_runsLast    = 0;
 }
 
 /****************************************** constructor ******************************************/
 
 Calendar::Calendar( int type )
 {
+  // no non-working runs cached yet
+  m_runsVersion = 0;
+  m_runsFirst   = 1;
+  m_runsLast    = 0;
+
   Day* working    = plan->day( Day::DEFAULT_STANDARDWORK );
   Day* nonWorking = plan->day( Day::DEFAULT_NONWORK );
 
@@ -53,7 +65,7 @@ Calendar::Calendar( int type )
   if ( type == DEFAULT_CALENDAR )
   {
     // create default base calendar
-    m_name        = "Standard";
+    m_name        = XTag::tag( "Standard" );
     m_cycleAnchor = XDate::date(2000,1,1);   // Saturday 1st Jan 2000
     m_cycleLength = 7;                       // 7 day week
     m_normal.resize( m_cycleLength );
@@ -67,22 +79,22 @@ Calendar::Calendar( int type )
     }
 
     // add easter and some bank holidays
-    m_exceptions[ XDate::date(2014,12,25) ] = nonWorking;
-    m_exceptions[ XDate::date(2014,12,26) ] = nonWorking;
-
-    m_exceptions[ XDate::date(2015, 1, 1) ] = nonWorking;
-    m_exceptions[ XDate::date(2015, 4, 3) ] = nonWorking;
-    m_exceptions[ XDate::date(2015, 4, 6) ] = nonWorking;
-    m_exceptions[ XDate::date(2015, 5, 4) ] = nonWorking;
-    m_exceptions[ XDate::date(2015, 5,25) ] = nonWorking;
-    m_exceptions[ XDate::date(2015, 8,31) ] = nonWorking;
-    m_exceptions[ XDate::date(2015,12,25) ] = nonWorking;
-    m_exceptions[ XDate::date(2015,12,28) ] = nonWorking;
+    setException( XDate::date(2014,12,25), nonWorking );
+    setException( XDate::date(2014,12,26), nonWorking );
+
+    setException( XDate::date(2015, 1, 1), nonWorking );
+    setException( XDate::date(2015, 4, 3), nonWorking );
+    setException( XDate::date(2015, 4, 6), nonWorking );
+    setException( XDate::date(2015, 5, 4), nonWorking );
+    setException( XDate::date(2015, 5,25), nonWorking );
+    setException( XDate::date(2015, 8,31), nonWorking );
+    setException( XDate::date(2015,12,25), nonWorking );
+    setException( XDate::date(2015,12,28), nonWorking );
   }
   else if ( type == DEFAULT_FANCY )
   {
     // create fancy calendar
-    m_name        = "Fancy";
+    m_name        = XTag::tag( "Fancy" );
     m_cycleAnchor = XDate::date(2012,1,1);
     m_cycleLength = 10;                 // 10 day cycle
     m_normal.resize( m_cycleLength );
@@ -98,13 +110,13 @@ Calendar::Calendar( int type )
     m_normal[8] = nonWorking;
     m_normal[9] = plan->day( Day::DEFAULT_TWENTYFOURHOURS );
 
-    m_exceptions[ XDate::date(2014,12,25) ] = nonWorking;
-    m_exceptions[ XDate::date(2014,12,26) ] = nonWorking;
+    setException( XDate::date(2014,12,25), nonWorking );
+    setException( XDate::date(2014,12,26), nonWorking );
   }
   else  // DEFAULT_FULLTIME
   {
     // create fulltime calendar
-    m_name        = "Full Time";
+    m_name        = XTag::tag( "Full Time" );
     m_cycleAnchor = XDate::date(2012,1,1);
     m_cycleLength = 1;                 // same day every day
     m_normal.resize( m_cycleLength );
@@ -121,10 +133,10 @@ Calendar::Calendar( QXmlStreamReader* stream ) : Calendar()
   foreach( QXmlStreamAttribute attribute, stream->attributes() )
   {
     if ( attribute.name() == "name" )
-      m_name = attribute.value().toString();
+      m_name = XTag::tag( attribute.value().toString() );
 
     if ( attribute.name() == "anchor" )
-      m_cycleAnchor = XDate::fromString( attribute.value().toString() );
+      m_cycleAnchor = XDate::fromString( attribute.value() );
   }
 
   while ( !stream->atEnd() )
@@ -137,7 +149,7 @@ Calendar::Calendar( QXmlStreamReader* stream ) : Calendar()
       {
         if ( attribute.name() == "day" )
         {
-          int dayId = attribute.value().toString().toInt();
+          int dayId = attribute.value().toInt();
           if ( dayId >= plan->numDays() || dayId < 0 )
           {
             stream->raiseError( QString("Calendar invalid normal day '%1'").arg(dayId) );
@@ -157,11 +169,11 @@ Calendar::Calendar( QXmlStreamReader* stream ) : Calendar()
       foreach( QXmlStreamAttribute attribute, stream->attributes() )
       {
         if ( attribute.name() == "date" )
-          date = XDate::fromString( attribute.value().toString() );
+          date = XDate::fromString( attribute.value() );
 
         if ( attribute.name() == "day" )
         {
-          int dayId = attribute.value().toString().toInt();
+          int dayId = attribute.value().toInt();
           if ( dayId >= plan->numDays() || dayId < 0 )
           {
             stream->raiseError( QString("Calendar invalid exception day '%1'").arg(dayId) );
@@ -171,7 +183,7 @@ Calendar::Calendar( QXmlStreamReader* stream ) : Calendar()
           day = plan->day( dayId );
         }
       }
-      m_exceptions[ date ] = day;
+      setException( date, day );
     }
 
     // when reached end of calendar return
@@ -184,7 +196,7 @@ Calendar::Calendar( QXmlStreamReader* stream ) : Calendar()
 void  Calendar::saveToStream( QXmlStreamWriter* stream )
 {
   // write calendar data to xml stream
-  stream->writeAttribute( "name", m_name );
+  stream->writeAttribute( "name", XTag::string( m_name ) );
   stream->writeAttribute( "anchor", XDate::toString( m_cycleAnchor, "yyyy-MM-dd" ) );
 
   for( int n=0 ; n<m_cycleLength ; n++ )
@@ -194,13 +206,11 @@ void  Calendar::saveToStream( QXmlStreamWriter* stream )
     stream->writeAttribute( "day", QString("%1").arg(plan->index(m_normal[n])) );
   }
 
-  QHashIterator<Date, Day*> e( m_exceptions );
-  while ( e.hasNext() )
+  foreach( const Exception& e, m_exceptions )
   {
-      e.next();
       stream->writeEmptyElement( "exception" );
-      stream->writeAttribute( "date", XDate::toString( e.key(), "yyyy-MM-dd" ) );
-      stream->writeAttribute( "day", QString("%1").arg(plan->index(e.value())) );
+      stream->writeAttribute( "date", XDate::toString( e.date, "yyyy-MM-dd" ) );
+      stream->writeAttribute( "day", QString("%1").arg(plan->index(e.day)) );
   }
 }
 
@@ -219,7 +229,7 @@ QVariant  Calendar::data( int row, int role  = Qt::DisplayRole ) const
   // if role is DisplayRole, return appropriate display value
   if ( role == Qt::DisplayRole )
   {
-    if ( row == SECTION_NAME )        return m_name;
+    if ( row == SECTION_NAME )        return XTag::string( m_name );
     if ( row == SECTION_ANCHOR )      return XDate::qdate( m_cycleAnchor );
     if ( row == SECTION_EXCEPTIONS )  return m_exceptions.size();
     if ( row == SECTION_CYCLELENGTH ) return m_cycleLength;
@@ -265,8 +275,9 @@ QVariant  Calendar::data( int row, int role  = Qt::DisplayRole ) const
 
 void Calendar::setData( int row, const QVariant& value )
 {
-  // set calendar data based on row
-  if ( row == SECTION_NAME ) m_name = value.toString();
+  // set calendar data based on row, any combined calendars are now out of date
+  plan->calendars()->combiner().invalidate();
+  if ( row == SECTION_NAME ) m_name = XTag::tag( value.toString() );
 
   if ( row == SECTION_ANCHOR ) m_cycleAnchor = XDate::date( value.toDate() );
 
@@ -323,14 +334,138 @@ QVariant Calendar::headerData( int section )
 Day*  Calendar::day( Date date ) const
 {
   // if exception exists return it, otherwise return normal cycle day
-  if ( m_exceptions.contains( date ) ) return m_exceptions.value( date );
+  int e = findException( date );
+  if ( e < m_exceptions.size() && m_exceptions.at(e).date == date ) return m_exceptions.at(e).day;
+
+  return normal( date );
+}
+
+/********************************************** day **********************************************/
 
+Day*  Calendar::day( Date date, int& cursor ) const
+{
+  // return day type for given date, cursor tracks first exception on or after date so that
+  // walking forward or backward a day at a time needs no searching (negative cursor to start)
+  int size = m_exceptions.size();
+  if ( cursor < 0 || cursor > size ) cursor = findException( date );
+  while ( cursor < size && m_exceptions.at(cursor).date < date ) cursor++;
+  while ( cursor > 0 && m_exceptions.at(cursor-1).date >= date ) cursor--;
+
+  if ( cursor < size && m_exceptions.at(cursor).date == date ) return m_exceptions.at(cursor).day;
+  return normal( date );
+}
+
+/********************************************* normal ********************************************/
+
+Day*  Calendar::normal( Date date ) const
+{
+  // return normal cycle day for given date
   int normal = ( date - m_cycleAnchor ) % m_cycleLength;
   if ( normal < 0 ) normal += m_cycleLength;
 
   return m_normal.at( normal );
 }
 
+/***************************************** findException *****************************************/
+
+int  Calendar::findException( Date date ) const
+{
+  // return index of first exception on or after date (binary search of sorted exceptions)
+  const Exception*  begin = m_exceptions.constData();
+  const Exception*  end   = begin + m_exceptions.size();
+  return int( std::lower_bound( begin, end, date,
+                [] ( const Exception& e, Date d ) { return e.date < d; } ) - begin );
+}
+
+/***************************************** setException ******************************************/
+
+void  Calendar::setException( Date date, Day* day )
+{
+  // exceptions are usually added in date order, so check end first
+  if ( m_exceptions.isEmpty() || m_exceptions.last().date < date )
+  {
+    m_exceptions.append( { date, day } );
+    return;
+  }
+
+  // otherwise replace existing or insert keeping exceptions sorted by date
+  int e = findException( date );
+  if ( m_exceptions.at(e).date == date )
+    m_exceptions[e].day = day;
+  else
+    m_exceptions.insert( e, { date, day } );
+}
+
+/**************************************** shareExceptions ****************************************/
+
+bool  Calendar::shareExceptions( const Calendar* other )
+{
+  // if other calendar has identical exceptions, share its storage so only stored once
+  if ( other == this || m_exceptions != other->m_exceptions ) return false;
+  m_exceptions = other->m_exceptions;
+  return true;
+}
+
+/****************************************** nonWorking *******************************************/
+
+QVector<Calendar::Run> Calendar::nonWorking( Date first, Date last )
+{
+  // recache if calendars edited or dates not covered, extending to cover previous dates too
+  quint32  version = plan->calendars()->combiner().version();
+  if ( version != m_runsVersion || m_runsFirst > m_runsLast )
+    cacheRuns( first, last );
+  else if ( first < m_runsFirst || last > m_runsLast )
+    cacheRuns( qMin( first, m_runsFirst ), qMax( last, m_runsLast ) );
+  m_runsVersion = version;
+
+  // return runs overlapping the dates, first found by binary search on run end
+  QVector<Run>  runs;
+  auto it = std::upper_bound( m_runs.constBegin(), m_runs.constEnd(), first,
+                              []( Date date, const Run& run ) { return date < run.end; } );
+  for( ; it != m_runs.constEnd() && it->start <= last ; ++it ) runs.append( *it );
+
+  return runs;
+}
+
+/******************************************* cacheRuns *******************************************/
+
+void Calendar::cacheRuns( Date first, Date last )
+{
+  // cache non-working runs covering dates, with a year either side to absorb scrolling
+  first = qMax( first - 366, XDate::MIN_DATE );
+  last  = qMin( last + 366, XDate::MAX_DATE );
+  m_runs.clear();
+
+  int   cursor = -1;
+  Run   run;
+  bool  inRun = false;
+  for( Date date = first ; date <= last ; date++ )
+  {
+    bool working = day( date, cursor )->isWorking();
+    if ( !working && !inRun )
+    {
+      run.start = date;
+      inRun     = true;
+    }
+    if ( working && inRun )
+    {
+      run.end = date;
+      m_runs.append( run );
+      inRun   = false;
+    }
+  }
+
+  // run still open at end of covered dates extends to just beyond them
+  if ( inRun )
+  {
+    run.end = last + 1;
+    m_runs.append( run );
+  }
+
+  m_runsFirst = first;
+  m_runsLast  = last;
+}
+
 /****************************************** isWorking ********************************************/
 
 bool Calendar::isWorking( Date date ) const
@@ -344,15 +479,16 @@ bool Calendar::isWorking( Date date ) const
 DateTime Calendar::workUp( DateTime dt ) const
 {
   // return date-time now or future when working
-  Date  date = dt / 1440u;
-  Day*  day  = Calendar::day( date );
-  Time  time = day->workUp( dt % 1440u );
+  int   cursor = -1;
+  Date  date   = dt / 1440u;
+  Day*  day    = Calendar::day( date, cursor );
+  Time  time   = day->workUp( dt % 1440u );
 
   // if day work-up time is null, need to move forward a day until a working day is found
   if ( time == XTime::NULL_TIME )
   {
     do
-      day = Calendar::day( ++date );
+      day = Calendar::day( ++date, cursor );
     while ( !day->isWorking() );
     return date*1440u + day->start();
   }
@@ -365,15 +501,16 @@ DateTime Calendar::workUp( DateTime dt ) const
 DateTime Calendar::workDown( DateTime dt ) const
 {
   // return date-time now or past when working
-  Date  date = dt / 1440u;
-  Day*  day  = Calendar::day( date );
-  Time  time = day->workDown( dt % 1440u );
+  int   cursor = -1;
+  Date  date   = dt / 1440u;
+  Day*  day    = Calendar::day( date, cursor );
+  Time  time   = day->workDown( dt % 1440u );
 
   // if day work-down time is null, need to move back a day until a working day is found
   if ( time == XTime::NULL_TIME )
   {
     do
-      day = Calendar::day( --date );
+      day = Calendar::day( --date, cursor );
     while ( !day->isWorking() );
     return date*1440u + day->end();
   }
@@ -417,8 +554,9 @@ DateTime  Calendar::addMinutes( DateTime start, int mins )
   if ( mins > 0 )
   {
     // use up any remaining working minutes on start date
+    int   cursor = -1;
     Date  date  = start / 1440u;
-    Day*  today = day( date );
+    Day*  today = day( date, cursor );
     int toGo  = today->minsToGo( start % 1440u );
     if ( toGo == mins ) return date*1440u + today->end();
     if ( toGo >  mins ) return date*1440u + today->doMins( start % 1440u, mins );
@@ -431,7 +569,7 @@ DateTime  Calendar::addMinutes( DateTime start, int mins )
     while ( true )
     {
       // check if found finish date
-      today = day( date );
+      today = day( date, cursor );
       if ( today->minutes() == mins ) return date*1440u + today->end();
       if ( today->minutes() >  mins ) return date*1440u + today->doMins( 0, mins );
 
@@ -444,8 +582,9 @@ DateTime  Calendar::addMinutes( DateTime start, int mins )
   {
     // work backwards on any minutes done on start date
     mins = -mins;
+    int   cursor = -1;
     Date  date  = start / 1440u;
-    Day*  today = day( date );
+    Day*  today = day( date, cursor );
     int done  = today->minsDone( start % 1440u );
     if ( done == mins ) return date*1440u + today->start();
     if ( done >  mins ) return date*1440u + today->doMins( today->start(), done - mins );
@@ -458,7 +597,7 @@ DateTime  Calendar::addMinutes( DateTime start, int mins )
     while ( true )
     {
       // check if found finish date
-      today = day( date );
+      today = day( date, cursor );
       if ( today->minutes() == mins ) return date*1440u + today->start();
       if ( today->minutes() >  mins ) return date*1440u + today->doMins( today->start(), today->minutes() - mins );
 
@@ -478,8 +617,9 @@ DateTime  Calendar::addDays( DateTime start, float days )
   if ( days > 0.0f )
   {
     // use up any remaining working time on start date
+    int   cursor = -1;
     Date  date  = start / 1440u;
-    Day*  today = day( date );
+    Day*  today = day( date, cursor );
     float toGo  = today->workToGo( start % 1440u );
     if ( toGo == days ) return date*1440u + today->end();
     if ( toGo >  days ) return date*1440u + today->doWork( start % 1440u, days );
@@ -492,7 +632,7 @@ DateTime  Calendar::addDays( DateTime start, float days )
     while ( true )
     {
       // check if found finish date
-      today = day( date );
+      today = day( date, cursor );
       if ( today->work() == days ) return date*1440u + today->end();
       if ( today->work() >  days ) return date*1440u + today->doWork( 0, days );
 
@@ -505,8 +645,9 @@ DateTime  Calendar::addDays( DateTime start, float days )
   {
     // work backwards on any work done on start date
     days = -days;
+    int   cursor = -1;
     Date  date  = start / 1440u;
-    Day*  today = day( date );
+    Day*  today = day( date, cursor );
     float done  = today->workDone( start % 1440u );
     if ( done == days ) return date*1440u + today->start();
     if ( done >  days ) return date*1440u + today->doWork( today->start(), done - days );
@@ -519,7 +660,7 @@ DateTime  Calendar::addDays( DateTime start, float days )
     while ( true )
     {
       // check if found finish date
-      today = day( date );
+      today = day( date, cursor );
       if ( today->work() == days ) return date*1440u + today->start();
       if ( today->work() >  days ) return date*1440u + today->doWork( today->start(), today->work() - days );
 
@@ -538,28 +679,28 @@ DateTime  Calendar::addWeeks( DateTime start, float weeks )
 
 DateTime  Calendar::addMonths( DateTime start, float months )
 {
-  // return date-time moved by months
+  // return date-time moved by months, fraction is proportion of days in following month
   int       whole    = floor(months);
   float     fraction = months - whole;
-  QDateTime qdt      = XDateTime::qdatetime( start );
-  qdt = qdt.addMonths( whole );
-
-  if ( fraction == 0.0f ) return XDateTime::datetime( qdt );
-  QDate date1 = qdt.date();
-  QDate date2 = date1.addMonths(1);
-  int   diff  = date2.toJulianDay() - date1.toJulianDay();
-  return XDateTime::datetime( qdt.addDays( diff * fraction ) );
+  Date      date     = XDate::addMonths( start / 1440u, whole );
+
+  if ( fraction != 0.0f )
+  {
+    int  diff = XDate::addMonths( date, 1 ) - date;
+    date += qint64( diff * fraction );
+  }
+  return date*1440u + start % 1440u;
 }
 
 DateTime  Calendar::addYears( DateTime start, float years )
 {
-  // return date-time moved by years
+  // return date-time moved by years, fraction as months
   int       whole    = floor(years);
   float     fraction = years - whole;
-  QDateTime qdt      = XDateTime::qdatetime( start );
+  DateTime  moved    = XDate::addYears( start / 1440u, whole )*1440u + start % 1440u;
 
-  if ( fraction == 0.0f ) return XDateTime::datetime( qdt.addYears( whole ) );
-  return addMonths( XDateTime::datetime( qdt.addYears( whole ) ), fraction*12.0f );
+  if ( fraction == 0.0f ) return moved;
+  return addMonths( moved, fraction*12.0f );
 }
 
 /****************************************** workBetween ******************************************/
@@ -570,17 +711,18 @@ TimeSpan Calendar::workBetween( DateTime start, DateTime end )
   if ( start == XDateTime::NULL_DATETIME || end== XDateTime::NULL_DATETIME ) return TimeSpan( 0.0f, TimeSpan::UNIT_DAYS );
   if ( start == end ) return TimeSpan( 0.0f, TimeSpan::UNIT_DAYS );
   if ( start >  end ) qSwap( start, end );
+  int   cursor = -1;
   Date  sd   = start/1440u;
   Date  ed   = end/1440u;
-  Day*  day  = Calendar::day( sd );
+  Day*  day  = Calendar::day( sd, cursor );
   float work = day->workToGo( start % 1440u );
 
   if ( sd == ed ) return TimeSpan( work - day->workToGo( end % 1440u ), TimeSpan::UNIT_DAYS );
 
   for( Date date = sd+1 ; date < ed ; date++ )
-    work += Calendar::day( date )->work();
+    work += Calendar::day( date, cursor )->work();
 
-  work += Calendar::day( ed )->workDone( end % 1440u );
+  work += Calendar::day( ed, cursor )->workDone( end % 1440u );
 
   return TimeSpan( work, TimeSpan::UNIT_DAYS );
 }
@@ -23,10 +23,10 @@
 
 #include <QString>
 #include <QVector>
-#include <QHash>
 
 #include "datetime.h"
 #include "timespan.h"
+#include "tag.h"
 
 class Day;
 class QXmlStreamReader;
@@ -39,17 +39,28 @@ class QXmlStreamWriter;
 class Calendar
 {
   friend class CommandCalendarSetData;
+  friend class CalendarCombiner;
 public:
   Calendar();                                                  // constructor
   Calendar( int );                                             // constructor for initial default calendars
   Calendar( QXmlStreamReader* );                               // constructor from xml file
 
   void          saveToStream( QXmlStreamWriter* );             // write calendar data to xml stream
-  QString       name() const { return m_name; }                // return calendar name
+  QString       name() const { return XTag::string( m_name ); }  // return calendar name
   int           cycleLength() const { return m_cycleLength; }  // return calendar cycle length
   bool          isWorking( Date ) const;                       // return true if has work periods
 
+  struct Run
+  {
+    Date   start;                        // first non-working date of run
+    Date   end;                          // first working date after run
+  };
+
+  QVector<Run>  nonWorking( Date, Date );                      // return non-working runs overlapping dates
+
   Day*          day( Date ) const;                             // return day type for given date
+  Day*          day( Date, int& ) const;                       // return day type using exceptions cursor
+  bool          shareExceptions( const Calendar* );            // share exceptions storage if identical
   DateTime      workUp( DateTime ) const;                      // return date-time now or future when working
   DateTime      workDown( DateTime ) const;                    // return date-time now or past when working
 
@@ -84,11 +95,30 @@ public:
   };
 
 private:
-  QString             m_name;            // name of calendar
+  Day*          normal( Date ) const;                          // return normal cycle day for given date
+  int           findException( Date ) const;                   // return index of first exception on or after date
+  void          setException( Date, Day* );                    // set exception day for given date
+  void          cacheRuns( Date, Date );                       // cache non-working runs covering dates
+
+  struct Exception
+  {
+    Date   date;                         // date of exception
+    Day*   day;                          // day type overriding normal cycle day
+
+    bool   operator==( const Exception& other ) const
+             { return date == other.date && day == other.day; }
+  };
+
+  Tag                 m_name;            // name of calendar
   Date                m_cycleAnchor;     // anchor date of calendar cycle
-  quint8              m_cycleLength;     // length of basic cycle (eg 7)
+  int                 m_cycleLength;     // length of basic cycle (eg 7)
   QVector<Day*>       m_normal;          // normal basic cycle days
-  QHash<Date, Day*>   m_exceptions;      // exceptions override normal days
+  QVector<Exception>  m_exceptions;      // exceptions override normal days, sorted by date
+
+  quint32             m_runsVersion;     // calendars version when non-working runs cached
+  Date                m_runsFirst;       // first date covered by cached runs
+  Date                m_runsLast;        // last date covered by cached runs
+  QVector<Run>        m_runs;            // cached non-working runs, sorted by date
 };
 
 #endif // CALENDAR_H
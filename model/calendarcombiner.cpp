@@ -0,0 +1,206 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "calendarcombiner.h"
+
+/*************************************************************************************************/
+/************ Builds and caches calendars combining working time of two calendars ***************/
+/*************************************************************************************************/
+
+/****************************************** constructor ******************************************/
+
+CalendarCombiner::CalendarCombiner() : m_calendarPool( POOL_BLOCK ), m_dayPool( POOL_BLOCK )
+{
+  // start with empty cache
+  m_version      = 0;
+  m_cacheVersion = 0;
+}
+
+/******************************************** created ********************************************/
+
+int CalendarCombiner::created()
+{
+  // return number of combined calendars and days ever created
+  return m_calendarPool.created() + m_dayPool.created();
+}
+
+/******************************************** blocks *********************************************/
+
+int CalendarCombiner::blocks()
+{
+  // return number of pool blocks allocated for combined calendars and days
+  return m_calendarPool.blocks() + m_dayPool.blocks();
+}
+
+/******************************************* intersect *******************************************/
+
+Calendar*  CalendarCombiner::intersect( Calendar* a, Calendar* b )
+{
+  // return calendar working only when both calendars are working
+  return combine( a, b, OP_INTERSECT );
+}
+
+/********************************************* unite *********************************************/
+
+Calendar*  CalendarCombiner::unite( Calendar* a, Calendar* b )
+{
+  // return calendar working when either calendar is working
+  return combine( a, b, OP_UNITE );
+}
+
+/***************************************** checkVersion ******************************************/
+
+void  CalendarCombiner::checkVersion()
+{
+  // if any calendar or day edited since cache built, discard all combined calendars and days
+  if ( m_cacheVersion == m_version ) return;
+
+  for( int op=OP_INTERSECT ; op<=OP_UNITE ; op++ )
+  {
+    m_calendars[op].clear();
+    m_days[op].clear();
+  }
+  m_calendarPool.clear();
+  m_dayPool.clear();
+  m_cacheVersion = m_version;
+}
+
+/******************************************** combine ********************************************/
+
+Calendar*  CalendarCombiner::combine( Calendar* a, Calendar* b, int op )
+{
+  // combining a calendar with itself gives the same calendar
+  if ( a == b ) return a;
+  checkVersion();
+
+  // return cached combined calendar if exists
+  CalendarPair  key( a, b );
+  Calendar*     cal = m_calendars[op].value( key, nullptr );
+  if ( cal ) return cal;
+
+  // combined cycle repeats after lowest common multiple of the two cycle lengths
+  int  gcd = a->m_cycleLength;
+  int  r   = b->m_cycleLength;
+  while ( r ) { int t = gcd % r; gcd = r; r = t; }
+  int  length = a->m_cycleLength / gcd * b->m_cycleLength;
+
+  cal = m_calendarPool.create();
+  cal->m_name        = XTag::NULL_TAG;
+  cal->m_cycleAnchor = a->m_cycleAnchor;
+  cal->m_cycleLength = length;
+  cal->m_normal.resize( length );
+
+  bool working = false;
+  for( int n=0 ; n<length ; n++ )
+  {
+    Date date        = a->m_cycleAnchor + n;
+    cal->m_normal[n] = combine( a->normal( date ), b->normal( date ), op );
+    working          = working || cal->m_normal[n]->isWorking();
+  }
+
+  // combine days on dates where either calendar has an exception, in date order
+  int  ea = 0, eb = 0;
+  while ( ea < a->m_exceptions.size() || eb < b->m_exceptions.size() )
+  {
+    Date date;
+    if ( eb >= b->m_exceptions.size() )     date = a->m_exceptions.at( ea++ ).date;
+    else if ( ea >= a->m_exceptions.size() ) date = b->m_exceptions.at( eb++ ).date;
+    else
+    {
+      date = qMin( a->m_exceptions.at( ea ).date, b->m_exceptions.at( eb ).date );
+      if ( a->m_exceptions.at( ea ).date == date ) ea++;
+      if ( b->m_exceptions.at( eb ).date == date ) eb++;
+    }
+    cal->setException( date, combine( a->day( date ), b->day( date ), op ) );
+  }
+
+  // combined calendar with no normal working time would never find work, so use first instead
+  if ( !working )
+  {
+    qWarning("CalendarCombiner::combine - '%s' and '%s' have no working time in common",
+             qPrintable( a->name() ), qPrintable( b->name() ) );
+    cal = a;
+  }
+
+  m_calendars[op].insert( key, cal );
+  return cal;
+}
+
+/******************************************** combine ********************************************/
+
+Day*  CalendarCombiner::combine( Day* x, Day* y, int op )
+{
+  // combining a day with itself gives the same day
+  if ( x == y ) return x;
+
+  // return cached combined day if exists
+  DayPair  key( x, y );
+  Day*     day = m_days[op].value( key, nullptr );
+  if ( day ) return day;
+
+  // build combined work periods by walking both days periods in time order
+  day = m_dayPool.create();
+  int  px = 0, py = 0;
+  if ( op == OP_UNITE )
+  {
+    // take periods from either day in start time order, merging any that overlap or touch
+    while ( px < x->m_periods || py < y->m_periods )
+    {
+      bool  takeX = py >= y->m_periods || ( px < x->m_periods && x->m_start[px] <= y->m_start[py] );
+      Time  start = takeX ? x->m_start[px] : y->m_start[py];
+      Time  end   = takeX ? x->m_end[px++] : y->m_end[py++];
+      int   last  = day->m_end.size() - 1;
+      if ( last >= 0 && start <= day->m_end[last] )
+        day->m_end[last] = qMax( day->m_end[last], end );
+      else
+      {
+        day->m_start.append( start );
+        day->m_end.append( end );
+      }
+    }
+  }
+  else
+  {
+    // working only where periods from both days overlap, moving past whichever ends first
+    while ( px < x->m_periods && py < y->m_periods )
+    {
+      Time  start = qMax( x->m_start[px], y->m_start[py] );
+      Time  end   = qMin( x->m_end[px], y->m_end[py] );
+      if ( start < end )
+      {
+        day->m_start.append( start );
+        day->m_end.append( end );
+      }
+
+      if ( x->m_end[px] < y->m_end[py] ) px++;
+      else                               py++;
+    }
+  }
+
+  day->m_periods = day->m_start.size();
+  day->calcMinutes();
+
+  // scale days equivalent work by proportion of first (or else second) day minutes worked
+  Day*  ref = x->m_minutes > 0 ? x : y;
+  if ( ref->m_minutes > 0 ) day->m_work = ref->m_work * day->m_minutes / ref->m_minutes;
+
+  m_days[op].insert( key, day );
+  return day;
+}
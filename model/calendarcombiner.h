@@ -0,0 +1,72 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef CALENDARCOMBINER_H
+#define CALENDARCOMBINER_H
+
+#include <QHash>
+#include <QPair>
+
+#include "objectpool.h"
+#include "calendar.h"
+#include "day.h"
+
+/*************************************************************************************************/
+/************ Builds and caches calendars combining working time of two calendars ***************/
+/*************************************************************************************************/
+
+class CalendarCombiner
+{
+public:
+  CalendarCombiner();                                      // constructor
+
+  Calendar*     intersect( Calendar*, Calendar* );         // return calendar working when both are working
+  Calendar*     unite( Calendar*, Calendar* );             // return calendar working when either is working
+
+  quint32       version() const { return m_version; }      // return version, changes on calendar edits
+  void          invalidate() { m_version++; }              // discard cache as calendar or day edited
+  int           created();                                 // return number of calendars & days ever created
+  int           blocks();                                  // return number of pool blocks allocated
+
+  enum Operation
+  {
+    OP_INTERSECT = 0,
+    OP_UNITE     = 1
+  };
+
+private:
+  typedef QPair<Calendar*,Calendar*>  CalendarPair;
+  typedef QPair<Day*,Day*>            DayPair;
+
+  Calendar*     combine( Calendar*, Calendar*, int );      // return cached or new combined calendar
+  Day*          combine( Day*, Day*, int );                // return cached or new combined day
+  void          checkVersion();                            // clear cache if calendars edited since built
+
+  quint32                       m_version;         // incremented whenever any calendar or day edited
+  quint32                       m_cacheVersion;    // version when cache was built
+  QHash<CalendarPair,Calendar*> m_calendars[2];    // cached combined calendars for each operation
+  QHash<DayPair,Day*>           m_days[2];         // cached combined days for each operation
+  ObjectPool<Calendar>          m_calendarPool;    // pool holding combined calendar objects
+  ObjectPool<Day>               m_dayPool;         // pool holding combined day objects
+
+  static const int  POOL_BLOCK = 16;               // combined calendars or days per pool block
+};
+
+#endif // CALENDARCOMBINER_H
@@ -30,7 +30,7 @@
 
 /****************************************** constructor ******************************************/
 
-CalendarsModel::CalendarsModel() : QAbstractTableModel()
+CalendarsModel::CalendarsModel() : QAbstractTableModel(), m_pool( POOL_BLOCK )
 {
 }
 
@@ -38,8 +38,8 @@ CalendarsModel::CalendarsModel() : QAbstractTableModel()
 
 CalendarsModel::~CalendarsModel()
 {
-  // delete all calendars in model
-  foreach( Calendar* c, m_calendars ) delete c;
+  // destroy all calendars in model in one go
+  m_pool.clear();
 }
 
 /****************************************** initialise *******************************************/
@@ -48,7 +48,8 @@ void CalendarsModel::initialise()
 {
   // create initial default calendars
   for ( int cal=0 ; cal<=Calendar::DEFAULT_MAX ; cal++ )
-    m_calendars.append( new Calendar(cal) );
+    m_calendars.append( m_pool.create(cal) );
+  m_combiner.invalidate();
 }
 
 /***************************************** saveToStream ******************************************/
@@ -75,13 +76,20 @@ void  CalendarsModel::saveToStream( QXmlStreamWriter* stream )
 void  CalendarsModel::loadFromStream( QXmlStreamReader* stream )
 {
   // load calendars data from xml stream
+  m_combiner.invalidate();
   while ( !stream->atEnd() )
   {
     stream->readNext();
 
     // if calendar element create new calendar
     if ( stream->isStartElement() && stream->name() == "calendar" )
-      m_calendars.append( new Calendar(stream) );
+    {
+      // share identical exceptions (e.g. same holidays) with earlier calendar so only stored once
+      Calendar* cal = m_pool.create(stream);
+      foreach( Calendar* c, m_calendars )
+        if ( cal->shareExceptions( c ) ) break;
+      m_calendars.append( cal );
+    }
 
     // when reached end of calendars data return
     if ( stream->isEndElement() && stream->name() == "calendars-data" ) return;
@@ -131,7 +139,7 @@ bool CalendarsModel::setData( const QModelIndex& index, const QVariant& value, i
   if ( value == data( index, role ) ) return false;
 
   // set data via undo/redo command
-  plan->undostack()->push( new CommandCalendarSetData( index, value ) );
+  plan->push( new CommandCalendarSetData( index, value ) );
   return true;
 }
 
@@ -23,6 +23,9 @@
 
 #include <QAbstractTableModel>
 
+#include "objectpool.h"
+#include "calendarcombiner.h"
+
 class Calendar;
 
 class QXmlStreamWriter;
@@ -46,6 +49,11 @@ public:
   Calendar*      calendar( int n );                                       // return pointer to n'th calendar
   int            index( Calendar* c ) { return m_calendars.indexOf(c); }  // return index of calendar, or -1
   int            number() { return m_calendars.size(); }                  // return number of calendars in plan
+  int            created() { return m_pool.created()
+                                + m_combiner.created(); }                 // return number of calendars ever created
+  int            blocks() { return m_pool.blocks()
+                               + m_combiner.blocks(); }                   // return number of pool blocks allocated
+  CalendarCombiner&  combiner() { return m_combiner; }                    // return combined calendars cache
   QStringList    namesList() const;                                       // return list of calendar names
 
   bool           nameIsDuplicate( const QString&, int );                  // return if name is a repeat
@@ -78,6 +86,10 @@ signals:
 
 private:
   QList<Calendar*>   m_calendars;     // list of calendars available to plan
+  ObjectPool<Calendar> m_pool;        // pool holding calendar objects
+
+  static const int  POOL_BLOCK = 8;    // calendars per pool block, plans usually have a handful
+  CalendarCombiner   m_combiner;      // cache of calendars combining plan and resource calendars
 
   QModelIndex     m_overrideIndex;    // with value can override model for edits in progress
   QVariant        m_overrideValue;    // with index can override model for edits in progress
@@ -64,6 +64,28 @@ QString XTime::toString( Time t )
 /********************** XDate provides static methods to support Date type ***********************/
 /*************************************************************************************************/
 
+// number of days in each month of non-leap year, and days from 1st March 0000 to Date zero
+static constexpr int  MONTH_DAYS[13] = { 0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+static constexpr int  MARCH_OFFSET   = 306;
+
+static constexpr bool isLeapYear( int year )
+{
+  return ( year % 4 == 0 && year % 100 != 0 ) || year % 400 == 0;
+}
+
+// return value of digits field at position in string ref, or -1 if not all digits
+static int  fieldValue( const QStringRef& str, int pos, int len )
+{
+  int value = 0;
+  for( int i = pos ; i < pos + len ; i++ )
+  {
+    ushort c = str.at( i ).unicode();
+    if ( c < '0' || c > '9' ) return -1;
+    value = value * 10 + c - '0';
+  }
+  return value;
+}
+
 const QDate  XDate::ANCHOR_QDATE  = QDate( 1, 1, 1 );
 const qint64 XDate::ANCHOR_JULIAN = XDate::ANCHOR_QDATE.toJulianDay();
 
@@ -84,7 +106,13 @@ Date XDate::date( int year, int mon, int day )
   Q_ASSERT( day >= 1 );
   Q_ASSERT( day <= 31 );
 
-  return QDate( year, mon, day ).toJulianDay() - ANCHOR_JULIAN;
+  // integer civil calendar arithmetic with years starting 1st March so leap day is last
+  if ( mon <= 2 ) year--;
+  int  era = year / 400;
+  int  yoe = year - era * 400;
+  int  doy = ( 153 * ( mon > 2 ? mon - 3 : mon + 9 ) + 2 ) / 5 + day - 1;
+  int  doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - MARCH_OFFSET;
 }
 
 Date XDate::date( QDate qd )
@@ -94,6 +122,59 @@ Date XDate::date( QDate qd )
   return qd.toJulianDay() - ANCHOR_JULIAN;
 }
 
+/********************************************* ymd ***********************************************/
+
+void XDate::ymd( Date d, int& year, int& mon, int& day )
+{
+  // set year, month, day from qint32 Date using integer civil calendar arithmetic
+  Q_ASSERT( d >= 0 );
+  int  z   = d + MARCH_OFFSET;
+  int  era = z / 146097;
+  int  doe = z - era * 146097;
+  int  yoe = ( doe - doe / 1460 + doe / 36524 - doe / 146096 ) / 365;
+  int  doy = doe - ( 365 * yoe + yoe / 4 - yoe / 100 );
+  int  mp  = ( 5 * doy + 2 ) / 153;
+
+  day  = doy - ( 153 * mp + 2 ) / 5 + 1;
+  mon  = mp < 10 ? mp + 3 : mp - 9;
+  year = yoe + era * 400 + ( mon <= 2 ? 1 : 0 );
+}
+
+/****************************************** daysInMonth ******************************************/
+
+int XDate::daysInMonth( int year, int mon )
+{
+  // return number of days in month of year
+  if ( mon == 2 && isLeapYear( year ) ) return 29;
+  return MONTH_DAYS[ mon ];
+}
+
+/******************************************* addMonths *******************************************/
+
+Date XDate::addMonths( Date d, int months )
+{
+  // return Date moved by months, like QDate day is limited to end of month
+  int  year, mon, day;
+  ymd( d, year, mon, day );
+
+  int  m = year * 12 + mon - 1 + months;
+  year   = m / 12;
+  mon    = m % 12 + 1;
+  return date( year, mon, qMin( day, daysInMonth( year, mon ) ) );
+}
+
+/******************************************* addYears ********************************************/
+
+Date XDate::addYears( Date d, int years )
+{
+  // return Date moved by years, like QDate 29th Feb becomes 28th Feb in non-leap years
+  int  year, mon, day;
+  ymd( d, year, mon, day );
+
+  year += years;
+  return date( year, mon, qMin( day, daysInMonth( year, mon ) ) );
+}
+
 /******************************************** qdate **********************************************/
 
 QDate XDate::qdate( Date d )
@@ -116,7 +197,21 @@ Date XDate::currentDate()
 Date XDate::fromString( QString str )
 {
   // return Date from yyyy-MM-dd string
-  return XDate::date( QDate::fromString( str, "yyyy-MM-dd" ) );
+  return fromString( QStringRef( &str ) );
+}
+
+Date XDate::fromString( const QStringRef& str )
+{
+  // return Date from yyyy-MM-dd string ref, parsed in place as used heavily when loading
+  if ( str.size() != 10 || str.at(4) != '-' || str.at(7) != '-' ) return NULL_DATE;
+
+  int  year = fieldValue( str, 0, 4 );
+  int  mon  = fieldValue( str, 5, 2 );
+  int  day  = fieldValue( str, 8, 2 );
+  if ( year < 1 || year > 7999 || mon < 1 || mon > 12 ) return NULL_DATE;
+  if ( day < 1 || day > daysInMonth( year, mon ) ) return NULL_DATE;
+
+  return date( year, mon, day );
 }
 
 /******************************************* toString ********************************************/
@@ -191,9 +286,20 @@ DateTime XDateTime::currentDateTime()
 DateTime XDateTime::fromString( QString str )
 {
   // return DateTime from yyyy-MM-ddThh:mm string
-  QDateTime qdt = QDateTime::fromString( str.left(16) , "yyyy-MM-ddThh:mm" );
-  qdt.setTimeSpec( Qt::UTC );
-  return XDateTime::datetime( qdt );
+  return fromString( QStringRef( &str ) );
+}
+
+DateTime XDateTime::fromString( const QStringRef& str )
+{
+  // return DateTime from yyyy-MM-ddThh:mm string ref (ignoring any seconds), parsed in place
+  if ( str.size() < 16 || str.at(10) != 'T' || str.at(13) != ':' ) return NULL_DATETIME;
+
+  Date  date  = XDate::fromString( QStringRef( str.string(), str.position(), 10 ) );
+  int   hours = fieldValue( str, 11, 2 );
+  int   mins  = fieldValue( str, 14, 2 );
+  if ( date == XDate::NULL_DATE || hours < 0 || hours > 23 || mins < 0 || mins > 59 ) return NULL_DATETIME;
+
+  return date*1440u + hours*60u + mins;
 }
 
 /******************************************* toString ********************************************/
@@ -218,23 +324,25 @@ QString XDateTime::toString( DateTime dt, QString format )
 DateTime XDateTime::trunc( DateTime dt, XDateTime::Interval interval )
 {
   // return DateTime truncated to interval
-  QDate qd = XDate::qdate( dt/1440u );
+  int  year, mon, day;
+  XDate::ymd( dt/1440u, year, mon, day );
   switch( interval )
   {
     case INTERVAL_YEAR:
-      return 1440u * XDate::date( qd.year(), 1, 1 );
+      return 1440u * XDate::date( year, 1, 1 );
     case INTERVAL_HALFYEAR:
-      if ( qd.month() > 6 ) return 1440u * XDate::date( qd.year(), 7, 1 );
-      return 1440u * XDate::date( qd.year(), 1, 1 );
+      if ( mon > 6 ) return 1440u * XDate::date( year, 7, 1 );
+      return 1440u * XDate::date( year, 1, 1 );
     case INTERVAL_QUARTERYEAR:
-      if ( qd.month() > 9 ) return 1440u * XDate::date( qd.year(), 10, 1 );
-      if ( qd.month() > 6 ) return 1440u * XDate::date( qd.year(), 7, 1 );
-      if ( qd.month() > 3 ) return 1440u * XDate::date( qd.year(), 4, 1 );
-      return 1440u * XDate::date( qd.year(), 1, 1 );
+      if ( mon > 9 ) return 1440u * XDate::date( year, 10, 1 );
+      if ( mon > 6 ) return 1440u * XDate::date( year, 7, 1 );
+      if ( mon > 3 ) return 1440u * XDate::date( year, 4, 1 );
+      return 1440u * XDate::date( year, 1, 1 );
     case INTERVAL_MONTH:
-      return 1440u * XDate::date( qd.year(), qd.month(), 1 );
+      return 1440u * XDate::date( year, mon, 1 );
     case INTERVAL_WEEK:
-      return 1440u * XDate::date( qd.addDays( 1-qd.dayOfWeek() ) );
+      // Date zero (1st Jan 0001) is a Monday
+      return 1440u * ( dt/1440u - (dt/1440u) % 7u );
     case INTERVAL_DAY:
       return dt - dt%1440u;
     default:
@@ -248,21 +356,22 @@ DateTime XDateTime::trunc( DateTime dt, XDateTime::Interval interval )
 DateTime XDateTime::next( DateTime dt, XDateTime::Interval interval )
 {
   // return DateTime moved forward by interval
-  QDateTime qdt = XDateTime::qdatetime( dt );
+  Date  date = dt/1440u;
+  Time  time = dt%1440u;
   switch( interval )
   {
     case INTERVAL_YEAR:
-      return XDateTime::datetime( qdt.addYears(1) );
+      return 1440u * XDate::addYears( date, 1 ) + time;
     case INTERVAL_HALFYEAR:
-      return XDateTime::datetime( qdt.addMonths(6) );
+      return 1440u * XDate::addMonths( date, 6 ) + time;
     case INTERVAL_QUARTERYEAR:
-      return XDateTime::datetime( qdt.addMonths(3) );
+      return 1440u * XDate::addMonths( date, 3 ) + time;
     case INTERVAL_MONTH:
-      return XDateTime::datetime( qdt.addMonths(1) );
+      return 1440u * XDate::addMonths( date, 1 ) + time;
     case INTERVAL_WEEK:
-      return XDateTime::datetime( qdt.addDays(7) );
+      return dt + 7u*1440u;
     case INTERVAL_DAY:
-      return XDateTime::datetime( qdt.addDays(1) );
+      return dt + 1440u;
     default:
       qWarning("XDateTime::next - UNKNOWN interval %i", interval );
       return XDateTime::NULL_DATETIME;
@@ -61,9 +61,14 @@ public:
 
   static Date      date( int, int, int );      // return Date from year, month, day
   static Date      date( QDate );              // return Date from QDate
+  static void      ymd( Date, int&, int&, int& );   // set year, month, day from Date
+  static int       daysInMonth( int, int );    // return number of days in month of year
+  static Date      addMonths( Date, int );     // return Date moved by months (day limited to month end)
+  static Date      addYears( Date, int );      // return Date moved by years (29th Feb to 28th)
   static QDate     qdate( Date );              // return QDate from Date
   static Date      currentDate();              // return Date for current date
   static Date      fromString( QString );      // return Date from yyyy-MM-dd string
+  static Date      fromString( const QStringRef& );  // return Date from yyyy-MM-dd string ref
   static QString   toString( Date );           // return dd/MM/yyyy string from Date
   static QString   toString( Date, QString );  // return string in format from Date
 };
@@ -96,6 +101,7 @@ public:
   static QDateTime   qdatetime( DateTime );         // return QDateTime from DateTime
   static DateTime    currentDateTime();             // return DateTime for current date-time
   static DateTime    fromString( QString );         // return DateTime from yyyy-MM-ddThh:mm string
+  static DateTime    fromString( const QStringRef& );  // return DateTime from yyyy-MM-ddThh:mm string ref
   static QString     toString( DateTime );          // return dd/MM/yyyy hh:mm string from DateTime
   static QString     toString( DateTime, QString ); // return string in format from DateTime
   static DateTime    trunc( DateTime, Interval );   // return DateTime truncated to interval
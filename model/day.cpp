@@ -21,9 +21,12 @@
 #include <QXmlStreamWriter>
 #include <QXmlStreamReader>
 
+#include <algorithm>
+
 #include "day.h"
 #include "plan.h"
 #include "daysmodel.h"
+#include "calendarsmodel.h"
 
 /*************************************************************************************************/
 /**************************** Single day type used in plan calendars *****************************/
@@ -34,7 +37,7 @@
 Day::Day()
 {
   // create null day
-  m_name    = "Null";
+  m_name    = XTag::tag( "Null" );
   m_work    = 0.0f;
   m_periods = 0;
   m_minutes = 0;
@@ -48,7 +51,7 @@ Day::Day( int type )
   if ( type == DEFAULT_STANDARDWORK )
   {
     // default working day
-    m_name     = "Standard work day";
+    m_name     = XTag::tag( "Standard work day" );
     m_work     = 1.0f;
     m_periods  = 2;
     m_start.resize(2);
@@ -61,7 +64,7 @@ Day::Day( int type )
   else if ( type == DEFAULT_TWENTYFOURHOURS )
   {
     // default 24H day
-    m_name     = "24H day";
+    m_name     = XTag::tag( "24H day" );
     m_work     = 1.5f;
     m_periods  = 1;
     m_start.resize(1);
@@ -72,7 +75,7 @@ Day::Day( int type )
   else if ( type == DEFAULT_SHORT )
   {
     // default short day
-    m_name     = "Morning only";
+    m_name     = XTag::tag( "Morning only" );
     m_work     = 0.5f;
     m_periods  = 1;
     m_start.resize(1);
@@ -83,7 +86,7 @@ Day::Day( int type )
   else if ( type == DEFAULT_EVENING )
   {
     // default evening shift
-    m_name     = "Evening shift";
+    m_name     = XTag::tag( "Evening shift" );
     m_work     = 0.6f;
     m_periods  = 1;
     m_start.resize(1);
@@ -94,7 +97,7 @@ Day::Day( int type )
   else  // DEFAULT_NONWORK
   {
     // default non-working day
-    m_name    = "Non working";
+    m_name    = XTag::tag( "Non working" );
     m_work    = 0.0f;
     m_periods = 0;
   }
@@ -111,7 +114,7 @@ Day::Day( QXmlStreamReader* stream ) : Day()
   foreach( QXmlStreamAttribute attribute, stream->attributes() )
   {
     if ( attribute.name() == "name" )
-      m_name = attribute.value().toString();
+      m_name = XTag::tag( attribute.value().toString() );
 
     if ( attribute.name() == "work" )
       m_work = attribute.value().toString().toFloat();
@@ -151,7 +154,7 @@ Day::Day( QXmlStreamReader* stream ) : Day()
 void  Day::saveToStream( QXmlStreamWriter* stream )
 {
   // write day data to xml stream
-  stream->writeAttribute( "name", m_name );
+  stream->writeAttribute( "name", XTag::string( m_name ) );
   stream->writeAttribute( "work", QString("%1").arg(m_work) );
 
   for( int p=0 ; p<m_periods ; p++ )
@@ -167,10 +170,23 @@ void  Day::saveToStream( QXmlStreamWriter* stream )
 
 void Day::calcMinutes()
 {
-  // calculate number of worked minutes in day
+  // calculate number of worked minutes in day, and cumulative minutes at start of each period
+  m_done.resize( m_periods );
   m_minutes = 0;
   for( int p=0 ; p<m_periods ; p++ )
+  {
+    m_done[p]  = m_minutes;
     m_minutes += m_end[p] - m_start[p];
+  }
+}
+
+/******************************************** period *********************************************/
+
+int Day::period( Time t ) const
+{
+  // return last period that starts before time, or -1 if none (binary search of start times)
+  const Time*  starts = m_start.constData();
+  return int( std::lower_bound( starts, starts + m_periods, t ) - starts ) - 1;
 }
 
 /********************************************* data **********************************************/
@@ -189,7 +205,7 @@ QVariant  Day::data( int column, int role )
   // if role is DisplayRole, return appropriate display value
   if ( role == Qt::DisplayRole )
   {
-    if ( column == SECTION_NAME )   return m_name;
+    if ( column == SECTION_NAME )   return XTag::string( m_name );
     if ( column == SECTION_WORK )   return QString("%1").arg( m_work, 0, 'f', 2 );
     if ( column == SECTION_PERIODS )  return m_periods;
 
@@ -223,8 +239,9 @@ QVariant  Day::data( int column, int role )
 
 void Day::setData( int col, const QVariant& value )
 {
-  // set day type data based on column
-  if ( col == SECTION_NAME ) m_name = value.toString();
+  // set day type data based on column, any combined calendars are now out of date
+  plan->calendars()->combiner().invalidate();
+  if ( col == SECTION_NAME ) m_name = XTag::tag( value.toString() );
 
   if ( col == SECTION_WORK ) m_work = value.toFloat();
 
@@ -318,26 +335,21 @@ Time Day::end()
 
 Time Day::workUp( Time t )
 {
-  // return time now or future when working or NULL time
-  for( int p=0 ; p<m_periods ; p++ )
-  {
-    if ( t <= m_start.at(p) ) return m_start.at(p);
-    if ( t <  m_end.at(p)   ) return t;
-  }
-  return XTime::NULL_TIME;
+  // return time now or future when working or NULL time, first period ending after time
+  const Time*  ends = m_end.constData();
+  int  p = int( std::upper_bound( ends, ends + m_periods, t ) - ends );
+  if ( p >= m_periods ) return XTime::NULL_TIME;
+  return qMax( t, m_start[p] );
 }
 
 /******************************************* workDown ********************************************/
 
 Time Day::workDown( Time t )
 {
-  // return time now or past when working or NULL time
-  for( int p=m_periods-1 ; p>=0 ; p-- )
-  {
-    if ( t >= m_end.at(p)   ) return m_end.at(p);
-    if ( t >  m_start.at(p) ) return t;
-  }
-  return XTime::NULL_TIME;
+  // return time now or past when working or NULL time, last period starting before time
+  int  p = period( t );
+  if ( p < 0 ) return XTime::NULL_TIME;
+  return qMin( t, m_end[p] );
 }
 
 /******************************************* workDone ********************************************/
@@ -363,14 +375,9 @@ float Day::workToGo( Time t )
 int Day::minsDone( Time t )
 {
   // return number of minutes done from start to time
-  int done = 0;
-  for( int p=0 ; p<m_periods ; p++ )
-  {
-    if ( t <= m_start.at(p) ) return done;
-    if ( t >= m_start.at(p) && t <= m_end.at(p) ) return done + t - m_start.at(p);
-    done += m_end.at(p) - m_start.at(p);
-  }
-  return done;
+  int  p = period( t );
+  if ( p < 0 ) return 0;
+  return m_done[p] + qMin( t, m_end[p] ) - m_start[p];
 }
 
 /******************************************* minsToGo ********************************************/
@@ -397,18 +404,30 @@ Time  Day::doMins( Time time, int mins ) const
   // if no periods than can't do any work
   if ( m_periods == 0 ) return XTime::NULL_TIME;
 
-  // move forward by number of working minutes
-  for( int p=0 ; p < m_periods ; p++ )
+  // move time before or between periods forward to next period start, as work starts there
+  int  p = period( time );
+  if ( p < 0 )
+  {
+    p    = 0;
+    time = m_start[0];
+  }
+  else if ( time > m_end[p] && p+1 < m_periods )
+    time = m_start[++p];
+
+  // determine cumulative worked minutes to reach, no work can be done after last period
+  int  target = m_done[p] + time - m_start[p] + mins;
+  if ( time > m_end[p] || target > m_minutes )
   {
-    if ( time < m_start.at(p) ) time = m_start.at(p);
-    int toGo = m_end.at(p) - time;
-    if ( mins <= toGo ) return time + mins;
-    mins -= toGo;
-    time = 0;
+    qWarning("Day::doMins - ERROR asked to do more minutes work than remains!!!");
+    return XTime::NULL_TIME;
   }
+  if ( mins == 0 ) return time;
 
-  qWarning("Day::doMins - ERROR asked to do more minutes work than remains!!!");
-  return XTime::NULL_TIME;
+  // find period where target is reached (preferring end of period over start of next)
+  const int*  done = m_done.constData();
+  p = int( std::lower_bound( done, done + m_periods, target ) - done ) - 1;
+  if ( p < 0 ) p = 0;
+  return m_start[p] + target - m_done[p];
 }
 
 /******************************************** stretch ********************************************/
@@ -22,10 +22,11 @@
 #define DAY_H
 
 #include <QString>
-#include <QVector>
+#include <QVarLengthArray>
 #include <QVariant>
 
 #include "datetime.h"
+#include "tag.h"
 
 class QXmlStreamReader;
 class QXmlStreamWriter;
@@ -37,6 +38,7 @@ class QXmlStreamWriter;
 class Day
 {
   friend class CommandDaySetData;
+  friend class CalendarCombiner;
 public:
   Day();                                               // constructor
   Day( int );                                          // constructor
@@ -44,7 +46,7 @@ public:
 
   void       saveToStream( QXmlStreamWriter* );        // write day data to xml stream
 
-  QString    name() { return m_name; }                 // return day name
+  QString    name() { return XTag::string( m_name ); } // return day name
   float      work() { return m_work; }                 // return work days equivalent
   quint8     periods() { return m_periods; }           // return number of work periods
   Time       start( int n ) { return m_start.at(n); }  // return work period start
@@ -90,13 +92,15 @@ public:
 
 private:
   void             calcMinutes();       // calculate number of worked minutes in day
+  int              period( Time ) const; // return last period starting before time, or -1
 
-  QString          m_name;              // name of day type
+  Tag              m_name;              // name of day type
   float            m_work;              // equivalent days worked (typically 1.0 or 0.0)
   int              m_minutes;           // number of worked minutes in day
   quint8           m_periods;           // number of work periods within the day
-  QVector<Time>    m_start;             // vector of work period start times
-  QVector<Time>    m_end;               // vector of work period end times
+  QVarLengthArray<Time,4>  m_start;     // work period start times
+  QVarLengthArray<Time,4>  m_end;       // work period end times
+  QVarLengthArray<int,4>   m_done;      // cumulative worked minutes at start of each period
 };
 
 #endif // DAY_H
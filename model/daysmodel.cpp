@@ -32,7 +32,7 @@
 
 /****************************************** constructor ******************************************/
 
-DaysModel::DaysModel() : QAbstractTableModel()
+DaysModel::DaysModel() : QAbstractTableModel(), m_pool( POOL_BLOCK )
 {
 }
 
@@ -40,8 +40,8 @@ DaysModel::DaysModel() : QAbstractTableModel()
 
 DaysModel::~DaysModel()
 {
-  // delete all day types in model
-  foreach( Day* d, m_days ) delete d;
+  // destroy all day types in model in one go
+  m_pool.clear();
 }
 
 /****************************************** initialise *******************************************/
@@ -50,7 +50,7 @@ void DaysModel::initialise()
 {
   // create initial default day types
   for ( int day=0 ; day<=Day::DEFAULT_MAX ; day++ )
-    m_days.append( new Day(day) );
+    m_days.append( m_pool.create(day) );
 }
 
 /***************************************** saveToStream ******************************************/
@@ -83,7 +83,7 @@ void  DaysModel::loadFromStream( QXmlStreamReader* stream )
 
     // if day element create new day type
     if ( stream->isStartElement() && stream->name() == "day" )
-      m_days.append( new Day(stream) );
+      m_days.append( m_pool.create(stream) );
 
     // when reached end of days data return
     if ( stream->isEndElement() && stream->name() == "days-data" ) return;
@@ -155,7 +155,7 @@ bool DaysModel::setData( const QModelIndex& index, const QVariant& value, int ro
   if ( value.toString() == data( index, role ).toString() ) return false;
 
   // set data via undo/redo command
-  plan->undostack()->push( new CommandDaySetData( index, value ) );
+  plan->push( new CommandDaySetData( index, value ) );
   return true;
 }
 
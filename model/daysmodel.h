@@ -23,6 +23,8 @@
 
 #include <QAbstractTableModel>
 
+#include "objectpool.h"
+
 class Day;
 class QXmlStreamReader;
 class QXmlStreamWriter;
@@ -45,6 +47,8 @@ public:
   Day*         day( int n );                                       // return pointer to n'th day type
   int          index( Day* d ) { return m_days.indexOf(d); }       // return index of day type, or -1
   int          number() { return m_days.size(); }                  // return number of day types in plan
+  int          created() { return m_pool.created(); }              // return number of day types ever created
+  int          blocks() { return m_pool.blocks(); }                // return number of pool blocks allocated
   QStringList  namesList() const;                                  // return list of day type names
 
   bool         nameIsDuplicate( const QString&, int );             // return if name is a repeat
@@ -72,6 +76,9 @@ signals:
 
 private:
   QList<Day*>     m_days;              // list of day types available to calendars
+  ObjectPool<Day>  m_pool;            // pool holding day type objects
+
+  static const int  POOL_BLOCK = 8;    // day types per pool block, plans usually have a handful
 
   QModelIndex     m_overrideIndex;     // with value can override model for edits in progress
   QVariant        m_overrideValue;     // with index can override model for edits in progress
@@ -0,0 +1,137 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "ganttbatch.h"
+#include "labelcache.h"
+
+#include <QPainter>
+
+/*************************************************************************************************/
+/************* Gantt drawing primitives collected by style and submitted in batches **************/
+/*************************************************************************************************/
+
+/****************************************** constructor ******************************************/
+
+GanttBatch::GanttBatch( QPainter* painter, LabelCache* labels )
+{
+  // set painter batches are submitted to, and cache of laid out label texts
+  m_painter = painter;
+  m_labels  = labels;
+}
+
+/****************************************** addPolygon *******************************************/
+
+void GanttBatch::addPolygon( Category c, const QPoint* points, int count, bool convex )
+{
+  // add polygon points to category point buffer, and its point count
+  for( int i=0 ; i<count ; i++ ) m_points[c].append( points[i] );
+  Polygon  polygon;
+  polygon.count  = count;
+  polygon.convex = convex;
+  m_polygons[c].append( polygon );
+}
+
+/******************************************** addText ********************************************/
+
+void GanttBatch::addText( int x, int y, const QString& text )
+{
+  // add label text, drawn after task shapes so not overdrawn by them
+  Text  t;
+  t.pos  = QPoint( x, y );
+  t.text = text;
+  m_texts.append( t );
+}
+
+/******************************************* setStyle ********************************************/
+
+void GanttBatch::setStyle( Category c )
+{
+  // set painter pen & brush for category
+  switch ( c )
+  {
+    case BAR_FILL:
+      m_painter->setPen( Qt::NoPen );
+      m_painter->setBrush( QColor( Qt::yellow ) );
+      break;
+    case BAR_EDGE:
+      m_painter->setPen( QColor( Qt::blue ) );
+      break;
+    case SOLID:
+      m_painter->setPen( Qt::NoPen );
+      m_painter->setBrush( Qt::black );
+      break;
+    case COVERAGE:
+      m_painter->setPen( Qt::NoPen );
+      m_painter->setBrush( QColor( Qt::blue ) );
+      break;
+    case DEADLINE:
+      m_painter->setPen( QPen( QBrush( Qt::darkGreen ), 2 ) );
+      break;
+    case LINK:
+      m_painter->setPen( Qt::darkGray );
+      break;
+    case ARROW:
+      m_painter->setPen( Qt::NoPen );
+      m_painter->setBrush( Qt::darkGray );
+      break;
+  }
+}
+
+/********************************************* submit ********************************************/
+
+void GanttBatch::submit()
+{
+  // for each category set style once then draw its batches with as few calls as possible
+  for( int c=0 ; c<=MAX_CATEGORY ; c++ )
+  {
+    // labels drawn over task shapes but under deadlines & dependencies, same layers as unbatched
+    if ( c == DEADLINE ) submitTexts();
+
+    if ( m_rects[c].isEmpty() && m_lines[c].isEmpty() && m_polygons[c].isEmpty() ) continue;
+    setStyle( Category(c) );
+
+    if ( !m_rects[c].isEmpty() ) m_painter->drawRects( m_rects[c] );
+    if ( !m_lines[c].isEmpty() ) m_painter->drawLines( m_lines[c] );
+    const QPoint*  points = m_points[c].constData();
+    foreach( const Polygon& polygon, m_polygons[c] )
+    {
+      if ( polygon.convex ) m_painter->drawConvexPolygon( points, polygon.count );
+      else                  m_painter->drawPolygon( points, polygon.count );
+      points += polygon.count;
+    }
+
+    m_rects[c].clear();
+    m_lines[c].clear();
+    m_points[c].clear();
+    m_polygons[c].clear();
+  }
+}
+
+/****************************************** submitTexts ******************************************/
+
+void GanttBatch::submitTexts()
+{
+  // draw label texts vertically centred on their points, using cached layouts
+  int  half = m_painter->fontMetrics().height() / 2;
+  m_painter->setPen( Qt::black );
+  foreach( const Text& t, m_texts )
+    m_painter->drawStaticText( t.pos.x(), t.pos.y() - half, m_labels->text( t.text, m_painter->font() ) );
+  m_texts.clear();
+}
@@ -0,0 +1,89 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef GANTTBATCH_H
+#define GANTTBATCH_H
+
+#include <QVector>
+#include <QLine>
+#include <QRect>
+#include <QPoint>
+#include <QString>
+
+class QPainter;
+class LabelCache;
+
+/*************************************************************************************************/
+/************* Gantt drawing primitives collected by style and submitted in batches **************/
+/*************************************************************************************************/
+
+class GanttBatch
+{
+public:
+  GanttBatch( QPainter*, LabelCache* );                          // constructor
+
+  enum Category                 // drawing styles, submitted in this order with labels before deadlines
+  {
+    BAR_FILL     = 0,           // task bar fill, no pen & yellow brush
+    BAR_EDGE     = 1,           // task bar edges, blue pen
+    SOLID        = 2,           // milestones & summaries, no pen & black brush
+    COVERAGE     = 3,           // zoomed out task coverage, no pen & blue brush
+    DEADLINE     = 4,           // deadline markers, thick dark green pen
+    LINK         = 5,           // dependency lines, dark gray pen
+    ARROW        = 6,           // dependency arrow heads, no pen & dark gray brush
+    MAX_CATEGORY = 6
+  };
+
+  QPainter*  painter() const { return m_painter; }               // return painter batches are submitted to
+  void       addLine( Category c, int x1, int y1, int x2, int y2 )
+               { m_lines[c].append( QLine( x1, y1, x2, y2 ) ); }  // add line to category batch
+  void       addRect( Category c, int x, int y, int w, int h )
+               { m_rects[c].append( QRect( x, y, w, h ) ); }      // add rectangle to category batch
+  void       addPolygon( Category, const QPoint*, int,
+                         bool convex = false );                  // add polygon to category batch
+  void       addText( int, int, const QString& );                // add label text left aligned at point
+  void       submit();                                           // draw and clear all batches
+
+private:
+  void       setStyle( Category );                               // set painter pen & brush for category
+  void       submitTexts();                                      // draw and clear label texts
+
+  struct Polygon
+  {
+    int      count;                    // number of points in category point buffer
+    bool     convex;                   // true if convex so can be drawn faster
+  };
+
+  struct Text
+  {
+    QPoint   pos;                      // label left & vertical centre
+    QString  text;                     // label text
+  };
+
+  QPainter*          m_painter;                      // painter batches are submitted to
+  LabelCache*        m_labels;                       // laid out label texts
+  QVector<QLine>     m_lines[MAX_CATEGORY+1];        // lines per category
+  QVector<QRect>     m_rects[MAX_CATEGORY+1];        // rectangles per category
+  QVector<QPoint>    m_points[MAX_CATEGORY+1];       // polygon points per category, one polygon after another
+  QVector<Polygon>   m_polygons[MAX_CATEGORY+1];     // polygons per category
+  QVector<Text>      m_texts;                        // label texts, drawn over shapes
+};
+
+#endif // GANTTBATCH_H
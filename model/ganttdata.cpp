@@ -22,6 +22,7 @@
 #include "plan.h"
 #include "task.h"
 #include "calendar.h"
+#include "ganttbatch.h"
 
 #include <QPainter>
 
@@ -33,6 +34,10 @@
 
 GanttData::GanttData()
 {
+  // no gantt data so nothing to stretch
+  m_start          = XDateTime::NULL_DATETIME;
+  m_stretchVersion = 0;
+  m_stretchStart   = XDateTime::NULL_DATETIME;
 }
 
 /******************************************** setTask ********************************************/
@@ -49,6 +54,7 @@ void GanttData::setTask( DateTime start, DateTime end )
     m_start    = start;
     m_end[0]   = end;
     m_value[0] = 1.0;
+    restretch();
   }
 }
 
@@ -60,6 +66,7 @@ void GanttData::setMilestone( DateTime milestone )
   m_start = milestone;
   m_end.resize(0);
   m_value.resize(0);
+  restretch();
 }
 
 /******************************************* setSummary ******************************************/
@@ -72,6 +79,45 @@ void GanttData::setSummary( DateTime start, DateTime end )
   m_value.resize(1);
   m_end[0]   = end;
   m_value[0] = -1.0;
+  restretch();
+}
+
+/****************************************** checkStretch *****************************************/
+
+void GanttData::checkStretch() const
+{
+  // restretch if plan stretch flag, default calendar or calendars changed since last stretched
+  if ( m_stretchVersion != plan->stretchVersion() ) restretch();
+}
+
+/******************************************* restretch *******************************************/
+
+void GanttData::restretch() const
+{
+  // stretch start & span ends once here so drawing only needs arithmetic
+  m_stretchVersion = plan->stretchVersion();
+  m_stretchStart   = plan->stretch( m_start );
+  m_stretchEnd.resize( m_end.size() );
+  for( int period=0 ; period<m_end.size() ; period++ )
+    m_stretchEnd[period] = plan->stretch( m_end.at(period) );
+}
+
+/***************************************** releaseStretch ****************************************/
+
+void GanttData::releaseStretch()
+{
+  // release stretched span ends, they will be recalculated when next needed
+  m_stretchVersion = 0;
+  m_stretchEnd     = QVector<DateTime>();
+}
+
+/********************************************* bytes *********************************************/
+
+int GanttData::bytes() const
+{
+  // return approx memory held by gantt data including span vectors
+  return sizeof(GanttData) + ( m_end.capacity() + m_stretchEnd.capacity() ) * sizeof(DateTime)
+                           + m_value.capacity() * sizeof(float);
 }
 
 /********************************************* start *********************************************/
@@ -96,7 +142,8 @@ DateTime GanttData::end() const
 int GanttData::startX( DateTime start, double minsPP ) const
 {
   // return task gantt row start x coordinate
-  return x( m_start, start, minsPP );
+  checkStretch();
+  return column( m_stretchStart, start, minsPP );
 }
 
 /********************************************** endX *********************************************/
@@ -104,7 +151,9 @@ int GanttData::startX( DateTime start, double minsPP ) const
 int GanttData::endX( DateTime start, double minsPP ) const
 {
   // return task gantt row end x coordinate
-  return x( end(), start, minsPP );
+  checkStretch();
+  if ( m_stretchEnd.isEmpty() ) return column( m_stretchStart, start, minsPP );
+  return column( m_stretchEnd.last(), start, minsPP );
 }
 
 /*********************************************** x ***********************************************/
@@ -112,9 +161,7 @@ int GanttData::endX( DateTime start, double minsPP ) const
 int GanttData::x( DateTime dt, DateTime start, double minsPP ) const
 {
   // return x-coord for stretched date-time given start & minspp
-  DateTime stretch = plan->stretch( dt );
-  if ( stretch > start ) return ( stretch - start ) / minsPP;
-  return ( start - stretch ) / -minsPP;
+  return column( plan->stretch( dt ), start, minsPP );
 }
 
 /***************************************** taskBarHeight *****************************************/
@@ -135,7 +182,7 @@ int GanttData::milestoneHeight( QPainter* p ) const
 
 /***************************************** verticalArrow *****************************************/
 
-void GanttData::verticalArrow( QPainter* p, int x, int y, int size )
+void GanttData::verticalArrow( GanttBatch* b, int x, int y, int size )
 {
   // draw vertical arrow for dependency links
   if ( size < 0 ) y++;
@@ -145,14 +192,12 @@ void GanttData::verticalArrow( QPainter* p, int x, int y, int size )
   points[1] = QPoint( x-size, y-size );
   points[2] = QPoint( x+size, y-size );
 
-  p->setPen( Qt::NoPen );
-  p->setBrush( Qt::darkGray );
-  p->drawConvexPolygon( points, 3 );
+  b->addPolygon( GanttBatch::ARROW, points, 3, true );
 }
 
 /**************************************** horizontalArrow ****************************************/
 
-void GanttData::horizontalArrow( QPainter* p, int x, int y, int size )
+void GanttData::horizontalArrow( GanttBatch* b, int x, int y, int size )
 {
   // draw horizontal arrow for dependency links
   QPoint points[3];
@@ -161,101 +206,95 @@ void GanttData::horizontalArrow( QPainter* p, int x, int y, int size )
   points[1] = QPoint( x-size, y-size+1 );
   points[2] = QPoint( x-size, y+size );
 
-  p->setPen( Qt::NoPen );
-  p->setBrush( Qt::darkGray );
-  p->drawConvexPolygon( points, 3 );
+  b->addPolygon( GanttBatch::ARROW, points, 3, true );
 }
 
 /**************************************** drawDependencyFS ***************************************/
 
-void GanttData::drawDependencyFS( QPainter* p, int thisY, int otherY, int num,
+void GanttData::drawDependencyFS( GanttBatch* b, int thisY, int otherY, int num,
                                   DateTime start, double minsPP )
 {
   // draw dependency FINISH_START line on gantt
   int  otherX = plan->task(num)->ganttData()->endX( start, minsPP );
   int  thisX  = startX( start, minsPP );
   int  signY  = thisY > otherY ? 1 : -1;
-  int  mileX  = milestoneHeight( p ) / 2;
+  int  mileX  = milestoneHeight( b->painter() ) / 2;
   int  arrow  = 4 * mileX / 5;
-  int  taskY  = signY*( taskBarHeight( p ) / 2 + arrow );
+  int  taskY  = signY*( taskBarHeight( b->painter() ) / 2 + arrow );
 
   // if other task is milestone adjust for milestone size
   if ( plan->task(num)->isMilestone() ) otherX += mileX;
 
   int  lineX  = thisX > otherX+3 ? thisX : otherX+3;
 
-  p->setPen( Qt::darkGray );
-
   if ( thisX >= otherX )
   {
-    p->drawLine( otherX+1, otherY      , lineX-1, otherY );
-    p->drawLine( lineX   , otherY+signY, lineX  , thisY-taskY );
-    verticalArrow( p, lineX, thisY-taskY+signY*arrow, signY*arrow );
+    b->addLine( GanttBatch::LINK, otherX+1, otherY      , lineX-1, otherY );
+    b->addLine( GanttBatch::LINK, lineX   , otherY+signY, lineX  , thisY-taskY );
+    verticalArrow( b, lineX, thisY-taskY+signY*arrow, signY*arrow );
   }
   else // if ( thisX < otherX )
   {
     // if this task is milestone adjust for milestone size
     if ( m_value.isEmpty() ) thisX -= mileX;
 
-    p->drawLine( otherX+1, otherY,      otherX+2, otherY );
-    p->drawLine( otherX+3, otherY+signY, otherX+3, otherY+taskY-signY );
-    p->drawLine( otherX+2, otherY+taskY, thisX-6, otherY+taskY );
-    p->drawLine( thisX-7, otherY+taskY+signY, thisX-7, thisY-signY );
-    p->drawLine( thisX-6, thisY, thisX-2, thisY );
-    horizontalArrow( p, thisX, thisY, arrow );
+    b->addLine( GanttBatch::LINK, otherX+1, otherY,      otherX+2, otherY );
+    b->addLine( GanttBatch::LINK, otherX+3, otherY+signY, otherX+3, otherY+taskY-signY );
+    b->addLine( GanttBatch::LINK, otherX+2, otherY+taskY, thisX-6, otherY+taskY );
+    b->addLine( GanttBatch::LINK, thisX-7, otherY+taskY+signY, thisX-7, thisY-signY );
+    b->addLine( GanttBatch::LINK, thisX-6, thisY, thisX-2, thisY );
+    horizontalArrow( b, thisX, thisY, arrow );
   }
 }
 
 /**************************************** drawDependencySF ***************************************/
 
-void GanttData::drawDependencySF( QPainter* p, int thisY, int otherY, int num,
+void GanttData::drawDependencySF( GanttBatch* b, int thisY, int otherY, int num,
                                   DateTime start, double minsPP )
 {
   // draw dependency START_FINISH line on gantt
   int  otherX = plan->task(num)->ganttData()->startX( start, minsPP );
   int  thisX  = endX( start, minsPP );
   int  signY  = thisY > otherY ? 1 : -1;
-  int  mileX  = milestoneHeight( p ) / 2;
+  int  mileX  = milestoneHeight( b->painter() ) / 2;
   int  arrow  = 4 * mileX / 5;
-  int  taskY  = signY*( taskBarHeight( p ) / 2 + arrow );
+  int  taskY  = signY*( taskBarHeight( b->painter() ) / 2 + arrow );
 
   // if other task is milestone adjust for milestone size
   if ( plan->task(num)->isMilestone() ) otherX += mileX;
 
   int  lineX  = thisX < otherX-3 ? thisX : otherX-3;
 
-  p->setPen( Qt::darkGray );
-
   if ( thisX <= otherX )
   {
-    p->drawLine( otherX-1, otherY      , lineX+1, otherY );
-    p->drawLine( lineX   , otherY+signY, lineX  , thisY-taskY );
-    verticalArrow( p, lineX, thisY-taskY+signY*arrow, signY*arrow );
+    b->addLine( GanttBatch::LINK, otherX-1, otherY      , lineX+1, otherY );
+    b->addLine( GanttBatch::LINK, lineX   , otherY+signY, lineX  , thisY-taskY );
+    verticalArrow( b, lineX, thisY-taskY+signY*arrow, signY*arrow );
   }
   else // if ( thisX > otherX )
   {
     // if this task is milestone adjust for milestone size
     if ( m_value.isEmpty() ) thisX -= mileX;
 
-    p->drawLine( otherX-1, otherY,      otherX-2, otherY );
-    p->drawLine( otherX-3, otherY+signY, otherX-3, otherY+taskY-signY );
-    p->drawLine( otherX-2, otherY+taskY, thisX+arrow+2, otherY+taskY );
-    p->drawLine( thisX+arrow+3, otherY+taskY+signY, thisX+arrow+3, thisY-signY );
-    p->drawLine( thisX+arrow+2, thisY, thisX+arrow, thisY );
-    horizontalArrow( p, thisX+1, thisY, -arrow );
+    b->addLine( GanttBatch::LINK, otherX-1, otherY,      otherX-2, otherY );
+    b->addLine( GanttBatch::LINK, otherX-3, otherY+signY, otherX-3, otherY+taskY-signY );
+    b->addLine( GanttBatch::LINK, otherX-2, otherY+taskY, thisX+arrow+2, otherY+taskY );
+    b->addLine( GanttBatch::LINK, thisX+arrow+3, otherY+taskY+signY, thisX+arrow+3, thisY-signY );
+    b->addLine( GanttBatch::LINK, thisX+arrow+2, thisY, thisX+arrow, thisY );
+    horizontalArrow( b, thisX+1, thisY, -arrow );
   }
 }
 
 /**************************************** drawDependencySS ***************************************/
 
-void GanttData::drawDependencySS( QPainter* p, int thisY, int otherY, int num,
+void GanttData::drawDependencySS( GanttBatch* b, int thisY, int otherY, int num,
                                   DateTime start, double minsPP )
 {
   // draw dependency START_START line on gantt
   int  otherX = plan->task( num )->ganttData()->startX( start, minsPP );
   int  thisX  = startX( start, minsPP );
   int  signY  = thisY > otherY ? 1 : -1;
-  int  mileX  = milestoneHeight( p ) / 2;
+  int  mileX  = milestoneHeight( b->painter() ) / 2;
   int  arrow  = 4 * mileX / 5;
 
   // if other task is milestone adjust for milestone size
@@ -266,23 +305,22 @@ void GanttData::drawDependencySS( QPainter* p, int thisY, int otherY, int num,
 
   int  lineX  = thisX-3-arrow < otherX-4 ? thisX-3-arrow : otherX-4;
 
-  p->setPen( Qt::darkGray );
-  p->drawLine( otherX-1, otherY,       lineX+1, otherY );
-  p->drawLine( lineX   , otherY+signY, lineX  , thisY-signY );
-  p->drawLine( thisX-3 , thisY,        lineX+1, thisY );
-  horizontalArrow( p, thisX, thisY, arrow );
+  b->addLine( GanttBatch::LINK, otherX-1, otherY,       lineX+1, otherY );
+  b->addLine( GanttBatch::LINK, lineX   , otherY+signY, lineX  , thisY-signY );
+  b->addLine( GanttBatch::LINK, thisX-3 , thisY,        lineX+1, thisY );
+  horizontalArrow( b, thisX, thisY, arrow );
 }
 
 /**************************************** drawDependencyFF ***************************************/
 
-void GanttData::drawDependencyFF( QPainter* p, int thisY, int otherY, int num,
+void GanttData::drawDependencyFF( GanttBatch* b, int thisY, int otherY, int num,
                                   DateTime start, double minsPP )
 {
   // draw dependency FINISH_FINISH line on gantt
   int  otherX = plan->task( num )->ganttData()->endX( start, minsPP );
   int  thisX  = endX( start, minsPP );
   int  signY  = thisY > otherY ? 1 : -1;
-  int  mileX  = milestoneHeight( p ) / 2;
+  int  mileX  = milestoneHeight( b->painter() ) / 2;
   int  arrow  = 4 * mileX / 5;
 
   // if other task is milestone adjust for milestone size
@@ -293,42 +331,45 @@ void GanttData::drawDependencyFF( QPainter* p, int thisY, int otherY, int num,
 
   int  lineX  = thisX+3+arrow > otherX+4 ? thisX+3+arrow : otherX+4;
 
-  p->setPen( Qt::darkGray );
-  p->drawLine( otherX+1, otherY,       lineX-1, otherY );
-  p->drawLine( lineX   , otherY+signY, lineX  , thisY-signY );
-  p->drawLine( thisX+3 , thisY,        lineX-1, thisY );
-  horizontalArrow( p, thisX+1, thisY, -arrow );
+  b->addLine( GanttBatch::LINK, otherX+1, otherY,       lineX-1, otherY );
+  b->addLine( GanttBatch::LINK, lineX   , otherY+signY, lineX  , thisY-signY );
+  b->addLine( GanttBatch::LINK, thisX+3 , thisY,        lineX-1, thisY );
+  horizontalArrow( b, thisX+1, thisY, -arrow );
 }
 
 /******************************************** drawTask *******************************************/
 
-void GanttData::drawTask( QPainter* p, int y, DateTime start, double minsPP, QString label )
+void GanttData::drawTask( GanttBatch* b, int y, DateTime start, double minsPP, QString label )
 {
   // if gantt data start date-time is not valid do not draw anything
   if ( m_start == XDateTime::NULL_DATETIME ) return;
 
   // if no data then draw milestone, otherwise summary or task bar
-  if ( m_value.isEmpty() )     drawMilestone( p, y, start, minsPP );
-  else if ( m_value[0] < 0.0 ) drawSummary( p, y, start, minsPP );
-  else                         drawTaskBar( p, y, start, minsPP );
+  if ( m_value.isEmpty() )     drawMilestone( b, y, start, minsPP );
+  else if ( m_value[0] < 0.0 ) drawSummary( b, y, start, minsPP );
+  else                         drawTaskBar( b, y, start, minsPP );
 
   // add label to end
-  if ( !label.isEmpty() )
-  {
-    int x     = endX( start, minsPP );
-    int flags = Qt::AlignLeft + Qt::AlignVCenter + Qt::TextSingleLine + Qt::TextDontClip;
-    p->setPen( Qt::black );
-    p->drawText( x, y-1, 0, 0, flags, "   "+label );
-  }
+  drawLabel( b, y, start, minsPP, label );
+}
+
+/******************************************* drawLabel *******************************************/
+
+void GanttData::drawLabel( GanttBatch* b, int y, DateTime start, double minsPP, QString label )
+{
+  // draw label after end of task
+  if ( label.isEmpty() ) return;
+  int x     = endX( start, minsPP );
+  b->addText( x, y-1, "   "+label );
 }
 
 /***************************************** drawMilestone *****************************************/
 
-void GanttData::drawMilestone( QPainter* p, int y, DateTime start, double minsPP )
+void GanttData::drawMilestone( GanttBatch* b, int y, DateTime start, double minsPP )
 {
   // calc x position of milestone & height
   int x = startX( start, minsPP );
-  int h = milestoneHeight( p ) / 2;
+  int h = milestoneHeight( b->painter() ) / 2;
 
   // populate points array to draw the milestone
   QPoint points[4];
@@ -338,19 +379,17 @@ void GanttData::drawMilestone( QPainter* p, int y, DateTime start, double minsPP
   points[3] = QPoint( x-h,   y   );
 
   // draw the milestone
-  p->setPen( Qt::NoPen );
-  p->setBrush( Qt::black );
-  p->drawConvexPolygon( points, 4 );
+  b->addPolygon( GanttBatch::SOLID, points, 4, true );
 }
 
 /******************************************* drawSummary *****************************************/
 
-void GanttData::drawSummary( QPainter* p, int y, DateTime start, double minsPP )
+void GanttData::drawSummary( GanttBatch* b, int y, DateTime start, double minsPP )
 {
   // calc x positions of summary & height
   int xs = startX( start, minsPP );
   int xe = endX( start, minsPP );
-  int h  = milestoneHeight( p ) / 2;
+  int h  = milestoneHeight( b->painter() ) / 2;
   int w  = h;
   if ( w > xe - xs ) w = xe - xs;
 
@@ -364,47 +403,41 @@ void GanttData::drawSummary( QPainter* p, int y, DateTime start, double minsPP )
   points[5] = QPoint( xe-w, y   );
 
   // draw the milestone
-  p->setPen( Qt::NoPen );
-  p->setBrush( Qt::black );
-  p->drawPolygon( points, 6 );
-  p->drawPolygon( points, 3 );
+  b->addPolygon( GanttBatch::SOLID, points, 6 );
+  b->addPolygon( GanttBatch::SOLID, points, 3 );
 }
 
 /******************************************* drawTaskBar *****************************************/
 
-void GanttData::drawTaskBar( QPainter* p, int ty, DateTime start, double minsPP )
+void GanttData::drawTaskBar( GanttBatch* b, int ty, DateTime start, double minsPP )
 {
   // determine scale to draw offset
   float scale = 0.0;
   for( int period=0 ; period<m_value.size() ; period++ )
     if ( m_value[period] > scale ) scale = m_value[period];
-  scale *= taskBarHeight( p ) / 2;
-
-  // set pen and fill colours
-  p->setPen( QColor( Qt::blue ) );
-  QBrush fill = QColor( Qt::yellow );
+  scale *= taskBarHeight( b->painter() ) / 2;
 
   // calc start position of task bar
   int tx     = startX( start, minsPP );
   int offset = int( m_value[0] * scale );
 
   // draw front edge
-  p->drawLine( tx, ty+offset, tx, ty-offset );
+  b->addLine( GanttBatch::BAR_EDGE, tx, ty+offset, tx, ty-offset );
 
   // for each period within task bar draw next section
   int newX, newOffset;
   for( int period=1 ; period<m_value.size() ; period++ )
   {
-    newX      = x( m_end[period-1], start, minsPP );
+    newX      = column( m_stretchEnd[period-1], start, minsPP );
     newOffset = int( m_value[period] * scale );
     if ( offset > 0 && newX > tx )
     {
-      p->fillRect( tx+1, ty-offset+1, newX-tx, offset+offset-1, fill );
-      p->drawLine( tx, ty+offset, newX, ty+offset );
+      b->addRect( GanttBatch::BAR_FILL, tx+1, ty-offset+1, newX-tx, offset+offset-1 );
+      b->addLine( GanttBatch::BAR_EDGE, tx, ty+offset, newX, ty+offset );
     }
-    p->drawLine( tx, ty-offset, newX, ty-offset );
-    p->drawLine( newX, ty+offset, newX, ty+newOffset );
-    p->drawLine( newX, ty-offset, newX, ty-newOffset );
+    b->addLine( GanttBatch::BAR_EDGE, tx, ty-offset, newX, ty-offset );
+    b->addLine( GanttBatch::BAR_EDGE, newX, ty+offset, newX, ty+newOffset );
+    b->addLine( GanttBatch::BAR_EDGE, newX, ty-offset, newX, ty-newOffset );
 
     tx     = newX;
     offset = newOffset;
@@ -414,9 +447,9 @@ void GanttData::drawTaskBar( QPainter* p, int ty, DateTime start, double minsPP
   newX = endX( start, minsPP );
   if ( offset > 0 && newX > tx )
   {
-    p->fillRect( tx+1, ty-offset+1, newX-tx-1, offset+offset-1, fill );
-    p->drawLine( tx, ty+offset, newX, ty+offset );
-    p->drawLine( newX, ty+offset, newX, ty-offset );
+    b->addRect( GanttBatch::BAR_FILL, tx+1, ty-offset+1, newX-tx-1, offset+offset-1 );
+    b->addLine( GanttBatch::BAR_EDGE, tx, ty+offset, newX, ty+offset );
+    b->addLine( GanttBatch::BAR_EDGE, newX, ty+offset, newX, ty-offset );
   }
-  p->drawLine( tx, ty-offset, newX, ty-offset );
+  b->addLine( GanttBatch::BAR_EDGE, tx, ty-offset, newX, ty-offset );
 }
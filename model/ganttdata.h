@@ -26,6 +26,7 @@
 #include "datetime.h"
 
 class QPainter;
+class GanttBatch;
 
 /*************************************************************************************************/
 /************************** Data to support the drawing of a gantt task **************************/
@@ -47,27 +48,40 @@ public:
   int         x( DateTime, DateTime, double ) const;     // return x-coord for dt given start & minspp
   int         taskBarHeight( QPainter* ) const;          // max height of task on gantt
   int         milestoneHeight( QPainter* ) const;        // max height of milestones on gantt
+  int         bytes() const;                             // return approx memory held by gantt data
+  void        releaseStretch();                          // release stretched values until next needed
 
-  void        drawTask( QPainter*, int, DateTime, double, QString );  // draw task data on gantt
-  void        drawTaskBar( QPainter*, int, DateTime, double );        // draw task bar on gantt
-  void        drawMilestone( QPainter*, int, DateTime, double );      // draw milestone on gantt
-  void        drawSummary( QPainter*, int, DateTime, double );        // draw milestone on gantt
-  void        verticalArrow( QPainter*, int, int, int );              // draw vertical arrow for dependency links
-  void        horizontalArrow( QPainter*, int, int, int );            // draw horizontal arrow for dependency links
+  void        drawTask( GanttBatch*, int, DateTime, double, QString ); // draw task data on gantt
+  void        drawLabel( GanttBatch*, int, DateTime, double, QString ); // draw task label on gantt
+  void        drawTaskBar( GanttBatch*, int, DateTime, double );      // draw task bar on gantt
+  void        drawMilestone( GanttBatch*, int, DateTime, double );    // draw milestone on gantt
+  void        drawSummary( GanttBatch*, int, DateTime, double );      // draw milestone on gantt
+  void        verticalArrow( GanttBatch*, int, int, int );            // draw vertical arrow for dependency links
+  void        horizontalArrow( GanttBatch*, int, int, int );          // draw horizontal arrow for dependency links
 
-  void        drawDependencyFS( QPainter*, int, int, int,
+  void        drawDependencyFS( GanttBatch*, int, int, int,
                                 DateTime, double );      // draw dependency FINISH_START line on gantt
-  void        drawDependencySF( QPainter*, int, int, int,
+  void        drawDependencySF( GanttBatch*, int, int, int,
                                 DateTime, double );      // draw dependency START_FINISH line on gantt
-  void        drawDependencySS( QPainter*, int, int, int,
+  void        drawDependencySS( GanttBatch*, int, int, int,
                                 DateTime, double );      // draw dependency START_START line on gantt
-  void        drawDependencyFF( QPainter*, int, int, int,
+  void        drawDependencyFF( GanttBatch*, int, int, int,
                                 DateTime, double );      // draw dependency FINISH_FINISH line on gantt
 
 private:
+  void        restretch() const;                         // recalculate stretched start & span ends
+  void        checkStretch() const;                      // restretch if plan stretching has changed
+  static int  column( DateTime dt, DateTime start, double minsPP )
+    { return dt > start ? int( ( dt - start ) / minsPP )
+                        : int( ( start - dt ) / -minsPP ); } // return x-coord for already stretched dt
+
   DateTime             m_start;    // start of gantt task
   QVector<DateTime>    m_end;      // span end
   QVector<float>       m_value;    // span value (-ve for summaries, +ve for tasks)
+
+  mutable quint32            m_stretchVersion;  // plan stretch version when stretched values calculated
+  mutable DateTime           m_stretchStart;    // stretched start of gantt task
+  mutable QVector<DateTime>  m_stretchEnd;      // stretched span ends
 };
 
 #endif // GANTTDATA_H
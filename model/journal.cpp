@@ -0,0 +1,419 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "journal.h"
+#include "plan.h"
+#include "tasksmodel.h"
+#include "resourcesmodel.h"
+#include "calendarsmodel.h"
+#include "daysmodel.h"
+
+#include "command/commandtasksetdata.h"
+#include "command/commandresourcesetdata.h"
+#include "command/commandcalendarsetdata.h"
+#include "command/commanddaysetdata.h"
+#include "command/commandtaskindent.h"
+#include "command/commandtaskoutdent.h"
+#include "command/commandtaskpaste.h"
+#include "command/commandpropertieschange.h"
+
+#include <QDataStream>
+#include <QUndoStack>
+#include <QDir>
+#include <QLockFile>
+#include <QCoreApplication>
+
+/*************************************************************************************************/
+/********** Append-only journal of plan edits since last full save, for crash recovery ***********/
+/*************************************************************************************************/
+
+/****************************************** constructor ******************************************/
+
+Journal::Journal()
+{
+  // not journalling until started
+  m_records = 0;
+}
+
+/******************************************** filename *******************************************/
+
+QString  Journal::filename( const QString& planFile )
+{
+  // return journal filename alongside plan file, or in temp directory if plan not yet saved
+  if ( planFile.isEmpty() ) return untitledName( "journal" );
+  return planFile + ".journal";
+}
+
+/****************************************** snapshotName *****************************************/
+
+QString  Journal::snapshotName( const QString& planFile )
+{
+  // return autosave snapshot filename alongside plan file, or in temp directory if not yet saved
+  if ( planFile.isEmpty() ) return untitledName( "autosave" );
+  return planFile + ".autosave";
+}
+
+/****************************************** untitledName *****************************************/
+
+QString  Journal::untitledName( const QString& suffix, qint64 session )
+{
+  // return file for untitled plan in temp directory, named by process so sessions don't share
+  if ( session == 0 ) session = QCoreApplication::applicationPid();
+  return QDir::temp().filePath( QString("projectplanner-untitled-%1.%2").arg( session ).arg( suffix ) );
+}
+
+/**************************************** orphanedSession ****************************************/
+
+qint64  Journal::orphanedSession()
+{
+  // lock this session for as long as process runs, so its untitled journal is not taken by another
+  static QLockFile  session( untitledName( "lock" ) );
+  session.setStaleLockTime( 0 );
+  session.tryLock( 0 );
+
+  // return most recent other session that left an untitled journal and whose process has ended
+  QStringList  journals = QDir::temp().entryList( QStringList( "projectplanner-untitled-*.journal" ),
+                                                  QDir::Files, QDir::Time );
+  foreach( const QString& name, journals )
+  {
+    qint64  other = name.section( '-', 2 ).section( '.', 0, 0 ).toLongLong();
+    if ( other <= 0 || other == QCoreApplication::applicationPid() ) continue;
+
+    // lock of ended session is stale so can be taken, and is removed when released
+    QLockFile  lock( untitledName( "lock", other ) );
+    lock.setStaleLockTime( 0 );
+    if ( lock.tryLock( 0 ) ) return other;
+  }
+  return 0;
+}
+
+/********************************************* adopt *********************************************/
+
+bool  Journal::adopt( qint64 session )
+{
+  // rename untitled journal & any snapshot of ended session to this session's, replacing any old
+  remove( QString() );
+  if ( !QFile::rename( untitledName( "journal", session ), untitledName( "journal" ) ) ) return false;
+  QFile::rename( untitledName( "autosave", session ), untitledName( "autosave" ) );
+
+  // if journal based on the renamed snapshot, restart it on new name keeping all its records
+  QString  base, baseWhen;
+  Journal  journal;
+  journal.m_file.setFileName( untitledName( "journal" ) );
+  if ( !journal.m_file.open( QIODevice::ReadOnly ) ) return false;
+  QDataStream  in( &journal.m_file );
+  in.setVersion( QDataStream::Qt_5_3 );
+  quint32  magic;
+  qint32   version;
+  in >> magic >> version >> base >> baseWhen;
+  qint64  records = journal.m_file.pos();
+  journal.m_file.close();
+  if ( in.status() != QDataStream::Ok || magic != MAGIC || version != VERSION ) return false;
+  if ( base != untitledName( "autosave", session ) ) return true;
+
+  QString  journalFile = untitledName( "journal" );
+  bool     ok = journal.rebase( journalFile, untitledName( "autosave" ), baseWhen, records );
+  journal.stop();
+  return ok;
+}
+
+/********************************************* remove ********************************************/
+
+void  Journal::remove( const QString& planFile )
+{
+  // remove journal & snapshot when edits have been saved or deliberately discarded
+  QFile::remove( filename( planFile ) );
+  QFile::remove( snapshotName( planFile ) );
+}
+
+/********************************************* start *********************************************/
+
+bool  Journal::start( const QString& journalFile, const QString& base, const QString& baseWhen )
+{
+  // start new journal replacing any old, header records base file & when it was saved
+  stop();
+  m_records = 0;
+  m_file.setFileName( journalFile );
+  if ( !m_file.open( QIODevice::WriteOnly | QIODevice::Truncate ) ) return false;
+
+  QByteArray   header;
+  QDataStream  out( &header, QIODevice::WriteOnly );
+  out.setVersion( QDataStream::Qt_5_3 );
+  out << MAGIC << VERSION << base << baseWhen;
+  m_file.write( header );
+  m_file.flush();
+  return true;
+}
+
+/********************************************* rebase ********************************************/
+
+bool  Journal::rebase( const QString& journalFile, const QString& base, const QString& baseWhen,
+                       qint64 from )
+{
+  // read records appended after position, which are edits not included in new base
+  QFile    old( m_file.fileName() );
+  QByteArray  tail;
+  if ( old.open( QIODevice::ReadOnly ) && old.seek( from ) ) tail = old.readAll();
+  old.close();
+
+  // restart journal (renamed if plan file renamed) on new base then append those records again,
+  // with any torn record dropped
+  if ( !start( journalFile, base, baseWhen ) ) return false;
+  int  pos = 0;
+  while ( pos + int( sizeof(quint32) ) <= tail.size() )
+  {
+    quint32      length;
+    QDataStream  in( tail.mid( pos, sizeof(quint32) ) );
+    in >> length;
+    pos += sizeof(quint32);
+    if ( length > quint32( tail.size() - pos ) ) break;
+    write( tail.mid( pos, length ) );
+    pos += length;
+  }
+  return true;
+}
+
+/********************************************** stop *********************************************/
+
+void  Journal::stop()
+{
+  // close journal file, which is kept for recovery unless removed
+  if ( m_file.isOpen() ) m_file.close();
+}
+
+/********************************************* write *********************************************/
+
+void  Journal::write( const QByteArray& record )
+{
+  // append length prefixed record and flush, so a record torn by a crash is detected and ignored
+  if ( !m_file.isOpen() ) return;
+  QByteArray   length;
+  QDataStream  out( &length, QIODevice::WriteOnly );
+  out << quint32( record.size() );
+  m_file.write( length + record );
+  m_file.flush();
+  m_records++;
+}
+
+/******************************************* writePush *******************************************/
+
+void  Journal::writePush( const UndoCommand* command )
+{
+  // append record with command type, when it was created, and its arguments
+  if ( !m_file.isOpen() || command->journalType() == UndoCommand::JOURNAL_NONE ) return;
+  QByteArray   record;
+  QDataStream  out( &record, QIODevice::WriteOnly );
+  out.setVersion( QDataStream::Qt_5_3 );
+  out << quint8( RECORD_PUSH ) << command->when() << quint8( command->journalType() );
+  command->writeJournal( out );
+  write( record );
+}
+
+/******************************************* writeUndo *******************************************/
+
+void  Journal::writeUndo( int count )
+{
+  // append record of number of commands undone
+  QByteArray   record;
+  QDataStream  out( &record, QIODevice::WriteOnly );
+  out << quint8( RECORD_UNDO ) << qint32( count );
+  write( record );
+}
+
+/******************************************* writeRedo *******************************************/
+
+void  Journal::writeRedo( int count )
+{
+  // append record of number of commands redone
+  QByteArray   record;
+  QDataStream  out( &record, QIODevice::WriteOnly );
+  out << quint8( RECORD_REDO ) << qint32( count );
+  write( record );
+}
+
+/**************************************** writeBeginBatch ****************************************/
+
+void  Journal::writeBeginBatch( const QString& text )
+{
+  // append record of batch started, commands until batch ended are part of it
+  QByteArray   record;
+  QDataStream  out( &record, QIODevice::WriteOnly );
+  out.setVersion( QDataStream::Qt_5_3 );
+  out << quint8( RECORD_BEGIN_BATCH ) << text;
+  write( record );
+}
+
+/***************************************** writeEndBatch *****************************************/
+
+void  Journal::writeEndBatch()
+{
+  // append record of batch ended
+  QByteArray   record;
+  QDataStream  out( &record, QIODevice::WriteOnly );
+  out << quint8( RECORD_END_BATCH );
+  write( record );
+}
+
+/******************************************** readBase *******************************************/
+
+bool  Journal::readBase( const QString& journalFile, QString& base, QString& baseWhen )
+{
+  // read journal header, returning false if no journal, not recognised, or nothing to recover
+  QFile  file( journalFile );
+  if ( !file.open( QIODevice::ReadOnly ) ) return false;
+
+  QDataStream  in( &file );
+  in.setVersion( QDataStream::Qt_5_3 );
+  quint32  magic;
+  qint32   version;
+  in >> magic >> version >> base >> baseWhen;
+  return in.status() == QDataStream::Ok && magic == MAGIC && version == VERSION && !in.atEnd();
+}
+
+/********************************************* replay ********************************************/
+
+int  Journal::replay( const QString& journalFile )
+{
+  // replay journal records onto plan which must already be loaded from journal base
+  QFile  file( journalFile );
+  if ( !file.open( QIODevice::ReadOnly ) ) return 0;
+
+  QDataStream  in( &file );
+  in.setVersion( QDataStream::Qt_5_3 );
+  quint32  magic;
+  qint32   version;
+  QString  base, baseWhen;
+  in >> magic >> version >> base >> baseWhen;
+  if ( in.status() != QDataStream::Ok || magic != MAGIC || version != VERSION ) return 0;
+
+  int  count = 0;
+  int  batches = 0;
+  while ( !in.atEnd() )
+  {
+    // stop at any record torn by a crash while being written
+    quint32  length;
+    in >> length;
+    QByteArray  record = file.read( length );
+    if ( in.status() != QDataStream::Ok || record.size() != int( length ) ) break;
+
+    QDataStream  rec( record );
+    rec.setVersion( QDataStream::Qt_5_3 );
+    quint8  type;
+    rec >> type;
+
+    if ( type == RECORD_PUSH )
+    {
+      qint64  when;
+      quint8  commandType;
+      rec >> when >> commandType;
+      UndoCommand*  command = readCommand( commandType, rec );
+      if ( command == nullptr ) break;
+      command->setWhen( when );
+      plan->push( command );
+    }
+
+    if ( type == RECORD_UNDO || type == RECORD_REDO )
+    {
+      qint32  n;
+      rec >> n;
+      for( int c = 0 ; c < n ; c++ )
+        if ( type == RECORD_UNDO ) plan->undostack()->undo();
+        else                       plan->undostack()->redo();
+    }
+
+    if ( type == RECORD_BEGIN_BATCH )
+    {
+      QString  text;
+      rec >> text;
+      plan->beginBatch( text );
+      batches++;
+    }
+
+    if ( type == RECORD_END_BATCH && batches > 0 )
+    {
+      plan->endBatch();
+      batches--;
+    }
+
+    count++;
+  }
+
+  // close any batch whose end was lost
+  while ( batches-- > 0 ) plan->endBatch();
+  return count;
+}
+
+/****************************************** readCommand ******************************************/
+
+UndoCommand*  Journal::readCommand( int type, QDataStream& in )
+{
+  // create command from journal arguments, or nullptr if not recognised
+  qint32    row, column;
+  QVariant  value;
+
+  switch ( type )
+  {
+    case UndoCommand::JOURNAL_TASK_SETDATA:
+      in >> row >> column >> value;
+      return new CommandTaskSetData( plan->tasks()->QAbstractTableModel::index( row, column ), value );
+
+    case UndoCommand::JOURNAL_RESOURCE_SETDATA:
+      in >> row >> column >> value;
+      return new CommandResourceSetData( plan->resources()->QAbstractTableModel::index( row, column ), value );
+
+    case UndoCommand::JOURNAL_CALENDAR_SETDATA:
+      in >> row >> column >> value;
+      return new CommandCalendarSetData( plan->calendars()->QAbstractTableModel::index( row, column ), value );
+
+    case UndoCommand::JOURNAL_DAY_SETDATA:
+      in >> row >> column >> value;
+      return new CommandDaySetData( plan->days()->QAbstractTableModel::index( row, column ), value );
+
+    case UndoCommand::JOURNAL_TASK_INDENT:
+    case UndoCommand::JOURNAL_TASK_OUTDENT:
+    {
+      QSet<int>  rows;
+      in >> rows;
+      if ( type == UndoCommand::JOURNAL_TASK_INDENT ) return new CommandTaskIndent( rows );
+      return new CommandTaskOutdent( rows );
+    }
+
+    case UndoCommand::JOURNAL_TASK_PASTE:
+    {
+      QVector< QVector<QVariant> >  values;
+      qint32                        newRows;
+      in >> row >> column >> values >> newRows;
+      return new CommandTaskPaste( row, column, values, newRows );
+    }
+
+    case UndoCommand::JOURNAL_PROPERTIES:
+    {
+      QString   title_new, title_old, dtf_new, dtf_old, notes_new, notes_old;
+      DateTime  start_new, start_old;
+      qint32    cal_new, cal_old;
+      in >> title_new >> title_old >> start_new >> start_old >> cal_new >> cal_old
+         >> dtf_new >> dtf_old >> notes_new >> notes_old;
+      return new CommandPropertiesChange( title_new, title_old, start_new, start_old,
+                                          cal_new, cal_old, dtf_new, dtf_old, notes_new, notes_old );
+    }
+  }
+
+  return nullptr;
+}
@@ -0,0 +1,81 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <QFile>
+#include <QString>
+
+class UndoCommand;
+class QDataStream;
+
+/*************************************************************************************************/
+/********** Append-only journal of plan edits since last full save, for crash recovery ***********/
+/*************************************************************************************************/
+
+class Journal
+{
+public:
+  Journal();                                                   // constructor
+
+  static QString  filename( const QString& );                  // return journal filename for plan file
+  static QString  snapshotName( const QString& );              // return autosave snapshot filename for plan file
+  static qint64   orphanedSession();                           // return ended session with untitled journal, or 0
+  static bool     adopt( qint64 );                             // take over untitled journal & snapshot of session
+  static bool     readBase( const QString&, QString&, QString& );  // read journal base file & when, false if no records
+  static int      replay( const QString& );                    // replay journal onto plan, return records replayed
+  static void     remove( const QString& );                    // remove journal & snapshot for plan file
+
+  bool      start( const QString&, const QString&, const QString& );  // start new journal on base file & when
+  bool      rebase( const QString&, const QString&, const QString&, qint64 );  // restart on new base keeping later records
+  void      stop();                                            // stop journalling, keeping journal file
+  bool      isOpen() const { return m_file.isOpen(); }         // return true if journalling
+  int       records() const { return m_records; }              // return number of records since started
+  qint64    position() const { return m_file.pos(); }          // return byte position after last record
+
+  void      writePush( const UndoCommand* );                   // append command pushed record
+  void      writeUndo( int );                                  // append commands undone record
+  void      writeRedo( int );                                  // append commands redone record
+  void      writeBeginBatch( const QString& );                 // append batch started record
+  void      writeEndBatch();                                   // append batch ended record
+
+  static const quint32  MAGIC   = 0x504A4E4C;                  // journal file identifier 'PJNL'
+  static const qint32   VERSION = 1;                           // journal format version
+
+  enum RecordTypes
+  {
+    RECORD_PUSH        = 1,
+    RECORD_UNDO        = 2,
+    RECORD_REDO        = 3,
+    RECORD_BEGIN_BATCH = 4,
+    RECORD_END_BATCH   = 5
+  };
+
+private:
+  static QString  untitledName( const QString&, qint64 = 0 );  // return untitled plan file for session in temp directory
+  void      write( const QByteArray& );                        // append length prefixed record and flush
+  static UndoCommand*  readCommand( int, QDataStream& );       // create command from journal arguments
+
+  QFile     m_file;             // journal file being appended to
+  int       m_records;          // number of records appended since started
+};
+
+#endif // JOURNAL_H
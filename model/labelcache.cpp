@@ -0,0 +1,56 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "labelcache.h"
+
+#include <QFont>
+#include <QTransform>
+
+/*************************************************************************************************/
+/************** Cache of laid out label texts so each distinct label is shaped once **************/
+/*************************************************************************************************/
+
+/****************************************** constructor ******************************************/
+
+LabelCache::LabelCache( int max )
+{
+  // set max number of texts before cache emptied
+  m_max = max;
+}
+
+/********************************************* text **********************************************/
+
+const QStaticText& LabelCache::text( const QString& label, const QFont& font )
+{
+  // return cached text if already laid out for this font
+  Key  key( font.key(), label );
+  auto it = m_texts.find( key );
+  if ( it != m_texts.end() ) return it.value();
+
+  // bound cache size, labels no longer visible will be laid out again when needed
+  if ( m_texts.size() >= m_max ) m_texts.clear();
+
+  // lay out text once for this font
+  QStaticText  text( label );
+  text.setTextFormat( Qt::PlainText );
+  text.setPerformanceHint( QStaticText::AggressiveCaching );
+  text.prepare( QTransform(), font );
+  return m_texts.insert( key, text ).value();
+}
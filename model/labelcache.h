@@ -0,0 +1,50 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef LABELCACHE_H
+#define LABELCACHE_H
+
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QStaticText>
+
+class QFont;
+
+/*************************************************************************************************/
+/************** Cache of laid out label texts so each distinct label is shaped once **************/
+/*************************************************************************************************/
+
+class LabelCache
+{
+public:
+  LabelCache( int max = 4096 );                            // constructor
+
+  const QStaticText&  text( const QString&, const QFont& );  // return laid out text for label & font
+  void                clear() { m_texts.clear(); }         // remove all cached texts
+
+private:
+  typedef QPair<QString,QString>  Key;                     // font key & label text
+
+  QHash<Key, QStaticText>  m_texts;     // laid out texts
+  int                      m_max;       // max number of texts before cache emptied
+};
+
+#endif // LABELCACHE_H
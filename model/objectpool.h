@@ -0,0 +1,102 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <QVector>
+
+#include <new>
+#include <utility>
+
+/*************************************************************************************************/
+/********************* Pool allocating plan objects from a few large blocks **********************/
+/*************************************************************************************************/
+
+template <class T> class ObjectPool
+{
+public:
+  ObjectPool( int blockSize )
+    : m_blockSize( blockSize ), m_free( 0 ), m_objects( 0 ), m_created( 0 ) {}   // constructor
+  ~ObjectPool() { clear(); }                                     // destructor
+
+  template <typename... Args> T*  create( Args&&... args )        // construct new object in pool
+  {
+    // if last block is full, allocate another block
+    if ( m_free == 0 )
+    {
+      m_blocks.append( ::operator new( sizeof(T) * m_blockSize ) );
+      m_free = m_blockSize;
+    }
+
+    // construct object in next free slot of last block
+    T*  slot   = static_cast<T*>( m_blocks.last() ) + m_blockSize - m_free;
+    T*  object = new ( slot ) T( std::forward<Args>(args)... );
+    m_free--;
+    m_objects++;
+    m_created++;
+    return object;
+  }
+
+  void  destroyLast()                                             // destroy most recently created object
+  {
+    // destroy object in last used slot, releasing last block if it becomes empty
+    Q_ASSERT( m_objects > 0 );
+    static_cast<T*>( m_blocks.last() )[ m_blockSize - m_free - 1 ].~T();
+    m_free++;
+    m_objects--;
+    if ( m_free == m_blockSize )
+    {
+      ::operator delete( m_blocks.takeLast() );
+      m_free = 0;
+    }
+  }
+
+  void  clear()                                                   // destroy all objects and free blocks
+  {
+    // destroy every object in every block, then release blocks in one go
+    for( int b = 0 ; b < m_blocks.size() ; b++ )
+    {
+      int  used = ( b == m_blocks.size()-1 ) ? m_blockSize - m_free : m_blockSize;
+      for( int s = 0 ; s < used ; s++ )
+        static_cast<T*>( m_blocks[b] )[s].~T();
+      ::operator delete( m_blocks[b] );
+    }
+
+    m_blocks.clear();
+    m_free    = 0;
+    m_objects = 0;
+  }
+
+  int   objects() const { return m_objects; }                     // return number of objects in pool
+  int   created() const { return m_created; }                     // return number of objects ever created
+  int   blocks() const { return m_blocks.size(); }                // return number of blocks allocated
+
+private:
+  Q_DISABLE_COPY( ObjectPool )
+
+  QVector<void*>  m_blocks;       // blocks of object slots
+  int             m_blockSize;    // number of object slots per block
+  int             m_free;         // number of unused slots in last block
+  int             m_objects;      // number of objects constructed
+  int             m_created;      // number of create calls, each a heap allocation without pool
+};
+
+#endif // OBJECTPOOL_H
@@ -25,6 +25,11 @@
 #include "calendar.h"
 #include "resourcesmodel.h"
 #include "tasksmodel.h"
+#include "journal.h"
+#include "plansnapshot.h"
+
+#include "command/undocommand.h"
+#include "command/commandbatch.h"
 
 #include <QUndoStack>
 #include <QXmlStreamWriter>
@@ -52,7 +57,33 @@ int        Plan::numDays() { return m_days->number(); }                   // ret
 DateTime   Plan::beginning() { return m_tasks->planBeginning(); }         // return start of earliest starting task
 DateTime   Plan::end() { return m_tasks->planEnd(); }                     // return finish of latest finishing task
 
-void       Plan::schedule() { m_tasks->schedule(); }                      // schedule the plan tasks
+
+/******************************************** created ********************************************/
+
+int  Plan::created()
+{
+  // return number of plan objects ever created, each would be a heap allocation without pools
+  return m_tasks->created() + m_resources->created() +
+         m_calendars->created() + m_days->created();
+}
+
+/******************************************** blocks *********************************************/
+
+int  Plan::blocks()
+{
+  // return number of pool blocks allocated for plan objects
+  return m_tasks->blocks() + m_resources->blocks() +
+         m_calendars->blocks() + m_days->blocks();
+}
+
+/*************************************** setDatetimeFormat ***************************************/
+
+void  Plan::setDatetimeFormat( QString format )
+{
+  // set datetime format, tasks display data formatted with old format is no longer valid
+  m_datetime_format = format;
+  m_tasks->invalidateDisplay();
+}
 
 /****************************************** constructor ******************************************/
 
@@ -64,27 +95,245 @@ Plan::Plan()
   m_resources  = new ResourcesModel();
   m_tasks      = new TasksModel();
   m_undostack  = new QUndoStack();
+  m_undostack->setUndoLimit( UNDO_LIMIT );
+  m_batch      = nullptr;
+  m_batchDepth = 0;
+  m_holdDepth  = 0;
+  m_schedulePending = false;
+  m_journal      = new Journal();
+  m_journalIndex = 0;
+  m_journalBase  = 0;
+  m_markPosition = -1;
+  m_markBase     = 0;
+  m_pushing      = false;
+  m_edits        = 0;
+  m_undoDropped  = false;
 
   m_start           = 0;  // TODO
   m_datetime_format = "ddd dd/MM/yyyy hh:mm";
   m_calendar        = nullptr;
+  m_calendarEpoch   = 0;
   stretchTasks      = true;
 
   // connect models so name changes are correctly reflected
   connect( m_days, SIGNAL(nameChanged()), m_calendars, SLOT(slotDayNameChange()) );
   connect( m_calendars, SIGNAL(nameChanged()), m_resources, SLOT(slotCalendarNameChange()) );
+
+  // check undo stack memory and journal whenever commands pushed, undone or redone
+  connect( m_undostack, SIGNAL(indexChanged(int)), this, SLOT(slotUndoIndexChanged(int)) );
+}
+
+/******************************************* schedule ********************************************/
+
+void  Plan::schedule()
+{
+  // schedule the plan tasks, unless held in which case schedule once released
+  if ( m_holdDepth > 0 )
+    m_schedulePending = true;
+  else
+    m_tasks->schedule();
+}
+
+/********************************************* push **********************************************/
+
+void  Plan::push( UndoCommand* command )
+{
+  // journal command before pushing, as stack deletes command if merged
+  m_journal->writePush( command );
+  m_edits++;
+
+  // add command to current batch if batching, otherwise push to undo stack
+  if ( m_batch != nullptr )
+  {
+    m_batch->add( command );
+    return;
+  }
+
+  pushStack( command );
+
+  // if journal growing long, ask for it to be folded into a snapshot
+  if ( m_journal->records() > JOURNAL_LIMIT ) emit signalSnapshotNeeded();
+}
+
+/******************************************* pushStack *******************************************/
+
+void  Plan::pushStack( QUndoCommand* command )
+{
+  // pushing below captured plan discards commands it was captured after, so mark no longer valid
+  if ( m_undostack->index() < m_markBase ) m_markPosition = -1;
+
+  // push command, if at undo limit stack drops its oldest so indices into stack move down one
+  const QUndoCommand*  oldest = m_undostack->count() > 0 ? m_undostack->command(0) : nullptr;
+  m_pushing = true;
+  m_undostack->push( command );
+  m_pushing = false;
+  m_journalIndex = m_undostack->index();
+
+  if ( oldest && m_undostack->count() > 0 && m_undostack->command(0) != oldest )
+  {
+    m_journalBase = qMax( 0, m_journalBase - 1 );
+    m_markBase    = qMax( 0, m_markBase - 1 );
+  }
+}
+
+/***************************************** startJournal ******************************************/
+
+void  Plan::startJournal( QString journalFile, QString base, QString baseWhen )
+{
+  // start journal of edits on base file, undo below current top can no longer be journalled
+  m_journal->start( journalFile, base, baseWhen );
+  m_journalIndex = m_undostack->index();
+  m_journalBase  = m_journalIndex;
+  m_markPosition = -1;
+}
+
+/****************************************** markJournal ******************************************/
+
+void  Plan::markJournal()
+{
+  // remember journal position & undo stack top when plan captured for save or snapshot
+  m_markPosition = m_journal->isOpen() ? m_journal->position() : -1;
+  m_markBase     = m_undostack->index();
+}
+
+/***************************************** rebaseJournal *****************************************/
+
+bool  Plan::rebaseJournal( QString journalFile, QString base, QString baseWhen )
+{
+  // if journal restarted since mark, or undone below mark, file written is not a valid base
+  if ( m_markPosition < 0 || m_undostack->index() < m_markBase ) return false;
+
+  // restart journal on file written, keeping edits made since plan captured
+  if ( !m_journal->rebase( journalFile, base, baseWhen, m_markPosition ) ) return false;
+  m_journalBase  = m_markBase;
+  m_markPosition = -1;
+  return true;
+}
+
+/******************************************** isClean ********************************************/
+
+bool  Plan::isClean()
+{
+  // plan clean if undo stack clean, unless history dropped as stack would then wrongly be clean
+  return m_undostack->isClean() && !m_undoDropped;
+}
+
+/******************************************* setClean ********************************************/
+
+void  Plan::setClean()
+{
+  // mark undo stack clean, plan now matches saved file even if history was dropped
+  m_undoDropped = false;
+  m_undostack->setClean();
+}
+
+/****************************************** beginBatch *******************************************/
+
+void  Plan::beginBatch( const QString& text )
+{
+  // start batching commands, nested batches join the outermost batch
+  if ( m_batchDepth++ > 0 ) return;
+  m_batch = new CommandBatch( text );
+  m_journal->writeBeginBatch( text );
+  holdSchedule();
+}
+
+/******************************************* endBatch ********************************************/
+
+void  Plan::endBatch()
+{
+  // when outermost batch ends, push batch as one undo command unless empty
+  Q_ASSERT( m_batchDepth > 0 );
+  if ( --m_batchDepth > 0 ) return;
+  CommandBatch* batch = m_batch;
+  m_batch = nullptr;
+  m_journal->writeEndBatch();
+
+  if ( batch->count() > 0 )
+    pushStack( batch );
+  else
+    delete batch;
+
+  // schedule once and signal tasks model changes once for whole batch
+  releaseSchedule();
+}
+
+/***************************************** holdSchedule ******************************************/
+
+void  Plan::holdSchedule()
+{
+  // defer scheduling and tasks model row change signals until released
+  m_holdDepth++;
+}
+
+/*************************************** releaseSchedule *****************************************/
+
+void  Plan::releaseSchedule()
+{
+  // when outermost hold released, schedule if requested while still held so rows changed by
+  // scheduling join the held rows, then signal all held row changes once
+  Q_ASSERT( m_holdDepth > 0 );
+  if ( m_holdDepth > 1 )
+  {
+    m_holdDepth--;
+    return;
+  }
+
+  if ( m_schedulePending )
+  {
+    m_schedulePending = false;
+    m_tasks->schedule();
+  }
+
+  m_holdDepth--;
+  m_tasks->emitHeldChanges();
+}
+
+/************************************* slotUndoIndexChanged **************************************/
+
+void  Plan::slotUndoIndexChanged( int index )
+{
+  // compact oldest commands first until undo stack memory back within budget
+  for( int c = 0 ; c < m_undostack->count() && UndoCommand::totalBytes() > UNDO_BUDGET ; c++ )
+  {
+    const UndoCommand* command = dynamic_cast<const UndoCommand*>( m_undostack->command(c) );
+    if ( command && !command->isCompacted() ) const_cast<UndoCommand*>( command )->compact();
+  }
+
+  // if still over budget after a push, drop undo history as stack cannot drop just its oldest,
+  // journal is unaffected as plan not changed and journal index is reset when push returns
+  if ( m_pushing && UndoCommand::totalBytes() > UNDO_BUDGET && m_undostack->count() > 1 )
+  {
+    m_undoDropped  = true;
+    m_journalBase  = 0;
+    m_markBase     = 0;
+    m_undostack->clear();
+    emit signalUndoDropped();
+  }
+
+  // pushes are journalled by push, otherwise record commands undone or redone
+  if ( m_pushing ) return;
+  m_edits++;
+  if ( !m_journal->isOpen() || index == m_journalIndex ) return;
+  if ( index < m_journalIndex ) m_journal->writeUndo( m_journalIndex - index );
+  if ( index > m_journalIndex ) m_journal->writeRedo( index - m_journalIndex );
+  m_journalIndex = index;
+
+  // if undone below where journal started, journal base no longer valid so snapshot needed
+  if ( index < m_journalBase ) emit signalSnapshotNeeded();
 }
 
 /****************************************** destructor *******************************************/
 
 Plan::~Plan()
 {
-  // delete models and undostack
+  // delete models, undostack and journal (journal file kept for recovery)
   delete m_tasks;
   delete m_resources;
   delete m_calendars;
   delete m_days;
   delete m_undostack;
+  delete m_journal;
 }
 
 /****************************************** initialise *******************************************/
@@ -119,31 +368,41 @@ bool  Plan::isOK()
 
 void  Plan::setFileInfo( QString filename, QDateTime when, QString who )
 {
-  // set plan file, when, who properties
+  // set plan file, when, who properties, empty filename for untitled plan
   QFileInfo  file = filename;
   m_filename      = file.fileName();
-  m_file_location = file.path();
+  m_file_location = filename.isEmpty() ? QString() : file.path();
   m_saved_by      = who;
   m_saved_when    = when;
 }
 
-/***************************************** saveToStream ******************************************/
+/**************************************** saveToSnapshot *****************************************/
 
-void  Plan::saveToStream( QXmlStreamWriter* stream )
+void  Plan::saveToSnapshot( PlanSnapshot* snapshot )
 {
-  // write plan data to xml stream
-  m_days->saveToStream( stream );
-  m_calendars->saveToStream( stream );
-  m_resources->saveToStream( stream );
-  m_tasks->saveToStream( stream );
-
-  stream->writeStartElement( "plan-data" );
-  stream->writeAttribute( "title", m_title );
-  stream->writeAttribute( "start", XDateTime::toString( m_start, "yyyy-MM-ddTHH:mm:ss" ) );
-  stream->writeAttribute( "calendar", QString("%1").arg(plan->index(m_calendar)) );
-  stream->writeAttribute( "datetime-format", m_datetime_format );
-  stream->writeAttribute( "notes", m_notes );
-  stream->writeEndElement();
+  // days, calendars & resources are few so written immediately, tasks are captured for later
+  m_days->saveToStream( snapshot->stream() );
+  m_calendars->saveToStream( snapshot->stream() );
+  m_resources->saveToStream( snapshot->stream() );
+  m_tasks->saveToSnapshot( snapshot );
+
+  // capture plan data, strings are copy-on-write so copies are cheap
+  QString  title    = m_title;
+  QString  start    = XDateTime::toString( m_start, "yyyy-MM-ddTHH:mm:ss" );
+  QString  calendar = QString("%1").arg(plan->index(m_calendar));
+  QString  format   = m_datetime_format;
+  QString  notes    = m_notes;
+
+  snapshot->defer( [title, start, calendar, format, notes]( QXmlStreamWriter* stream )
+  {
+    stream->writeStartElement( "plan-data" );
+    stream->writeAttribute( "title", title );
+    stream->writeAttribute( "start", start );
+    stream->writeAttribute( "calendar", calendar );
+    stream->writeAttribute( "datetime-format", format );
+    stream->writeAttribute( "notes", notes );
+    stream->writeEndElement();
+  } );
 }
 
 /**************************************** loadFromStream *****************************************/
@@ -151,15 +410,7 @@ void  Plan::saveToStream( QXmlStreamWriter* stream )
 void  Plan::loadFromStream( QXmlStreamReader* stream, QString file )
 {
   // read qplanner file attributes
-  foreach( QXmlStreamAttribute attribute, stream->attributes() )
-  {
-    if ( attribute.name() == "user" )
-      m_saved_by = attribute.value().toString();
-
-    if ( attribute.name() == "when" )
-      m_saved_when = QDateTime::fromString( attribute.value().toString(), "yyyy-MM-ddTHH:mm:ss" );
-  }
-  setFileInfo( file, m_saved_when, m_saved_by );
+  loadFileInfo( stream, file );
 
   // load plan data from xml stream
   while ( !stream->atEnd() )
@@ -171,35 +422,57 @@ void  Plan::loadFromStream( QXmlStreamReader* stream, QString file )
       if ( stream->name() == "calendars-data" ) m_calendars->loadFromStream( stream );
       if ( stream->name() == "resources-data" ) m_resources->loadFromStream( stream );
       if ( stream->name() == "tasks-data"     ) m_tasks->loadFromStream( stream );
+      if ( stream->name() == "plan-data"      ) loadPlanData( stream );
 
-      if ( stream->name() == "plan-data" )
-        foreach( QXmlStreamAttribute attribute, stream->attributes() )
-        {
-          if ( attribute.name() == "title" )
-            m_title = attribute.value().toString();
+      // if stream name is display-data then have finished loading plan
+      if ( stream->name() == "display-data" ) return;
+    }
+  }
+}
 
-          if ( attribute.name() == "start" )
-            m_start = XDateTime::fromString( attribute.value().toString() );
+/***************************************** loadFileInfo ******************************************/
 
-          if ( attribute.name() == "calendar" )
-          {
-            int calId = attribute.value().toString().toInt();
-            if ( calId >= numCalendars() || calId < 0 )
-              stream->raiseError( QString("Plan invalid calendar '%1'").arg(calId) );
-            else
-              m_calendar = calendar( calId );
-          }
+void  Plan::loadFileInfo( QXmlStreamReader* stream, QString file )
+{
+  // read qplanner file attributes from root element
+  foreach( QXmlStreamAttribute attribute, stream->attributes() )
+  {
+    if ( attribute.name() == "user" )
+      m_saved_by = attribute.value().toString();
 
-          if ( attribute.name() == "datetime-format" )
-            m_datetime_format = attribute.value().toString();
+    if ( attribute.name() == "when" )
+      m_saved_when = QDateTime::fromString( attribute.value().toString(), "yyyy-MM-ddTHH:mm:ss" );
+  }
+  setFileInfo( file, m_saved_when, m_saved_by );
+}
 
-          if ( attribute.name() == "notes" )
-            m_notes = attribute.value().toString();
-        }
+/***************************************** loadPlanData ******************************************/
 
-      // if stream name is display-data then have finished loading plan
-      if ( stream->name() == "display-data" ) return;
+void  Plan::loadPlanData( QXmlStreamReader* stream )
+{
+  // read plan properties from plan-data element, calendars must already be loaded
+  foreach( QXmlStreamAttribute attribute, stream->attributes() )
+  {
+    if ( attribute.name() == "title" )
+      m_title = attribute.value().toString();
+
+    if ( attribute.name() == "start" )
+      m_start = XDateTime::fromString( attribute.value().toString() );
+
+    if ( attribute.name() == "calendar" )
+    {
+      int calId = attribute.value().toString().toInt();
+      if ( calId >= numCalendars() || calId < 0 )
+        stream->raiseError( QString("Plan invalid calendar '%1'").arg(calId) );
+      else
+        setCalendar( calId );
     }
+
+    if ( attribute.name() == "datetime-format" )
+      setDatetimeFormat( attribute.value().toString() );
+
+    if ( attribute.name() == "notes" )
+      m_notes = attribute.value().toString();
   }
 }
 
@@ -220,3 +493,20 @@ DateTime  Plan::stretch( DateTime dt )
   // plan stretchTasks flag not true, so return original date-time
   return dt;
 }
+
+/**************************************** calendarVersion ****************************************/
+
+quint32  Plan::calendarVersion()
+{
+  // counters only increase so their sum changes whenever calendars, resources or default calendar
+  // change, one added so never matches a task that has not yet combined its calendar
+  return m_calendars->combiner().version() + m_resources->version() + m_calendarEpoch + 1;
+}
+
+/***************************************** stretchVersion ****************************************/
+
+quint32  Plan::stretchVersion()
+{
+  // counters only increase so their sum changes whenever calendars or default calendar change
+  return ( m_calendars->combiner().version() + m_calendarEpoch ) * 2 + ( stretchTasks ? 1 : 0 );
+}
@@ -40,6 +40,10 @@ class Task;
 class Resource;
 class Calendar;
 class Day;
+class UndoCommand;
+class CommandBatch;
+class Journal;
+class PlanSnapshot;
 
 /*************************************************************************************************/
 /************************** Holds the complete data model for the plan ***************************/
@@ -55,11 +59,26 @@ public:
   void             initialise();                                    // create initial plan default contents
   QUndoStack*      undostack() { return m_undostack; }              // return undo stack pointer
   QColor           nullCellColour() { return QColor( "#F0F0F0" ); } // return colour for null table cell
-  void             schedule();                                      // schedule the plan tasks
+  void             schedule();                                      // schedule the plan tasks, or defer if held
+  void             push( UndoCommand* );                            // push command to undo stack or current batch
+  void             beginBatch( const QString& );                    // start batching commands into one undo command
+  void             endBatch();                                      // end batching and push batch as one undo command
+  void             holdSchedule();                                  // defer scheduling & tasks signals until released
+  void             releaseSchedule();                               // release hold, doing any deferred scheduling
+  bool             isHeld() const { return m_holdDepth > 0; }       // return if scheduling & tasks signals deferred
+  Journal*         journal() { return m_journal; }                  // return journal of edits since last save
+  void             startJournal( QString, QString, QString );       // start journal file on base file & when
+  void             markJournal();                                   // mark journal when plan captured for writing
+  bool             rebaseJournal( QString, QString, QString );      // restart journal on file saved at mark
+  int              edits() const { return m_edits; }                // return count of pushes, undos & redos
+  bool             isClean();                                       // return if plan unchanged since clean
+  void             setClean();                                      // mark plan clean, as just saved or loaded
   bool             isOK();                                          // return if plan appears valid
   void             setFileInfo( QString, QDateTime, QString );      // set plan file, when, who properties
-  void             saveToStream( QXmlStreamWriter* );               // write plan data to xml stream
+  void             saveToSnapshot( PlanSnapshot* );                 // capture plan data for writing to xml stream
   void             loadFromStream( QXmlStreamReader*, QString );    // load plan data from xml stream
+  void             loadFileInfo( QXmlStreamReader*, QString );      // load file attributes from root element
+  void             loadPlanData( QXmlStreamReader* );               // load plan properties from plan-data element
 
   TasksModel*      tasks() { return m_tasks; }                      // return tasks model pointer
   ResourcesModel*  resources() { return m_resources; }              // return resources model pointer
@@ -80,6 +99,8 @@ public:
   int              numResources();                                  // return number of resources in plan
   int              numCalendars();                                  // return number of calendars in plan
   int              numDays();                                       // return number of day types in plan
+  int              created();                                       // return number of plan objects ever created
+  int              blocks();                                        // return number of pool blocks allocated
 
   QString          title() { return m_title; }                      // return title of plan
   DateTime         start() { return m_start; }                      // return nominal start of plan (T0)
@@ -95,30 +116,57 @@ public:
 
   void             setTitle( QString t ) { m_title = t; }           // set title
   void             setStart( DateTime dt ) { m_start = dt; }        // set start
-  void             setDatetimeFormat( QString f )
-                     { m_datetime_format = f; }                     // set datetime format
-  void             setCalendar( Calendar* c ) { m_calendar = c; }   // set plan default calendar
+  void             setDatetimeFormat( QString );                    // set datetime format
+  void             setCalendar( Calendar* c )
+                     { m_calendar = c; m_calendarEpoch++; }         // set plan default calendar
   void             setCalendar( int c )
-                     { m_calendar = calendar(c); }                  // set plan default calendar
+                     { setCalendar( calendar(c) ); }                // set plan default calendar
   void             setNotes( QString n ) { m_notes = n; }           // set notes text
 
   bool             stretchTasks;                                    // flag if gantt task bars stretched to use full 24h day
   DateTime         stretch( DateTime dt );                          // return date-time stretched if necessary
+  quint32          stretchVersion();                                // return version changing when stretching may change
+  quint32          calendarVersion();                               // return version changing when task calendars may change
+
+  static const int    UNDO_LIMIT  = 1000;              // max number of undo commands, oldest dropped
+  static const qint64 UNDO_BUDGET = 16 * 1024 * 1024;  // undo memory in bytes above which compacted or dropped
+  static const int    JOURNAL_LIMIT = 500;             // journal records above which snapshot wanted
 
 signals:
   void  signalPlanUpdated();            // signal to say plan properties updated
+  void  signalSnapshotNeeded();         // signal to say journal should be folded into a new snapshot
+  void  signalUndoDropped();            // signal to say undo history dropped to keep within budget
+
+private slots:
+  void  slotUndoIndexChanged( int );    // keep undo stack memory within budget, journal undo & redo
 
 private:
+  void             pushStack( QUndoCommand* );      // push to undo stack, adjusting indices if oldest dropped
+
   TasksModel*      m_tasks;             // model of plan tasks
   ResourcesModel*  m_resources;         // model of plan resources
   CalendarsModel*  m_calendars;         // model of plan calendars
   DaysModel*       m_days;              // model of plan day types
 
   QUndoStack*      m_undostack;         // undo stack of plan editing
+  CommandBatch*    m_batch;             // batch collecting commands, or nullptr if not batching
+  int              m_batchDepth;        // nesting depth of begin & end batch calls
+  int              m_holdDepth;         // nesting depth of hold & release schedule calls
+  bool             m_schedulePending;   // true if scheduling requested while held
+
+  Journal*         m_journal;           // journal of edits since last save or snapshot
+  int              m_journalIndex;      // undo stack index last recorded in journal
+  int              m_journalBase;       // undo stack index when journal started, lowered as oldest dropped
+  qint64           m_markPosition;      // journal position when plan captured for snapshot, or -1
+  int              m_markBase;          // undo stack index when plan captured, lowered as oldest dropped
+  bool             m_pushing;           // true while pushing, so index change not journalled as redo
+  int              m_edits;             // incremented on every push, undo & redo, even if merged
+  bool             m_undoDropped;       // true if undo history dropped since plan last clean
 
   QString          m_title;             // plan title as set in properties
   DateTime         m_start;             // plan start as set in properties
   Calendar*        m_calendar;          // plan default calendar pointer
+  quint32          m_calendarEpoch;     // incremented when plan default calendar set
   QString          m_datetime_format;   // plan datetime format as set in properties
   QString          m_filename;          // filename when last opened/saved
   QString          m_file_location;     // file location when last opened/saved
@@ -0,0 +1,129 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "plancompress.h"
+
+#include <QDataStream>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QVector>
+
+/*************************************************************************************************/
+/******************* CompressBlock compresses or uncompresses one block on a thread **************/
+/*************************************************************************************************/
+
+class CompressBlock : public QRunnable
+{
+public:
+  CompressBlock( const QByteArray& in, QByteArray* out, bool compress )
+    : m_in( in ), m_out( out ), m_compress( compress ) {}
+
+  void run() { *m_out = m_compress ? qCompress( m_in ) : qUncompress( m_in ); }
+
+private:
+  QByteArray   m_in;          // block to be processed, shares data with caller
+  QByteArray*  m_out;         // result written here, each block has its own
+  bool         m_compress;    // compress if true, otherwise uncompress
+};
+
+/*************************************************************************************************/
+/************ Compressed plan file format, xml split into blocks compressed in parallel **********/
+/*************************************************************************************************/
+
+/****************************************** isCompressed *****************************************/
+
+bool  PlanCompress::isCompressed( const QByteArray& data )
+{
+  // return true if data starts with compressed plan identifier
+  QDataStream  in( data );
+  quint32      magic = 0;
+  in >> magic;
+  return in.status() == QDataStream::Ok && magic == MAGIC;
+}
+
+/**************************************** isCompressedName ***************************************/
+
+bool  PlanCompress::isCompressedName( const QString& filename )
+{
+  // return true if plan should be saved compressed, decided by filename extension
+  return filename.endsWith( ".xmlz", Qt::CaseInsensitive );
+}
+
+/******************************************** compress *******************************************/
+
+QByteArray  PlanCompress::compress( const QByteArray& xml )
+{
+  // compress xml in independent blocks so both saving and loading can use all cores
+  int                 count = ( xml.size() + BLOCK_BYTES - 1 ) / BLOCK_BYTES;
+  QVector<QByteArray> blocks( count );
+  QThreadPool         pool;
+  for( int n = 0 ; n < count ; n++ )
+    pool.start( new CompressBlock( xml.mid( n * BLOCK_BYTES, BLOCK_BYTES ), &blocks[n], true ) );
+  pool.waitForDone();
+
+  // header then length prefixed blocks
+  QByteArray   data;
+  QDataStream  out( &data, QIODevice::WriteOnly );
+  out.setVersion( QDataStream::Qt_5_3 );
+  out << MAGIC << VERSION << quint32( count );
+  foreach( QByteArray block, blocks )
+    out << block;
+  return data;
+}
+
+/******************************************* uncompress ******************************************/
+
+bool  PlanCompress::uncompress( const QByteArray& data, QByteArray& xml, int first )
+{
+  // check header is for a compressed plan this version understands
+  QDataStream  in( data );
+  in.setVersion( QDataStream::Qt_5_3 );
+  quint32  magic = 0, count = 0;
+  qint32   version = 0;
+  in >> magic >> version >> count;
+  if ( in.status() != QDataStream::Ok || magic != MAGIC || version > VERSION ) return false;
+  if ( first >= 0 && quint32( first ) < count ) count = first;
+
+  // read length prefixed blocks, failing if data truncated
+  QVector<QByteArray>  blocks;
+  for( quint32 n = 0 ; n < count ; n++ )
+  {
+    QByteArray  block;
+    in >> block;
+    if ( in.status() != QDataStream::Ok || block.isEmpty() ) return false;
+    blocks.append( block );
+  }
+
+  // uncompress blocks in parallel, an empty result means the block was corrupt
+  QVector<QByteArray>  parts( blocks.size() );
+  QThreadPool          pool;
+  for( int n = 0 ; n < blocks.size() ; n++ )
+    pool.start( new CompressBlock( blocks.at(n), &parts[n], false ) );
+  pool.waitForDone();
+
+  QByteArray  result;
+  foreach( QByteArray part, parts )
+  {
+    if ( part.isEmpty() ) return false;
+    result.append( part );
+  }
+  xml = result;
+  return true;
+}
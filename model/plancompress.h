@@ -0,0 +1,44 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef PLANCOMPRESS_H
+#define PLANCOMPRESS_H
+
+#include <QByteArray>
+#include <QString>
+
+/*************************************************************************************************/
+/************ Compressed plan file format, xml split into blocks compressed in parallel **********/
+/*************************************************************************************************/
+
+class PlanCompress
+{
+public:
+  static bool        isCompressed( const QByteArray& );             // return true if data is compressed plan
+  static bool        isCompressedName( const QString& );            // return true if filename is for compressed plan
+  static QByteArray  compress( const QByteArray& );                 // return xml compressed in blocks
+  static bool        uncompress( const QByteArray&, QByteArray&, int = -1 );  // uncompress first n blocks or all, false if corrupt
+
+  static const quint32  MAGIC       = 0x50504C5A;                   // compressed plan identifier 'PPLZ'
+  static const qint32   VERSION     = 1;                            // compressed plan format version
+  static const int      BLOCK_BYTES = 1 << 20;                      // uncompressed bytes per block
+};
+
+#endif // PLANCOMPRESS_H
@@ -0,0 +1,278 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "planloader.h"
+#include "plancompress.h"
+#include "plan.h"
+#include "daysmodel.h"
+#include "calendarsmodel.h"
+#include "resourcesmodel.h"
+#include "tasksmodel.h"
+#include "task.h"
+
+#include <QXmlStreamReader>
+#include <QThreadPool>
+#include <QRunnable>
+
+/*************************************************************************************************/
+/************************* LoadJob runs one part of plan load on a thread ************************/
+/*************************************************************************************************/
+
+class LoadJob : public QRunnable
+{
+public:
+  LoadJob( std::function<void()> job ) : m_job( job ) {}
+
+  void run() { m_job(); }
+
+private:
+  std::function<void()>  m_job;   // part of load to run
+};
+
+/*************************************************************************************************/
+/********* PlanLoader indexes plan xml sections by byte range and parses them concurrently *******/
+/*************************************************************************************************/
+
+/****************************************** constructor ******************************************/
+
+PlanLoader::PlanLoader( const QByteArray& data ) : m_data( data )
+{
+  // no task chunks or predecessors until indexed
+  m_preds.start = -1;
+  m_preds.end   = -1;
+}
+
+/********************************************* load **********************************************/
+
+bool  PlanLoader::load( QString file )
+{
+  // compressed plans are uncompressed in memory first, so sections can be indexed as normal
+  if ( PlanCompress::isCompressed( m_data ) && !PlanCompress::uncompress( m_data, m_data ) )
+  {
+    m_error = "Corrupt compressed plan";
+    return false;
+  }
+
+  // root element must be a project planner plan
+  QXmlStreamReader  root( m_data );
+  while ( !root.atEnd() && !root.isStartElement() )
+    root.readNext();
+
+  if ( !root.isStartElement() || root.name() != "projectplanner" )
+  {
+    m_error = root.hasError() ? root.errorString()
+                              : QString("Unrecognised element '%1'").arg( root.name().toString() );
+    return false;
+  }
+
+  // small plans, or plans not laid out as expected, are loaded in one pass on this thread
+  Range  days      = section( "days-data" );
+  Range  calendars = section( "calendars-data" );
+  Range  resources = section( "resources-data" );
+  Range  tasks     = section( "tasks-data" );
+  Range  planData  = section( "plan-data" );
+  if ( days.start < 0 || calendars.start < 0 || resources.start < 0 || tasks.start < 0 ||
+       planData.start < 0 || !indexTasks( tasks ) )
+  {
+    plan->loadFromStream( &root, file );
+    m_error = root.errorString();
+    return !root.hasError();
+  }
+  plan->loadFileInfo( &root, file );
+
+  // days first as calendars refer to them
+  m_error = parse( m_data.mid( days.start, days.end - days.start ),
+                   []( QXmlStreamReader* stream ) { plan->days()->loadFromStream( stream ); } );
+  if ( !m_error.isEmpty() ) return false;
+
+  // create all tasks up front so each chunk fills in its own tasks without touching the pool
+  int  first = plan->tasks()->rowCount( QModelIndex() );
+  int  total = 0;
+  foreach( int count, m_counts ) total += count;
+  plan->tasks()->appendRows( total );
+
+  // calendars then resources on one thread, while task chunks are parsed on the others as
+  // tasks only refer to resources by name
+  QVector<QString>  errors( m_counts.size() + 1 );
+  QThreadPool       pool;
+  QByteArray        calendarsData = m_data.mid( calendars.start, calendars.end - calendars.start );
+  QByteArray        resourcesData = m_data.mid( resources.start, resources.end - resources.start );
+  pool.start( new LoadJob( [this, &errors, calendarsData, resourcesData]()
+  {
+    errors[0] = parse( calendarsData,
+                       []( QXmlStreamReader* stream ) { plan->calendars()->loadFromStream( stream ); } );
+    if ( errors[0].isEmpty() )
+      errors[0] = parse( resourcesData,
+                         []( QXmlStreamReader* stream ) { plan->resources()->loadFromStream( stream ); } );
+  } ) );
+
+  int  id = first;
+  for( int c = 0 ; c < m_counts.size() ; c++ )
+  {
+    int  count = m_counts.at(c);
+    pool.start( new LoadJob( [this, &errors, c, id, count]()
+    {
+      errors[c+1] = parse( wrap( m_chunks.at(c), m_chunks.at(c+1) ),
+                           [id, count]( QXmlStreamReader* stream )
+      {
+        int  n = id;
+        while ( !stream->atEnd() )
+        {
+          stream->readNext();
+          if ( stream->isStartElement() && stream->name() == "task" )
+          {
+            if ( n >= id + count ) { stream->raiseError( "Unexpected task element" ); return; }
+            plan->task( n++ )->loadFromStream( stream );
+          }
+        }
+      } );
+    } ) );
+    id += count;
+  }
+  pool.waitForDone();
+
+  foreach( QString error, errors )
+    if ( !error.isEmpty() )
+    {
+      m_error = error;
+      return false;
+    }
+
+  // predecessors refer to other tasks by id so are resolved once all tasks are loaded
+  m_error = parse( wrap( m_preds.start, m_preds.end ), []( QXmlStreamReader* stream )
+  {
+    while ( !stream->atEnd() )
+    {
+      stream->readNext();
+      if ( stream->isStartElement() && stream->name() == "predecessors" )
+        plan->tasks()->loadPredecessors( stream );
+    }
+  } );
+  if ( !m_error.isEmpty() ) return false;
+  plan->tasks()->loadFinished();
+
+  // plan properties refer to calendars so are loaded last
+  m_error = parse( m_data.mid( planData.start, planData.end - planData.start ),
+                   []( QXmlStreamReader* stream )
+  {
+    while ( !stream->atEnd() && !stream->isStartElement() )
+      stream->readNext();
+    if ( stream->isStartElement() ) plan->loadPlanData( stream );
+  } );
+  return m_error.isEmpty();
+}
+
+/****************************************** displayData ******************************************/
+
+QByteArray  PlanLoader::displayData() const
+{
+  // return display-data section for the gui to load, or empty if none
+  Range  display = section( "display-data" );
+  if ( display.start < 0 ) return QByteArray();
+  return m_data.mid( display.start, display.end - display.start );
+}
+
+/******************************************** section ********************************************/
+
+PlanLoader::Range  PlanLoader::section( const char* name, int from ) const
+{
+  // find section start tag by text search, safe as '<' and '>' are always escaped in values
+  QByteArray  tag   = QByteArray("<") + name;
+  Range       range = { -1, -1 };
+  int         pos   = m_data.indexOf( tag, from );
+  while ( pos >= 0 )
+  {
+    // check tag name ends here, so 'task' does not match 'tasks-data'
+    char  next = pos + tag.size() < m_data.size() ? m_data.at( pos + tag.size() ) : '\0';
+    if ( next == '>' || next == '/' || next == ' ' || next == '\t' || next == '\r' || next == '\n' )
+      break;
+    pos = m_data.indexOf( tag, pos + tag.size() );
+  }
+
+  int  close = pos < 0 ? -1 : m_data.indexOf( '>', pos );
+  if ( close < 0 ) return range;
+
+  // section ends after its start tag if an empty element, otherwise after its end tag
+  if ( m_data.at( close - 1 ) == '/' )
+  {
+    range.start = pos;
+    range.end   = close + 1;
+    return range;
+  }
+
+  QByteArray  endTag = QByteArray("</") + name + ">";
+  int         end    = m_data.indexOf( endTag, close );
+  if ( end < 0 ) return range;
+
+  range.start = pos;
+  range.end   = end + endTag.size();
+  return range;
+}
+
+/****************************************** indexTasks *******************************************/
+
+bool  PlanLoader::indexTasks( Range tasks )
+{
+  // task elements are followed by predecessors elements, both before tasks-data end tag
+  int  close = tasks.end - int( sizeof("</tasks-data>") - 1 );
+  int  end   = m_data.indexOf( "<predecessors", tasks.start );
+  if ( end < 0 || end > close ) end = close;
+
+  // split task elements into chunks of CHUNK_TASKS tasks, each starting at a task start tag
+  m_chunks.clear();
+  m_counts.clear();
+  int  count = 0;
+  for( Range task = section( "task", tasks.start ) ; task.start >= 0 && task.start < end ;
+       task = section( "task", task.end ) )
+  {
+    if ( count % CHUNK_TASKS == 0 )
+    {
+      m_chunks.append( task.start );
+      m_counts.append( 0 );
+    }
+    m_counts.last()++;
+    count++;
+  }
+  m_chunks.append( end );
+  m_preds.start = end;
+  m_preds.end   = qMax( end, close );
+
+  // only worth loading concurrently if more than one chunk of tasks
+  return count > CHUNK_TASKS;
+}
+
+/********************************************* wrap **********************************************/
+
+QByteArray  PlanLoader::wrap( int start, int end ) const
+{
+  // return byte range wrapped in a single element, so a run of elements is a valid document
+  return "<chunk>" + m_data.mid( start, end - start ) + "</chunk>";
+}
+
+/********************************************* parse *********************************************/
+
+QString  PlanLoader::parse( const QByteArray& xml,
+                            std::function<void(QXmlStreamReader*)> loader ) const
+{
+  // parse xml with loader on a reader of its own, returning description of any error
+  QXmlStreamReader  stream( xml );
+  loader( &stream );
+  return stream.hasError() ? stream.errorString() : QString();
+}
@@ -0,0 +1,63 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef PLANLOADER_H
+#define PLANLOADER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+class QXmlStreamReader;
+
+/*************************************************************************************************/
+/********* PlanLoader indexes plan xml sections by byte range and parses them concurrently *******/
+/*************************************************************************************************/
+
+class PlanLoader
+{
+public:
+  PlanLoader( const QByteArray& );                         // constructor
+
+  bool        load( QString );                             // load xml into global plan, false if failed
+  QByteArray  displayData() const;                         // return display-data section, or empty
+  QString     errorString() const { return m_error; }      // return description of load failure
+
+  static const int  CHUNK_TASKS = 2000;                    // tasks parsed per thread job
+
+private:
+  struct Range { int start; int end; };                    // section byte range, end is one past
+
+  Range       section( const char*, int = 0 ) const;       // find top-level section, start -1 if none
+  bool        indexTasks( Range );                         // find task element chunks within tasks-data
+  QString     parse( const QByteArray&,
+    std::function<void(QXmlStreamReader*)> ) const;        // parse xml with loader, return any error
+  QByteArray  wrap( int, int ) const;                      // return byte range wrapped as one element
+
+  QByteArray      m_data;          // whole plan xml
+  QVector<int>    m_chunks;        // byte start of each task chunk, then end of last chunk
+  QVector<int>    m_counts;        // number of tasks in each chunk
+  Range           m_preds;         // byte range of predecessors elements after tasks
+  QString         m_error;         // description of load failure
+};
+
+#endif // PLANLOADER_H
@@ -0,0 +1,59 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "plansnapshot.h"
+#include "plancompress.h"
+
+#include <QSaveFile>
+
+/*************************************************************************************************/
+/********** Plan captured on gui thread for saving, then written to file on worker thread *********/
+/*************************************************************************************************/
+
+/****************************************** constructor ******************************************/
+
+PlanSnapshot::PlanSnapshot() : m_stream( &m_xml )
+{
+  // small parts are written immediately while capturing, so stream must be ready
+  m_stream.setAutoFormatting( true );
+}
+
+/********************************************* save **********************************************/
+
+bool  PlanSnapshot::save( const QString& filename )
+{
+  // write deferred parts, which only touch captured values so plan may be edited meanwhile
+  foreach( Part part, m_parts )
+    part( &m_stream );
+  m_stream.writeEndDocument();
+
+  // compress if filename is for a compressed plan
+  QByteArray  data = PlanCompress::isCompressedName( filename ) ? PlanCompress::compress( m_xml ) : m_xml;
+
+  // replace file only once completely written, so a failed save never leaves a truncated plan
+  QSaveFile  file( filename );
+  if ( !file.open( QIODevice::WriteOnly ) || file.write( data ) != data.size() || !file.commit() )
+  {
+    m_error = QString("Failed to write to '%1' (%2)").arg( filename ).arg( file.errorString() );
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,54 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef PLANSNAPSHOT_H
+#define PLANSNAPSHOT_H
+
+#include <QByteArray>
+#include <QXmlStreamWriter>
+#include <QList>
+#include <QString>
+
+#include <functional>
+
+/*************************************************************************************************/
+/********** Plan captured on gui thread for saving, then written to file on worker thread *********/
+/*************************************************************************************************/
+
+class PlanSnapshot
+{
+public:
+  PlanSnapshot();                                          // constructor
+
+  typedef std::function<void(QXmlStreamWriter*)>  Part;    // writes captured values to xml stream
+
+  QXmlStreamWriter*  stream() { return &m_stream; }        // return stream for parts written while capturing
+  void       defer( Part part ) { m_parts.append( part ); }  // append part written later from captured values
+  bool       save( const QString& );                       // write deferred parts & save file, on any thread
+  QString    error() const { return m_error; }             // return description of save failure
+
+private:
+  QByteArray        m_xml;          // xml written so far
+  QXmlStreamWriter  m_stream;       // stream writing to xml
+  QList<Part>       m_parts;        // deferred parts holding only captured copy-on-write values
+  QString           m_error;        // description of save failure
+};
+
+#endif // PLANSNAPSHOT_H
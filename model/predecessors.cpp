@@ -41,43 +41,74 @@ Predecessors::Predecessors()
 
 /****************************************** constructor ******************************************/
 
-Predecessors::Predecessors( QString text )
+Predecessors::Predecessors( const QString& text )
 {
-  // split text into individual predecessors
+  // construct from text
+  parse( Scanner( &text ) );
+}
+
+/****************************************** constructor ******************************************/
+
+Predecessors::Predecessors( const QStringRef& text )
+{
+  // construct from text ref, avoids temporary strings when loading
+  parse( Scanner( text ) );
+}
+
+/********************************************* parse *********************************************/
+
+void Predecessors::parse( Scanner scan )
+{
+  // scan text for individual predecessors in place
   m_preds.clear();
-  foreach( QString part, text.split( ',', QString::SkipEmptyParts ) )
+  QStringRef  part;
+  while ( scan.nextPart( ',', part ) )
   {
     // split part into task, predecessor type and lag
-    part = part.trimmed();
-    int digit = 0;
-    while ( part.length() > digit && part.at(digit).isDigit() ) digit++;
+    int  digit = Scanner::digits( part );
 
-    int       task = part.left(digit).toInt();
-    char      type = Predecessors::TYPE_DEFAULT;
-    TimeSpan  lag  = QString("0");
+    Predecessor  pred;
+    pred.task = plan->task( Scanner::mid( part, 0, digit ).toInt() );
+    pred.type = Predecessors::TYPE_DEFAULT;
+    pred.lag  = TimeSpan( 0.0f, TimeSpan::UNIT_DAYS );
 
-    part.remove( 0, digit );
-    part = part.trimmed();
+    part = Scanner::trimmed( Scanner::mid( part, digit ) );
     if ( !part.isEmpty() )
     {
-      if ( part.startsWith( LABEL_FINISH_START,  Qt::CaseInsensitive ) ) type = TYPE_FINISH_START;
-      if ( part.startsWith( LABEL_START_START,   Qt::CaseInsensitive ) ) type = TYPE_START_START;
-      if ( part.startsWith( LABEL_START_FINISH,  Qt::CaseInsensitive ) ) type = TYPE_START_FINISH;
-      if ( part.startsWith( LABEL_FINISH_FINISH, Qt::CaseInsensitive ) ) type = TYPE_FINISH_FINISH;
-
-      part.remove( 0, 2 );
-      part = part.trimmed();
-      if ( !part.isEmpty() ) lag = part;
+      parseType( part, pred.type );
+      parseLag( part, pred.lag );
     }
 
-    Predecessor  pred;
-    pred.task = plan->task( task );
-    pred.type = type;
-    pred.lag  = lag;
     m_preds.append( pred );
   }
 }
 
+/******************************************* parseType *******************************************/
+
+bool Predecessors::parseType( QStringRef& part, char& type )
+{
+  // parse leading type label and move part past it, return false if not a valid type
+  bool  valid = true;
+  if      ( Scanner::startsWith( part, LABEL_FINISH_START ) )  type = TYPE_FINISH_START;
+  else if ( Scanner::startsWith( part, LABEL_START_START ) )   type = TYPE_START_START;
+  else if ( Scanner::startsWith( part, LABEL_START_FINISH ) )  type = TYPE_START_FINISH;
+  else if ( Scanner::startsWith( part, LABEL_FINISH_FINISH ) ) type = TYPE_FINISH_FINISH;
+  else valid = false;
+
+  part = Scanner::trimmed( Scanner::mid( part, 2 ) );
+  return valid;
+}
+
+/******************************************* parseLag ********************************************/
+
+bool Predecessors::parseLag( QStringRef& part, TimeSpan& lag )
+{
+  // parse remaining part as lag if present, return false if not a valid time span
+  if ( part.isEmpty() ) return true;
+  lag = TimeSpan( part );
+  return lag.isValid();
+}
+
 /******************************************** toString *******************************************/
 
 QString Predecessors::toString() const
@@ -203,24 +234,24 @@ bool Predecessors::hasToFinish() const
 
 QString Predecessors::validate( const QString& text, int thisTaskNum )
 {
-  // split text into individual predecessors
-  QString error;
-  foreach( QString part, text.split( ',', QString::SkipEmptyParts ) )
+  // scan text for individual predecessors in place, only building strings for errors
+  QString     error;
+  Scanner     scan( &text );
+  QStringRef  part;
+  while ( scan.nextPart( ',', part ) )
   {
     // split part into task, predecessor type and lag
-    part = part.trimmed();
-    int digit = 0;
-    while ( part.length() > digit && part.at( digit ).isDigit() ) digit++;
+    int digit = Scanner::digits( part );
 
     // check start is number
     if ( digit == 0 )
     {
-      error += QString( "'%1' does not start with a valid task number.\n" ).arg( part );
+      error += QString( "'%1' does not start with a valid task number.\n" ).arg( part.toString() );
       continue;
     }
 
     // check number is non-null task
-    int taskNum = part.left( digit ).toInt();
+    int taskNum = Scanner::mid( part, 0, digit ).toInt();
     if ( taskNum >= plan->tasks()->rowCount( QModelIndex() ) ||
          plan->task( taskNum )->isNull() )
     {
@@ -260,26 +291,53 @@ QString Predecessors::validate( const QString& text, int thisTaskNum )
       continue;
     }
 
-    // check nothing remains or is a valid type
-    part.remove( 0, digit );
-    part = part.trimmed();
-    if ( part.isEmpty() ) continue;
-    if ( !part.startsWith( LABEL_FINISH_START,  Qt::CaseInsensitive ) &&
-         !part.startsWith( LABEL_START_START,   Qt::CaseInsensitive ) &&
-         !part.startsWith( LABEL_START_FINISH,  Qt::CaseInsensitive ) &&
-         !part.startsWith( LABEL_FINISH_FINISH, Qt::CaseInsensitive ) )
+    // check remainder is valid type and lag
+    error += validateTypeLag( Scanner::trimmed( Scanner::mid( part, digit ) ) );
+  }
+
+  // remove final '\n' and return validation error text
+  error.chop(1);
+  return error;
+}
+
+/******************************************** validate *******************************************/
+
+QString Predecessors::validate( const QString& text, int thisTaskNum,
+                                const QVector<bool>& exists, QList<int>& taskNums )
+{
+  // scan text checking task numbers against tasks that will exist rather than current plan,
+  // appending valid task numbers so caller can check summaries & circular references together
+  QString     error;
+  Scanner     scan( &text );
+  QStringRef  part;
+  while ( scan.nextPart( ',', part ) )
+  {
+    // check start is number
+    int digit = Scanner::digits( part );
+    if ( digit == 0 )
     {
-      error += QString( "'%1' is not a valid dependency type.\n" ).arg( part );
+      error += QString( "'%1' does not start with a valid task number.\n" ).arg( part.toString() );
       continue;
     }
 
-    // check nothing remains or is valid time-span
-    part.remove( 0, 2 );
-    part = part.trimmed();
-    if ( part.isEmpty() ) continue;
-    TimeSpan ts = part;
-    if ( !ts.isValid() )
-      error += QString( "'%1' is not a valid time span.\n" ).arg( part );
+    // check number is task that will exist and is not this task
+    int taskNum = Scanner::mid( part, 0, digit ).toInt();
+    if ( taskNum >= exists.size() || !exists.at( taskNum ) )
+    {
+      error += QString( "'%1' is a null task.\n" ).arg( taskNum );
+      continue;
+    }
+
+    if ( taskNum == thisTaskNum )
+    {
+      error += QString( "'%1' is a reference to this task.\n" ).arg( taskNum );
+      continue;
+    }
+
+    // check remainder is valid type and lag
+    QString typeLag = validateTypeLag( Scanner::trimmed( Scanner::mid( part, digit ) ) );
+    if ( typeLag.isEmpty() ) taskNums.append( taskNum );
+    error += typeLag;
   }
 
   // remove final '\n' and return validation error text
@@ -287,6 +345,25 @@ QString Predecessors::validate( const QString& text, int thisTaskNum )
   return error;
 }
 
+/**************************************** validateTypeLag ****************************************/
+
+QString Predecessors::validateTypeLag( QStringRef part )
+{
+  // check nothing remains or is a valid type
+  if ( part.isEmpty() ) return QString();
+  QStringRef  rest = part;
+  char        type;
+  if ( !parseType( rest, type ) )
+    return QString( "'%1' is not a valid dependency type.\n" ).arg( part.toString() );
+
+  // check nothing remains or is valid time-span
+  TimeSpan  lag;
+  if ( !parseLag( rest, lag ) )
+    return QString( "'%1' is not a valid time span.\n" ).arg( rest.toString() );
+
+  return QString();
+}
+
 /********************************************* start *********************************************/
 
 DateTime  Predecessors::start() const
@@ -23,9 +23,11 @@
 
 #include <QString>
 #include <QList>
+#include <QVector>
 
 #include "timespan.h"
 #include "datetime.h"
+#include "scanner.h"
 
 class Task;
 
@@ -37,7 +39,8 @@ class Predecessors
 {
 public:
   Predecessors();                                    // constructor
-  Predecessors( QString );                           // constructor
+  Predecessors( const QString& );                    // constructor
+  Predecessors( const QStringRef& );                 // constructor
 
   QString         toString() const;                  // return string for display in tasks view
   QString         clean( int );                      // remove forbidden and then return string
@@ -49,6 +52,8 @@ public:
   DateTime        end() const;                       // return task end based on predecessors
 
   static QString  validate( const QString&, int );   // return any validation failures
+  static QString  validate( const QString&, int, const QVector<bool>&,
+                            QList<int>& );           // return failures against tasks that will exist
 
   enum pred_type
   {
@@ -66,12 +71,20 @@ public:
     TimeSpan  lag;
   };
 
+  const QList<Predecessor>&  list() const { return m_preds; }   // return list of task predecessors
+
   static const char*  LABEL_FINISH_START;
   static const char*  LABEL_START_START;
   static const char*  LABEL_START_FINISH;
   static const char*  LABEL_FINISH_FINISH;
 
 private:
+  void            parse( Scanner );                  // parse predecessors text into list
+
+  static bool     parseType( QStringRef&, char& );   // parse leading type label, true if valid
+  static bool     parseLag( QStringRef&, TimeSpan& );  // parse remaining lag, true if none or valid
+  static QString  validateTypeLag( QStringRef );     // return any failures in type & lag after task number
+
   QList<Predecessor>    m_preds;      // list of task predecessors
 };
 
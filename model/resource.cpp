@@ -37,6 +37,13 @@
 Resource::Resource()
 {
   // set resource variables to default/null values
+  m_initials     = XTag::NULL_TAG;
+  m_null         = true;
+  m_name         = XTag::NULL_TAG;
+  m_org          = XTag::NULL_TAG;
+  m_group        = XTag::NULL_TAG;
+  m_role         = XTag::NULL_TAG;
+  m_alias        = XTag::NULL_TAG;
   m_availability = 1.0;
   m_cost         = 0.0;
   m_calendar     = nullptr;
@@ -51,6 +58,13 @@ Resource::Resource( bool unassigned )
   Q_UNUSED( unassigned )
 
   // set resource variables for unassigned resource
+  m_initials     = XTag::NULL_TAG;
+  m_null         = true;
+  m_name         = XTag::NULL_TAG;
+  m_org          = XTag::NULL_TAG;
+  m_group        = XTag::NULL_TAG;
+  m_role         = XTag::NULL_TAG;
+  m_alias        = XTag::NULL_TAG;
   m_availability = 1e10;
   m_cost         = 0.0;
   m_calendar     = nullptr;
@@ -67,38 +81,41 @@ Resource::Resource( QXmlStreamReader* stream ) : Resource()
   foreach( QXmlStreamAttribute attribute, stream->attributes() )
   {
     if ( attribute.name() == "initials" )
-      m_initials = attribute.value().toString();
+    {
+      m_initials = XTag::tag( attribute.value().toString() );
+      m_null     = attribute.value().toString().isNull();
+    }
 
     if ( attribute.name() == "name" )
-      m_name = attribute.value().toString();
+      m_name = XTag::tag( attribute.value().toString() );
 
     if ( attribute.name() == "org" )
-      m_org = attribute.value().toString();
+      m_org = XTag::tag( attribute.value().toString() );
 
     if ( attribute.name() == "group" )
-      m_group = attribute.value().toString();
+      m_group = XTag::tag( attribute.value().toString() );
 
     if ( attribute.name() == "role" )
-      m_role = attribute.value().toString();
+      m_role = XTag::tag( attribute.value().toString() );
 
     if ( attribute.name() == "alias" )
-      m_alias = attribute.value().toString();
+      m_alias = XTag::tag( attribute.value().toString() );
 
     if ( attribute.name() == "start" )
-      m_start = XDate::fromString( attribute.value().toString() );
+      m_start = XDate::fromString( attribute.value() );
 
     if ( attribute.name() == "end" )
-      m_end = XDate::fromString( attribute.value().toString() );
+      m_end = XDate::fromString( attribute.value() );
 
     if ( attribute.name() == "availability" )
-      m_availability = attribute.value().toString().toFloat();
+      m_availability = attribute.value().toFloat();
 
     if ( attribute.name() == "cost" )
-      m_cost = attribute.value().toString().toFloat();
+      m_cost = attribute.value().toFloat();
 
     if ( attribute.name() == "calendar" )
     {
-      int calId = attribute.value().toString().toInt();
+      int calId = attribute.value().toInt();
       if ( calId >= plan->numCalendars() || calId < 0 )
         stream->raiseError( QString("Resource invalid calendar '%1'").arg(calId) );
       else
@@ -115,12 +132,12 @@ Resource::Resource( QXmlStreamReader* stream ) : Resource()
 void  Resource::saveToStream( QXmlStreamWriter* stream )
 {
   // write resource data to xml stream
-  stream->writeAttribute( "initials", m_initials );
-  stream->writeAttribute( "name", m_name );
-  stream->writeAttribute( "org", m_org );
-  stream->writeAttribute( "group", m_group );
-  stream->writeAttribute( "role", m_role );
-  stream->writeAttribute( "alias", m_alias );
+  stream->writeAttribute( "initials", XTag::string( m_initials ) );
+  stream->writeAttribute( "name", XTag::string( m_name ) );
+  stream->writeAttribute( "org", XTag::string( m_org ) );
+  stream->writeAttribute( "group", XTag::string( m_group ) );
+  stream->writeAttribute( "role", XTag::string( m_role ) );
+  stream->writeAttribute( "alias", XTag::string( m_alias ) );
   stream->writeAttribute( "start", XDate::toString( m_start, "yyyy-MM-dd" ) );
   stream->writeAttribute( "end", XDate::toString( m_end, "yyyy-MM-dd" ) );
   stream->writeAttribute( "availability", QString("%1").arg(m_availability) );
@@ -178,12 +195,12 @@ QVariant  Resource::data( int column, int role )
   // if role is DisplayRole, return appropriate display value
   if ( role == Qt::DisplayRole )
   {
-    if ( column == SECTION_INITIALS ) return m_initials;
-    if ( column == SECTION_NAME )     return m_name;
-    if ( column == SECTION_ORG )      return m_org;
-    if ( column == SECTION_GROUP )    return m_group;
-    if ( column == SECTION_ROLE )     return m_role;
-    if ( column == SECTION_ALIAS )    return m_alias;
+    if ( column == SECTION_INITIALS ) return XTag::string( m_initials );
+    if ( column == SECTION_NAME )     return XTag::string( m_name );
+    if ( column == SECTION_ORG )      return XTag::string( m_org );
+    if ( column == SECTION_GROUP )    return XTag::string( m_group );
+    if ( column == SECTION_ROLE )     return XTag::string( m_role );
+    if ( column == SECTION_ALIAS )    return XTag::string( m_alias );
     if ( column == SECTION_START )    return XDate::toString( m_start );
     if ( column == SECTION_END )      return XDate::toString( m_end );
     if ( column == SECTION_AVAIL )    return QString("%1").arg( m_availability );
@@ -212,12 +229,17 @@ QVariant  Resource::data( int column, int role )
 void  Resource::setData( int col, const QVariant& value )
 {
   // update resource (should only be called by undostack)
-  if ( col == SECTION_INITIALS ) m_initials     = value.toString();
-  if ( col == SECTION_NAME )     m_name         = value.toString();
-  if ( col == SECTION_ORG )      m_org          = value.toString();
-  if ( col == SECTION_GROUP )    m_group        = value.toString();
-  if ( col == SECTION_ROLE )     m_role         = value.toString();
-  if ( col == SECTION_ALIAS )    m_alias        = value.toString();
+  if ( col == SECTION_INITIALS )
+  {
+    // empty initials are not null, so empty tag alone can't say if resource is null
+    m_initials = XTag::tag( value.toString() );
+    m_null     = value.toString().isNull();
+  }
+  if ( col == SECTION_NAME )     m_name         = XTag::tag( value.toString() );
+  if ( col == SECTION_ORG )      m_org          = XTag::tag( value.toString() );
+  if ( col == SECTION_GROUP )    m_group        = XTag::tag( value.toString() );
+  if ( col == SECTION_ROLE )     m_role         = XTag::tag( value.toString() );
+  if ( col == SECTION_ALIAS )    m_alias        = XTag::tag( value.toString() );
   if ( col == SECTION_AVAIL )    m_availability = value.toFloat();
   if ( col == SECTION_START )    m_start        = XDate::date( value.toDate() );
   if ( col == SECTION_END )      m_end          = XDate::date( value.toDate() );
@@ -255,9 +277,10 @@ Date Resource::end() const
 
 /******************************************** hasTag *********************************************/
 
-bool Resource::hasTag( QString tag ) const
+bool Resource::hasTag( Tag tag ) const
 {
   // return true if tag matches on of the free text fields
+  if ( tag == XTag::NULL_TAG ) return false;
   if ( tag == m_initials ) return true;
   if ( tag == m_name )     return true;
   if ( tag == m_org )      return true;
@@ -270,24 +293,17 @@ bool Resource::hasTag( QString tag ) const
 
 /****************************************** assignable *******************************************/
 
-QList<QString>  Resource::assignable() const
+QList<Tag>  Resource::assignable() const
 {
-  // return assignable names
-  QList<QString>  list;
-  QString         temp;
-
-  temp = m_initials;
-  if ( !temp.isEmpty() ) list << temp;
-  temp = m_name;
-  if ( !temp.isEmpty() ) list << temp;
-  temp = m_org;
-  if ( !temp.isEmpty() ) list << temp;
-  temp = m_group;
-  if ( !temp.isEmpty() ) list << temp;
-  temp = m_role;
-  if ( !temp.isEmpty() ) list << temp;
-  temp = m_alias;
-  if ( !temp.isEmpty() ) list << temp;
+  // return assignable tags
+  QList<Tag>  list;
+
+  if ( m_initials != XTag::NULL_TAG ) list << m_initials;
+  if ( m_name     != XTag::NULL_TAG ) list << m_name;
+  if ( m_org      != XTag::NULL_TAG ) list << m_org;
+  if ( m_group    != XTag::NULL_TAG ) list << m_group;
+  if ( m_role     != XTag::NULL_TAG ) list << m_role;
+  if ( m_alias    != XTag::NULL_TAG ) list << m_alias;
 
   return list;
 }
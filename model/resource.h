@@ -22,6 +22,7 @@
 #define RESOURCE_H
 
 #include "datetime.h"
+#include "tag.h"
 
 class Calendar;
 class QXmlStreamWriter;
@@ -43,13 +44,13 @@ public:
   QVariant          data( int, int );                                // return data for column & role
   void              setData( int, const QVariant& );                 // set data value for column
 
-  bool              isNull() const { return m_initials.isNull(); }   // is the task null (blank)
-  QString           initials() const { return m_initials; }          // return initials
+  bool              isNull() const { return m_null; }                // is the task null (blank)
+  QString           initials() const { return XTag::string( m_initials ); }  // return initials
   Calendar*         calendar() const { return m_calendar; }          // return resource calendar
   Date              start() const;                                   // return resource start date
   Date              end() const;                                     // return resource end date
-  QList<QString>    assignable() const;                              // return assignable names
-  bool              hasTag( QString ) const;                         // return true if tag matches
+  QList<Tag>        assignable() const;                              // return assignable tags
+  bool              hasTag( Tag ) const;                             // return true if tag matches
 
   enum sections                            // sections to be displayed by view
   {
@@ -70,12 +71,13 @@ public:
   };
 
 private:
-  QString            m_initials;           // must be unique across all resources in model
-  QString            m_name;               // free text
-  QString            m_org;                // free text
-  QString            m_group;              // free text
-  QString            m_role;               // free text
-  QString            m_alias;              // free text
+  Tag                m_initials;           // must be unique across all resources in model
+  bool               m_null;               // true until initials set, even if set empty
+  Tag                m_name;               // free text
+  Tag                m_org;                // free text
+  Tag                m_group;              // free text
+  Tag                m_role;               // free text
+  Tag                m_alias;              // free text
   Date               m_start;              // date availability starts inclusive
   Date               m_end;                // date availability end inclusive
   float              m_availability;       // number available
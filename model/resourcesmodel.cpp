@@ -31,18 +31,19 @@
 
 /****************************************** constructor ******************************************/
 
-ResourcesModel::ResourcesModel() : QAbstractTableModel()
+ResourcesModel::ResourcesModel() : QAbstractTableModel(), m_pool( POOL_BLOCK )
 {
   // create 'unassigned' resource, also known as resource zero, usually hidden
-  m_resources.append( new Resource(true) );
+  m_version = 0;
+  m_resources.append( m_pool.create(true) );
 }
 
 /****************************************** destructor *******************************************/
 
 ResourcesModel::~ResourcesModel()
 {
-  // delete all resources in model
-  foreach( Resource* r, m_resources ) delete r;
+  // destroy all resources in model in one go
+  m_pool.clear();
 }
 
 /****************************************** initialise ******************************************/
@@ -50,11 +51,11 @@ ResourcesModel::~ResourcesModel()
 void ResourcesModel::initialise()
 {
   // create initial blank resource
-  m_resources.append( new Resource() );
-  m_resources.append( new Resource() );
-  m_resources.append( new Resource() );
-  m_resources.append( new Resource() );
-  m_resources.append( new Resource() );
+  m_resources.append( m_pool.create() );
+  m_resources.append( m_pool.create() );
+  m_resources.append( m_pool.create() );
+  m_resources.append( m_pool.create() );
+  m_resources.append( m_pool.create() );
 }
 
 /********************************************* resource ***********************************************/
@@ -112,7 +113,7 @@ void  ResourcesModel::loadFromStream( QXmlStreamReader* stream )
 
     // if resource element create new resource
     if ( stream->isStartElement() && stream->name() == "resource" )
-      m_resources.append( new Resource(stream) );
+      m_resources.append( m_pool.create(stream) );
 
     // when reached end of resources data return
     if ( stream->isEndElement() && stream->name() == "resources-data" ) break;
@@ -173,7 +174,7 @@ bool ResourcesModel::setData( const QModelIndex& index,
   if ( value == data( index, role ) ) return false;
 
   // set data via undo/redo command
-  plan->undostack()->push( new CommandResourceSetData( index, value ) );
+  plan->push( new CommandResourceSetData( index, value ) );
   return true;
 }
 
@@ -242,18 +243,19 @@ bool ResourcesModel::initialsIsDuplicate( const QString& id, int row )
 
 void ResourcesModel::updateAssignable()
 {
-  // start with an empty set
+  // start with an empty set, resources have changed so tasks must re-combine their calendars
+  m_version++;
   m_assignable.clear();
 
   // determine assignable list
   foreach( Resource* res, m_resources )
-    foreach( QString str, res->assignable() )
-      m_assignable.insert( str );
+    foreach( Tag tag, res->assignable() )
+      m_assignable.insert( tag );
 }
 
 /**************************************** resourceSet ***************************************/
 
-QSet<Resource*> ResourcesModel::resourceSet( QString tag )
+QSet<Resource*> ResourcesModel::resourceSet( Tag tag )
 {
   // return set of resources that have tag
   QSet<Resource*>  set;
@@ -24,6 +24,9 @@
 #include <QAbstractTableModel>
 #include <QSet>
 
+#include "objectpool.h"
+#include "tag.h"
+
 class Resource;
 class QXmlStreamWriter;
 class QXmlStreamReader;
@@ -41,6 +44,8 @@ public:
 
   void           initialise();                                     // create initial default contents
   int            number();                                         // return number of resources in plan
+  int            created() { return m_pool.created(); }            // return number of resources ever created
+  int            blocks() { return m_pool.blocks(); }              // return number of pool blocks allocated
   void           saveToStream( QXmlStreamWriter* );                // write resources data to xml stream
   void           loadFromStream( QXmlStreamReader* );              // load resources data from xml stream
 
@@ -54,9 +59,10 @@ public:
                    { m_overrideIndex = i; m_overrideValue = v; }   // set model override values
 
   void           updateAssignable();                               // determine assignable list
-  QSet<Resource*> resourceSet( QString );                          // return set of resources that have tag
+  quint32        version() const { return m_version; }             // return version, changes on resource edits
+  QSet<Resource*> resourceSet( Tag );                              // return set of resources that have tag
   bool           isAssignable( const QString& tag ) const
-                   { return m_assignable.contains( tag ); }        // is tag assignable?
+                   { return m_assignable.contains( XTag::find( tag ) ); }  // is tag assignable?
 
   /********************* methods to support QAbstractTableModel ************************/
 
@@ -76,7 +82,11 @@ signals:
                          const QString& ) const;                   // signal that cell editing needs to continue
 private:
   QList<Resource*>  m_resources;       // list of resources available to plan
-  QSet<QString>     m_assignable;      // set of assignable resource tag(s)
+  ObjectPool<Resource> m_pool;        // pool holding resource objects
+
+  static const int  POOL_BLOCK = 64;   // resources per pool block, plans usually have tens
+  QSet<Tag>         m_assignable;      // set of assignable resource tag(s)
+  quint32           m_version;         // incremented whenever any resource edited or loaded
 
   QModelIndex       m_overrideIndex;   // with value can override model for edits in progress
   QVariant          m_overrideValue;   // with index can override model for edits in progress
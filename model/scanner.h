@@ -0,0 +1,104 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include <QString>
+#include <QStringRef>
+
+/*************************************************************************************************/
+/******************** Scans string parts in place without temporary QStrings *********************/
+/*************************************************************************************************/
+
+class Scanner
+{
+public:
+  Scanner( const QString* str )
+    : m_str( str ), m_pos( 0 ), m_end( str->size() ) {}                   // constructor for string
+  Scanner( const QStringRef& ref )
+    : m_str( ref.string() ), m_pos( ref.position() ),
+      m_end( ref.position() + ref.size() ) {}                             // constructor for string ref
+
+/******************************************* nextPart ********************************************/
+
+  bool  nextPart( QChar sep, QStringRef& part )
+  {
+    // set part to next non-empty section before separator trimmed of white space, false if none left
+    while ( m_pos < m_end )
+    {
+      int start = m_pos;
+      while ( m_pos < m_end && m_str->at( m_pos ) != sep ) m_pos++;
+      int end = m_pos++;
+      if ( end > start )
+      {
+        part = trimmed( QStringRef( m_str, start, end - start ) );
+        return true;
+      }
+    }
+    return false;
+  }
+
+/******************************************** trimmed ********************************************/
+
+  static QStringRef  trimmed( const QStringRef& ref )
+  {
+    // return string ref with leading and trailing white space removed
+    int start = 0, end = ref.size();
+    while ( start < end && ref.at( start ).isSpace() ) start++;
+    while ( end > start && ref.at( end - 1 ).isSpace() ) end--;
+    return mid( ref, start, end - start );
+  }
+
+/********************************************** mid **********************************************/
+
+  static QStringRef  mid( const QStringRef& ref, int pos, int len = -1 )
+  {
+    // return part of string ref starting at position, to end if length negative
+    if ( pos > ref.size() ) pos = ref.size();
+    if ( len < 0 || pos + len > ref.size() ) len = ref.size() - pos;
+    return QStringRef( ref.string(), ref.position() + pos, len );
+  }
+
+/******************************************** digits *********************************************/
+
+  static int  digits( const QStringRef& ref )
+  {
+    // return number of leading digits
+    int digit = 0;
+    while ( digit < ref.size() && ref.at( digit ).isDigit() ) digit++;
+    return digit;
+  }
+
+/****************************************** startsWith *******************************************/
+
+  static bool  startsWith( const QStringRef& ref, const char* label )
+  {
+    // return true if string ref starts with latin1 label ignoring case
+    return ref.startsWith( QLatin1String( label ), Qt::CaseInsensitive );
+  }
+
+private:
+  const QString*  m_str;    // string being scanned
+  int             m_pos;    // current scan position
+  int             m_end;    // end of scan range
+};
+
+#endif // SCANNER_H
@@ -0,0 +1,81 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include <QHash>
+#include <QVector>
+#include <QReadWriteLock>
+
+#include "tag.h"
+
+/*************************************************************************************************/
+/************* XTag provides static methods to intern strings as small integer Tags **************/
+/*************************************************************************************************/
+
+static QHash<QString, Tag>  tagIds;                    // interned string to Tag
+static QVector<QString>     tagStrings( 1 );           // Tag to interned string, Tag zero is null
+static QReadWriteLock       tagLock;                   // guards interning table across threads
+
+/********************************************** tag **********************************************/
+
+Tag XTag::tag( const QString& str )
+{
+  // null and empty strings are always NULL_TAG
+  if ( str.isEmpty() ) return NULL_TAG;
+
+  // if string already interned, return its Tag
+  {
+    QReadLocker  locker( &tagLock );
+    Tag  id = tagIds.value( str );
+    if ( id != NULL_TAG ) return id;
+  }
+
+  // otherwise intern string, checking again in case another thread got there first
+  QWriteLocker  locker( &tagLock );
+  Tag  id = tagIds.value( str );
+  if ( id == NULL_TAG )
+  {
+    id = tagStrings.size();
+    tagStrings.append( str );
+    tagIds.insert( str, id );
+  }
+
+  return id;
+}
+
+/********************************************* find **********************************************/
+
+Tag XTag::find( const QString& str )
+{
+  // return Tag for string, or NULL_TAG if never interned
+  if ( str.isEmpty() ) return NULL_TAG;
+
+  QReadLocker  locker( &tagLock );
+  return tagIds.value( str );
+}
+
+/******************************************** string *********************************************/
+
+QString XTag::string( Tag id )
+{
+  // return string for Tag
+  QReadLocker  locker( &tagLock );
+  Q_ASSERT( id < quint32( tagStrings.size() ) );
+  return tagStrings.at( id );
+}
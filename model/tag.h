@@ -0,0 +1,43 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TAG_H
+#define TAG_H
+
+#include <QtGlobal>
+#include <QString>
+
+typedef  quint32 Tag;        // interned string id, equal strings always have equal ids
+
+/*************************************************************************************************/
+/************* XTag provides static methods to intern strings as small integer Tags **************/
+/*************************************************************************************************/
+
+class XTag
+{
+public:
+  const static Tag   NULL_TAG = 0;             // Tag value for null or empty string
+
+  static Tag       tag( const QString& );      // return Tag for string, interning if new
+  static Tag       find( const QString& );     // return Tag for string, or NULL_TAG if not interned
+  static QString   string( Tag );              // return string for Tag
+};
+
+#endif // TAG_H
@@ -48,6 +48,17 @@ Task::Task()
   m_start       = XDateTime::NULL_DATETIME;
   m_end         = XDateTime::NULL_DATETIME;
   m_deadline    = XDateTime::NULL_DATETIME;
+  m_calendar        = nullptr;
+  m_calendarVersion = 0;
+  m_calendarClash   = false;
+
+  // task display cache starts empty
+  m_version        = 0;
+  m_displayVersion = 0;
+  m_displayEpoch   = 0;
+  m_displayValid   = 0;
+  m_savedVersion   = 0;
+  m_savedEpoch     = 0;
 }
 
 /****************************************** constructor ******************************************/
@@ -67,6 +78,17 @@ Task::Task( bool planSummary )
   m_start       = XDateTime::NULL_DATETIME;
   m_end         = XDateTime::NULL_DATETIME;
   m_deadline    = XDateTime::NULL_DATETIME;
+  m_calendar        = nullptr;
+  m_calendarVersion = 0;
+  m_calendarClash   = false;
+
+  // task display cache starts empty
+  m_version        = 0;
+  m_displayVersion = 0;
+  m_displayEpoch   = 0;
+  m_displayValid   = 0;
+  m_savedVersion   = 0;
+  m_savedEpoch     = 0;
 }
 
 /****************************************** constructor ******************************************/
@@ -74,13 +96,21 @@ Task::Task( bool planSummary )
 Task::Task( QXmlStreamReader* stream ) : Task()
 {
   // create task from stream
+  loadFromStream( stream );
+}
+
+/**************************************** loadFromStream *****************************************/
+
+void  Task::loadFromStream( QXmlStreamReader* stream )
+{
+  // set task from stream task element attributes, safe to call concurrently for different tasks
   foreach( QXmlStreamAttribute attribute, stream->attributes() )
   {
     if ( attribute.name() == "indent" )
-      m_indent = attribute.value().toString().toShort();
+      m_indent = attribute.value().toShort();
 
     if ( attribute.name() == "summary" )
-      m_summaryEnd = attribute.value().toString().toInt();
+      m_summaryEnd = attribute.value().toInt();
 
     if ( attribute.name() == "expanded" )
       m_expanded = ( attribute.value() == "1" );
@@ -89,55 +119,77 @@ Task::Task( QXmlStreamReader* stream ) : Task()
       m_title = attribute.value().toString();
 
     if ( attribute.name() == "duration" )
-      m_duration = attribute.value().toString();
+      m_duration = TimeSpan( attribute.value() );
 
     if ( attribute.name() == "start" )
-      m_start = XDateTime::fromString( attribute.value().toString() );
+      m_start = XDateTime::fromString( attribute.value() );
 
     if ( attribute.name() == "end" )
-      m_end = XDateTime::fromString( attribute.value().toString() );
+      m_end = XDateTime::fromString( attribute.value() );
 
     if ( attribute.name() == "work" )
-      m_work = attribute.value().toString();
+      m_work = TimeSpan( attribute.value() );
 
     if ( attribute.name() == "resources" )
-      m_resources = attribute.value().toString();
+    {
+      m_resources       = TaskResources( attribute.value() );
+      m_calendarVersion = 0;
+    }
 
     if ( attribute.name() == "type" )
-      m_type = attribute.value().toString().toInt();
+      m_type = attribute.value().toInt();
 
     if ( attribute.name() == "priority" )
-      m_priority = attribute.value().toString().toInt() * 1e6;
+      m_priority = attribute.value().toInt() * 1e6;
 
     if ( attribute.name() == "deadline" )
-      m_deadline = XDateTime::fromString( attribute.value().toString() );
+      m_deadline = XDateTime::fromString( attribute.value() );
 
     if ( attribute.name() == "cost" )
-      m_cost = attribute.value().toString().toFloat();
+      m_cost = attribute.value().toFloat();
 
     if ( attribute.name() == "comment" )
       m_comment = attribute.value().toString();
   }
 }
-/***************************************** saveToStream ******************************************/
+/******************************************* saveNames *******************************************/
+
+QStringList  Task::saveNames()
+{
+  // return xml attribute names in same order as save values
+  return QStringList() << "indent" << "summary" << "expanded" << "title" << "duration"
+                       << "start" << "end" << "work" << "resources" << "type" << "priority"
+                       << "deadline" << "cost" << "comment";
+}
+
+/****************************************** saveValues *******************************************/
 
-void  Task::saveToStream( QXmlStreamWriter* stream )
+QStringList  Task::saveValues() const
 {
-  // write task data to xml stream
-  stream->writeAttribute( "indent", QString("%1").arg(m_indent) );
-  stream->writeAttribute( "summary", QString("%1").arg(m_summaryEnd) );
-  stream->writeAttribute( "expanded", QString("%1").arg(m_expanded) );
-  stream->writeAttribute( "title", m_title );
-  stream->writeAttribute( "duration", m_duration.toString() );
-  stream->writeAttribute( "start", XDateTime::toString( m_start, "yyyy-MM-ddThh:mm" ) );
-  stream->writeAttribute( "end", XDateTime::toString( m_end, "yyyy-MM-ddThh:mm" ) );
-  stream->writeAttribute( "work", m_work.toString() );
-  stream->writeAttribute( "resources", m_resources.toString() );
-  stream->writeAttribute( "type", QString("%1").arg(int(m_type)) );
-  stream->writeAttribute( "priority", QString("%1").arg(m_priority/1e6) );
-  stream->writeAttribute( "deadline", XDateTime::toString( m_deadline, "yyyy-MM-ddThh:mm" ) );
-  stream->writeAttribute( "cost", "TODO" );
-  stream->writeAttribute( "comment", m_comment );
+  // return task data formatted for saving, only re-formatted if task changed since last save
+  quint32 epoch = plan->tasks()->displayEpoch();
+  if ( m_saved.isEmpty() || m_savedVersion != m_version || m_savedEpoch != epoch )
+  {
+    m_savedVersion = m_version;
+    m_savedEpoch   = epoch;
+    m_saved        = QStringList()
+      << QString("%1").arg(m_indent)
+      << QString("%1").arg(m_summaryEnd)
+      << QString("%1").arg(m_expanded)
+      << m_title
+      << m_duration.toString()
+      << XDateTime::toString( m_start, "yyyy-MM-ddThh:mm" )
+      << XDateTime::toString( m_end, "yyyy-MM-ddThh:mm" )
+      << m_work.toString()
+      << m_resources.toString()
+      << QString("%1").arg(int(m_type))
+      << QString("%1").arg(m_priority/1e6)
+      << XDateTime::toString( m_deadline, "yyyy-MM-ddThh:mm" )
+      << "TODO"
+      << m_comment;
+  }
+
+  return m_saved;
 }
 
 /****************************************** headerData *******************************************/
@@ -261,6 +313,9 @@ QVariant  Task::dataToolTipRole( int col ) const
   if ( col == SECTION_DEADLINE && m_deadline != XDateTime::NULL_DATETIME )
     return XDateTime::toString( m_deadline, "ddd dd MMM yyyy hh:mm" );
 
+  if ( col == SECTION_RES && m_calendarClash )
+    return "Resources have no working time in common with plan calendar, so plan calendar used";
+
   return QVariant();
 }
 
@@ -284,6 +339,53 @@ QVariant  Task::dataFontRole( int col ) const
 /***************************************** dataDisplayRole ***************************************/
 
 QVariant  Task::dataDisplayRole( int col ) const
+{
+  // if display cache filled for different task version or model epoch, it is no longer valid
+  quint32 epoch = plan->tasks()->displayEpoch();
+  if ( m_displayVersion != m_version || m_displayEpoch != epoch )
+  {
+    m_displayVersion = m_version;
+    m_displayEpoch   = epoch;
+    m_displayValid   = 0;
+  }
+
+  // return cached display data if valid, otherwise format and cache
+  if ( col < SECTION_MINIMUM || col > SECTION_MAXIMUM ) return QVariant();
+  if ( m_displayValid & ( 1u << col ) ) return m_display.at( col );
+
+  if ( m_display.isEmpty() ) m_display.resize( SECTION_MAXIMUM + 1 );
+  m_display[col]  = formatDisplay( col );
+  m_displayValid |= 1u << col;
+  return m_display.at( col );
+}
+
+/***************************************** releaseCaches *****************************************/
+
+void  Task::releaseCaches()
+{
+  // release cached display data and stretched gantt, they are recalculated when next needed
+  m_display      = QVector<QVariant>();
+  m_displayValid = 0;
+  m_saved        = QStringList();
+  m_gantt.releaseStretch();
+}
+
+/********************************************* bytes *********************************************/
+
+int  Task::bytes() const
+{
+  // return approx memory held by task, including strings and cached display data
+  int size = sizeof(Task) - sizeof(GanttData) + m_gantt.bytes();
+  size += ( m_title.capacity() + m_comment.capacity() ) * sizeof(QChar);
+  size += m_predecessors.list().size() * sizeof(Predecessors::Predecessor);
+  foreach( const QVariant& display, m_display )
+    size += sizeof(QVariant) + ( display.type() == QVariant::String ? display.toString().size() * sizeof(QChar) : 0 );
+  return size;
+}
+
+/***************************************** formatDisplay *****************************************/
+
+QVariant  Task::formatDisplay( int col ) const
 {
   // if task is null don't display anything
   if ( isNull() ) return QVariant();
@@ -338,6 +440,7 @@ QString  Task::typeToString( int type )
 void  Task::setData( int col, const QVariant& value )
 {
   qDebug("%p Task::setData %i '%s'",this,col,qPrintable(value.toString()));
+  m_version++;
 
   // if the task was null determine a suitable default indent
   bool wasNull = false;
@@ -363,6 +466,9 @@ void  Task::setData( int col, const QVariant& value )
   if ( col == SECTION_PRIORITY ) m_priority     = value.toInt() * 1000000;
   if ( col == SECTION_COMMENT )  m_comment      = value.toString();
 
+  // if resources changed combined calendar must be re-calculated
+  if ( col == SECTION_RES ) m_calendarVersion = 0;
+
   // call set summaries if was null
   if ( wasNull )
   {
@@ -371,6 +477,49 @@ void  Task::setData( int col, const QVariant& value )
   }
 }
 
+/****************************************** dataUndoRole *****************************************/
+
+QVariant  Task::dataUndoRole( int col ) const
+{
+  // return column value in the form restoreData sets it back, date-times & priority kept raw
+  if ( col == SECTION_TITLE )    return m_title;
+  if ( col == SECTION_DURATION ) return m_duration.toString();
+  if ( col == SECTION_WORK )     return m_work.toString();
+  if ( col == SECTION_TYPE )     return int( m_type );
+  if ( col == SECTION_START )    return m_start;
+  if ( col == SECTION_END )      return m_end;
+  if ( col == SECTION_PREDS )    return m_predecessors.toString();
+  if ( col == SECTION_DEADLINE ) return m_deadline;
+  if ( col == SECTION_RES )      return m_resources.toString();
+  if ( col == SECTION_COST )     return m_cost;
+  if ( col == SECTION_PRIORITY ) return m_priority;
+  if ( col == SECTION_COMMENT )  return m_comment;
+  return QVariant();
+}
+
+/****************************************** restoreData ******************************************/
+
+void  Task::restoreData( int col, const QVariant& value )
+{
+  // restore column value from dataUndoRole, without the defaults setData gives null tasks
+  m_version++;
+  if ( col == SECTION_TITLE )    m_title        = value.toString();
+  if ( col == SECTION_DURATION ) m_duration     = value.toString();
+  if ( col == SECTION_WORK )     m_work         = value.toString();
+  if ( col == SECTION_TYPE )     m_type         = value.toInt();
+  if ( col == SECTION_START )    m_start        = value.toUInt();
+  if ( col == SECTION_END )      m_end          = value.toUInt();
+  if ( col == SECTION_PREDS )    m_predecessors = value.toString();
+  if ( col == SECTION_DEADLINE ) m_deadline     = value.toUInt();
+  if ( col == SECTION_RES )      m_resources    = value.toString();
+  if ( col == SECTION_COST )     m_cost         = value.toReal();
+  if ( col == SECTION_PRIORITY ) m_priority     = value.toInt();
+  if ( col == SECTION_COMMENT )  m_comment      = value.toString();
+
+  // if resources changed combined calendar must be re-calculated
+  if ( col == SECTION_RES ) m_calendarVersion = 0;
+}
+
 /**************************************** predecessorsOK *****************************************/
 
 bool Task::predecessorsOK() const
@@ -384,6 +533,7 @@ bool Task::predecessorsOK() const
 QString Task::predecessorsClean()
 {
   // remove forbidden and then return string
+  m_version++;
   return m_predecessors.clean( plan->index((Task*)this) );
 }
 
@@ -442,21 +592,11 @@ float Task::work() const
 
 DateTime Task::start() const
 {
-  // return task or summary start date-time
+  // return task or summary start date-time, summary from its subtasks in the task store
   if ( isSummary() )
   {
-    int        here = plan->index( (Task*)this );
-    DateTime   s    = XDateTime::MAX_DATETIME;
-
-    // loop through each subtask
-    for( int t = here+1 ; t <= m_summaryEnd ; t++ )
-    {
-      // if task isn't summary & isn't null, check if its start is before current earliest
-      Task*  task = plan->task( t );
-      if ( !task->isSummary() && !task->isNull() && task->m_start < s ) s = task->m_start;
-    }
-
-    return s;
+    int  here = plan->index( (Task*)this );
+    return plan->tasks()->store().earliestStart( here+1, m_summaryEnd );
   }
 
   return m_start;
@@ -466,21 +606,11 @@ DateTime Task::start() const
 
 DateTime Task::end() const
 {
-  // return task or summary end date-time
+  // return task or summary end date-time, summary from its subtasks in the task store
   if ( isSummary() )
   {
-    int        here = plan->index( (Task*)this );
-    DateTime   e    = XDateTime::MIN_DATETIME;
-
-    // loop through each subtask
-    for( int t = here+1 ; t <= m_summaryEnd ; t++ )
-    {
-      // if task isn't summary & isn't null, check if its end is after current latest
-      Task*  task = plan->task( t );
-      if ( !task->isSummary() && !task->isNull() && task->m_end > e ) e = task->m_end;
-    }
-
-    return e;
+    int  here = plan->index( (Task*)this );
+    return plan->tasks()->store().latestEnd( here+1, m_summaryEnd );
   }
 
   return m_end;
@@ -22,6 +22,7 @@
 #define TASK_H
 
 #include <QVariant>
+#include <QVector>
 #include <QString>
 
 #include "datetime.h"
@@ -30,8 +31,8 @@
 #include "ganttdata.h"
 #include "taskresources.h"
 
-class QXmlStreamWriter;
 class QXmlStreamReader;
+class Calendar;
 
 /*************************************************************************************************/
 /*************************************** Single plan task ****************************************/
@@ -39,12 +40,16 @@ class QXmlStreamReader;
 
 class Task
 {
+  friend class TaskStore;
 public:
   Task();                                                         // constructor (normal)
   Task( bool );                                                   // constructor (plan summary)
   Task( QXmlStreamReader* );                                      // constructor
 
-  void              saveToStream( QXmlStreamWriter* );            // write task data to xml stream
+  void              loadFromStream( QXmlStreamReader* );          // set task data from xml stream
+
+  QStringList       saveValues() const;                           // return task data formatted for saving
+  static QStringList  saveNames();                                // return xml attribute names of save values
 
   bool              isNull() const { return m_title.isNull(); }   // is this task null (blank)
   QString           name() const { return m_title; }              // return name of task (i.e. title)
@@ -55,6 +60,7 @@ public:
   int               priority() const { return m_priority; }       // return task priority
   DateTime          deadline() const { return m_deadline; }       // return task deadline (often null)
   GanttData*        ganttData() { return &m_gantt; }              // return pointer to gantt data
+  Calendar*         calendar();                                   // return calendar respecting assigned resources
 
   static QVariant   headerData( int );                            // return column header data
   QVariant          dataDisplayRole( int ) const;                 // return display text for cell
@@ -64,20 +70,28 @@ public:
   QVariant          dataToolTipRole( int ) const;                 // return tool tip text for cell
   QVariant          dataFontRole( int ) const;                    // return font for cell
   void              setData( int, const QVariant& );              // set data value for column
+  QVariant          dataUndoRole( int ) const;                    // return cell data exactly restorable for undo
+  void              restoreData( int, const QVariant& );          // restore cell data for undo, no edit defaults
 
   bool              isExpanded() const { return m_expanded; }     // if summary is it expanded to show subtasks
   bool              isSummary() const { return m_summaryEnd >= 0; }    // is this task a summary
   bool              isMilestone() const { return start() == end(); }   // is this a milestone
   int               summaryEnd() const { return m_summaryEnd; }   // return summary last sub-task id, or -1 if not summary
-  void              setNotSummary() { m_summaryEnd = -1; }        // set task to non-summary
-  void              setSummaryEnd( int s ) { m_summaryEnd = s; }  // set summary last sub-task id
+  void              setNotSummary() { setSummaryEnd( -1 ); }      // set task to non-summary
+  void              setSummaryEnd( int s ) { if ( s != m_summaryEnd ) m_version++;
+                                             m_summaryEnd = s; }  // set summary last sub-task id
   int               indent() const { return m_indent; }           // return task (or summary) indent level
-  void              setIndent( short i ) { m_indent = i; }        // set task indent level
+  void              setIndent( short i ) { if ( i != m_indent ) m_version++;
+                                           m_indent = i; }        // set task indent level
+  void              bumpVersion() { m_version++; }                // mark task display data as changed
+  void              releaseCaches();                              // release display & gantt caches until needed
+  int               bytes() const;                                // return approx memory held by task
 
   bool              predecessorsOK() const;                       // return true if no forbidden predecessors
   QString           predecessorsClean();                          // clean & return task predecessors
   QString           predecessorsString() const;                   // return task predecessors as string
-  void              setPredecessors( QString p ) { m_predecessors = p; }    // set task predecessors
+  void              setPredecessors( const Predecessors& p )
+                      { m_predecessors = p; m_version++; }        // set task predecessors
   bool              hasPredecessor( Task* ) const;                // return true if other task is predecessor of this task
   Predecessors&     predecessors() { return m_predecessors; }     // return task predecessors by reference
 
@@ -88,6 +102,7 @@ public:
   DateTime          endDueToPredecessors() const;                 // determine end based on predecessors
 
   static QString    typeToString( int );                          // return type string equivalent
+  QVariant          formatDisplay( int ) const;                   // return newly formatted display text for cell
 
   enum sections                 // sections to be displayed by view
   {
@@ -135,6 +150,18 @@ private:
   DateTime        m_deadline;        // task warning deadline
   float           m_cost;            // calculated cost based on resource use
   QString         m_comment;         // free text comment
+  Calendar*       m_calendar;        // plan calendar combined with assigned resources calendars
+  quint32         m_calendarVersion; // plan calendar version when combined, or zero to re-combine
+  bool            m_calendarClash;   // true if resources have no working time in common with plan
+
+  quint32                    m_version;          // incremented whenever task display data changes
+  mutable quint32            m_displayVersion;   // task version when display cache filled
+  mutable quint32            m_displayEpoch;     // tasks model display epoch when display cache filled
+  mutable quint16            m_displayValid;     // bit set for each column with valid cached display
+  mutable QVector<QVariant>  m_display;          // cached display data for each column
+  mutable QStringList        m_saved;            // cached save values, shared with snapshots being saved
+  mutable quint32            m_savedVersion;     // task version when save values cached
+  mutable quint32            m_savedEpoch;       // tasks model display epoch when save values cached
 };
 
 #endif // TASK_H
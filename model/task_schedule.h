@@ -25,6 +25,8 @@
 #include "plan.h"
 #include "calendar.h"
 #include "resource.h"
+#include "tasksmodel.h"
+#include "calendarsmodel.h"
 
 /*************************************************************************************************/
 /**************************** Scheduling methods for single plan task ****************************/
@@ -82,12 +84,12 @@ void  Task::schedule_ASAP_FDUR()
   // if this task doesn't have predecessors, does a summary?
   if ( !hasToStart && !hasToFinish )
   {
+    const TaskStore&  store = plan->tasks()->store();
     int index = plan->index( (Task*)this );
     for( int indent = m_indent ; indent > 0 ; indent-- )
     {
       // find task summary
-      while ( plan->task(index)->isNull() ||
-              plan->task(index)->indent() >= indent ) index--;
+      index = store.summaryAbove( index, indent );
 
       hasToStart  = plan->task(index)->predecessors().hasToStart();
       if ( hasToStart ) break;
@@ -96,21 +98,22 @@ void  Task::schedule_ASAP_FDUR()
     }
   }
 
-  Calendar*  planCal = plan->calendar();
+  // schedule using calendar combining plan calendar with assigned resources calendars
+  Calendar*  cal = calendar();
   if ( hasToStart )
   {
-    m_start = planCal->workUp( startDueToPredecessors() );
-    m_end   = planCal->workDown( planCal->addTimeSpan( m_start, m_duration ) );
+    m_start = cal->workUp( startDueToPredecessors() );
+    m_end   = cal->workDown( cal->addTimeSpan( m_start, m_duration ) );
   }
   else if ( hasToFinish )
   {
-    m_end   = planCal->workDown( endDueToPredecessors() );
-    m_start = planCal->workUp( planCal->addTimeSpan( m_end, -m_duration ) );
+    m_end   = cal->workDown( endDueToPredecessors() );
+    m_start = cal->workUp( cal->addTimeSpan( m_end, -m_duration ) );
   }
   else
   {
-    m_start = planCal->workUp( plan->start() );
-    m_end   = planCal->workDown( planCal->addTimeSpan( m_start, m_duration ) );
+    m_start = cal->workUp( plan->start() );
+    m_end   = cal->workDown( cal->addTimeSpan( m_start, m_duration ) );
     if ( m_end > XDateTime::MAX_DATETIME ) m_end = XDateTime::MIN_DATETIME;
   }
 
@@ -167,6 +170,41 @@ void  Task::schedule_ASAP_FDUR()
          qPrintable(m_title), qPrintable(XDateTime::toString(m_start)), qPrintable(XDateTime::toString(m_end)) );
 }
 
+/******************************************* calendar ********************************************/
+
+Calendar*  Task::calendar()
+{
+  // combined calendar only re-calculated if task resources, resources or calendars changed
+  quint32  version = plan->calendarVersion();
+  if ( m_calendarVersion == version ) return m_calendar;
+  m_calendarVersion = version;
+
+  // task can work when plan calendar and any of its assigned resources calendars are working
+  CalendarCombiner&  combiner = plan->calendars()->combiner();
+  Calendar*          resCal   = nullptr;
+
+  m_resources.process();
+  foreach( Resource* res, m_resources.alloc.keys() )
+  {
+    if ( res->calendar() == nullptr ) continue;
+    if ( resCal == nullptr ) resCal = res->calendar();
+    else                     resCal = combiner.unite( resCal, res->calendar() );
+  }
+
+  // if no resources assigned, task simply uses plan calendar
+  m_calendarClash = false;
+  if ( resCal == nullptr )
+  {
+    m_calendar = plan->calendar();
+    return m_calendar;
+  }
+
+  // combiner returns plan calendar itself if no working time in common, flagged for tool tip
+  m_calendar      = combiner.intersect( plan->calendar(), resCal );
+  m_calendarClash = ( m_calendar == plan->calendar() && resCal != plan->calendar() );
+  return m_calendar;
+}
+
 /************************************ startDueToPredecessors *************************************/
 
 DateTime  Task::startDueToPredecessors() const
@@ -175,12 +213,12 @@ DateTime  Task::startDueToPredecessors() const
   DateTime  start = m_predecessors.start();
 
   // if indented also check start against summary(s) predecessors
+  const TaskStore&  store = plan->tasks()->store();
   int index = plan->index( (Task*)this );
   for( int indent = m_indent ; indent > 0 ; indent-- )
   {
     // find task summary
-    while ( plan->task(index)->isNull() ||
-            plan->task(index)->indent() >= indent ) index--;
+    index = store.summaryAbove( index, indent );
 
     // if start from summary predecessors is later, use it instead
     DateTime summaryStart = plan->task(index)->predecessors().start();
@@ -198,12 +236,12 @@ DateTime  Task::endDueToPredecessors() const
   DateTime  end = m_predecessors.end();
 
   // if indented also check end against summary(s) predecessors
+  const TaskStore&  store = plan->tasks()->store();
   int index = plan->index( (Task*)this );
   for( int indent = m_indent ; indent > 0 ; indent-- )
   {
     // find task summary
-    while ( plan->task(index)->isNull() ||
-            plan->task(index)->indent() >= indent ) index--;
+    index = store.summaryAbove( index, indent );
 
     // if end from summary predecessors is later, use it instead
     DateTime summaryEnd = plan->task(index)->predecessors().end();
@@ -0,0 +1,102 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "taskintervals.h"
+#include "taskstore.h"
+
+#include <algorithm>
+
+/*************************************************************************************************/
+/************** Index of task gantt intervals for finding tasks active in a time window **********/
+/*************************************************************************************************/
+
+/****************************************** constructor ******************************************/
+
+TaskIntervals::TaskIntervals()
+{
+}
+
+/********************************************* build *********************************************/
+
+void TaskIntervals::build( const TaskStore& store )
+{
+  // collect non-null tasks with valid gantt data
+  QVector<int>  ids;
+  ids.reserve( store.size() );
+  for( int id=0 ; id<store.size() ; id++ )
+    if ( !store.isNull(id) && store.ganttStart(id) != XDateTime::NULL_DATETIME ) ids.append( id );
+
+  // sort by gantt start so tasks starting after range can be skipped
+  std::stable_sort( ids.begin(), ids.end(), [&store]( int a, int b )
+    { return store.ganttStart(a) < store.ganttStart(b); } );
+
+  int  size = ids.size();
+  m_ids = ids;
+  m_start.resize( size );
+  m_end.resize( size );
+  m_maxEnd.resize( size );
+  for( int i=0 ; i<size ; i++ )
+  {
+    m_start[i] = store.ganttStart( ids.at(i) );
+    m_end[i]   = store.ganttEnd( ids.at(i) );
+  }
+
+  // max end per sub-tree so sub-trees ending before range can be skipped
+  fillMaxEnd( 0, size );
+}
+
+/****************************************** fillMaxEnd *******************************************/
+
+DateTime TaskIntervals::fillMaxEnd( int lo, int hi )
+{
+  // fill and return latest end for implicit sub-tree of [lo,hi) rooted at middle
+  if ( lo >= hi ) return 0;
+  int       mid = ( lo + hi ) / 2;
+  DateTime  max = qMax( m_end.at(mid), qMax( fillMaxEnd( lo, mid ), fillMaxEnd( mid+1, hi ) ) );
+  m_maxEnd[mid] = max;
+  return max;
+}
+
+/******************************************** between ********************************************/
+
+QVector<int> TaskIntervals::between( DateTime start, DateTime end ) const
+{
+  // return ids (ascending) of tasks whose gantt start to end intersects range
+  QVector<int>  ids;
+  search( 0, m_ids.size(), start, end, ids );
+  std::sort( ids.begin(), ids.end() );
+  return ids;
+}
+
+/********************************************* search ********************************************/
+
+void TaskIntervals::search( int lo, int hi, DateTime start, DateTime end, QVector<int>& ids ) const
+{
+  // skip sub-tree if empty or every task in it ends before range
+  if ( lo >= hi ) return;
+  int  mid = ( lo + hi ) / 2;
+  if ( m_maxEnd.at(mid) < start ) return;
+
+  // left sub-tree starts no later than middle, right sub-tree only if middle starts within range
+  search( lo, mid, start, end, ids );
+  if ( m_start.at(mid) > end ) return;
+  if ( m_end.at(mid) >= start ) ids.append( m_ids.at(mid) );
+  search( mid+1, hi, start, end, ids );
+}
@@ -0,0 +1,54 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TASKINTERVALS_H
+#define TASKINTERVALS_H
+
+#include <QVector>
+
+#include "datetime.h"
+
+class TaskStore;
+
+/*************************************************************************************************/
+/************** Index of task gantt intervals for finding tasks active in a time window **********/
+/*************************************************************************************************/
+
+class TaskIntervals
+{
+public:
+  TaskIntervals();                                         // constructor
+
+  void          build( const TaskStore& );                 // rebuild index from task store gantt data
+  QVector<int>  between( DateTime, DateTime ) const;       // return ids of tasks intersecting range
+
+private:
+  DateTime      fillMaxEnd( int, int );                    // fill max end for implicit sub-tree
+  void          search( int, int, DateTime, DateTime,
+                        QVector<int>& ) const;             // collect ids in implicit sub-tree
+
+  // tasks sorted by gantt start, forming implicit balanced tree with each sub-tree rooted at middle
+  QVector<int>       m_ids;         // task id
+  QVector<DateTime>  m_start;       // task gantt start
+  QVector<DateTime>  m_end;         // task gantt end
+  QVector<DateTime>  m_maxEnd;      // latest gantt end within sub-tree rooted here
+};
+
+#endif // TASKINTERVALS_H
@@ -34,32 +34,58 @@ TaskResources::TaskResources()
 
 /****************************************** constructor ******************************************/
 
-TaskResources::TaskResources( QString text )
+TaskResources::TaskResources( const QString& text )
 {
-  // split text into individual assignments
+  // construct from text
+  parse( Scanner( &text ) );
+}
+
+/****************************************** constructor ******************************************/
+
+TaskResources::TaskResources( const QStringRef& text )
+{
+  // construct from text ref, avoids temporary strings when loading
+  parse( Scanner( text ) );
+}
+
+/********************************************* parse *********************************************/
+
+void TaskResources::parse( Scanner scan )
+{
+  // scan text for individual assignments in place
   m_res.clear();
-  QString tag, max;
-  foreach( QString part, text.split( ',', QString::SkipEmptyParts ) )
+  QStringRef  part, tag, max;
+  while ( scan.nextPart( ',', part ) )
   {
-    // split part into tag and max assignment
-    if ( part.contains('[') )
-    {
-      tag = part.section( '[', 0, 0 ).simplified();
-      max = part.section( '[', 1 ).remove( ']' );
-    }
-    else
-    {
-      tag = part.simplified();
-      max = "0";
-    }
+    split( part, tag, max );
 
     Assignment ass;
-    ass.tag = tag;
-    ass.max = max.toFloat();
+    ass.tag = XTag::tag( tag.toString().simplified() );
+    ass.max = max.isNull() ? 0.0f : max.toFloat();
     m_res.append( ass );
   }
 }
 
+/********************************************* split *********************************************/
+
+void TaskResources::split( const QStringRef& part, QStringRef& tag, QStringRef& max )
+{
+  // split part into tag and optional max assignment within '[' and ']', max null if none
+  int open = part.indexOf( '[' );
+  if ( open < 0 )
+  {
+    tag = part;
+    max = QStringRef();
+    return;
+  }
+
+  tag = Scanner::trimmed( Scanner::mid( part, 0, open ) );
+  max = Scanner::mid( part, open + 1 );
+  int close = max.indexOf( ']' );
+  if ( close >= 0 ) max = Scanner::mid( max, 0, close );
+  max = Scanner::trimmed( max );
+}
+
 /******************************************** toString *******************************************/
 
 QString TaskResources::toString() const
@@ -69,7 +95,7 @@ QString TaskResources::toString() const
   // build up string equivalent
   foreach( Assignment ass, m_res )
   {
-    str += ass.tag;
+    str += XTag::string( ass.tag );
     if ( ass.max > 0.0 ) str += QString( "[%1]" ).arg( ass.max );
     str += ", ";
   }
@@ -91,29 +117,23 @@ bool TaskResources::isEmpty() const
 
 QString TaskResources::validate( const QString& text )
 {
-  // split text into individual assignments
-  QString error, tag, max;
-  foreach( QString part, text.split( ',', QString::SkipEmptyParts ) )
+  // scan text for individual assignments in place, only building strings for errors
+  QString     error;
+  Scanner     scan( &text );
+  QStringRef  part, tagRef, max;
+  while ( scan.nextPart( ',', part ) )
   {
-    // split part into tag and max assignment
-    if ( part.contains( '[' ) )
-    {
-      tag = part.section( '[', 0, 0 ).simplified();
-      max = part.section( '[', 1 ).remove( ']' );
-    }
-    else
-    {
-      tag = part.simplified();
-      max = "0";
-    }
+    split( part, tagRef, max );
 
+    QString tag = tagRef.toString().simplified();
     if ( !plan->resources()->isAssignable( tag ) )
       error += QString( "'%1' is not an assignable resource.\n" ).arg( tag );
 
+    if ( max.isNull() ) continue;
     bool ok;
     float num = max.toFloat( &ok );
     if ( !ok || num < 0.0 )
-      error += QString( "'%1' is not a valid number for '%2'.\n" ).arg( max ).arg( tag );
+      error += QString( "'%1' is not a valid number for '%2'.\n" ).arg( max.toString() ).arg( tag );
   }
 
   // remove final '\n' and return validation error text
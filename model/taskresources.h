@@ -25,6 +25,9 @@
 #include <QList>
 #include <QHash>
 
+#include "tag.h"
+#include "scanner.h"
+
 class Resource;
 
 /*************************************************************************************************/
@@ -35,7 +38,8 @@ class TaskResources
 {
 public:
   TaskResources();                                   // constructor
-  TaskResources( QString );                          // constructor
+  TaskResources( const QString& );                   // constructor
+  TaskResources( const QStringRef& );                // constructor
 
   QString         toString() const;                  // return string for display in tasks view
   bool            isEmpty() const;                   // return true if no resources allocated
@@ -46,11 +50,14 @@ public:
 
   struct Assignment
   {
-    QString   tag;        // initials or name or org or group or alias or role etc
+    Tag       tag;        // initials or name or org or group or alias or role etc
     float     max;        // 0 (zero) means unlimited
   };
 
 private:
+  void            parse( Scanner );                  // parse assignments text into list
+  static void     split( const QStringRef&, QStringRef&, QStringRef& );  // split part into tag and max
+
   QList<Assignment>    m_res;       // list of resource assignments in original string format
 };
 
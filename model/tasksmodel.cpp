@@ -20,10 +20,14 @@
 
 #include "tasksmodel.h"
 #include "task.h"
+#include "plan.h"
 
 #include "command/commandtasksetdata.h"
 #include "command/commandtaskindent.h"
 #include "command/commandtaskoutdent.h"
+#include "command/commandtaskpaste.h"
+
+#include "plansnapshot.h"
 
 #include <QXmlStreamWriter>
 
@@ -33,18 +37,23 @@
 
 /****************************************** constructor ******************************************/
 
-TasksModel::TasksModel() : QAbstractTableModel()
+TasksModel::TasksModel() : QAbstractTableModel(), m_pool( POOL_BLOCK )
 {
   // create plan summary task, also known as task zero, usually hidden
-  m_tasks.append( new Task(true) );
+  m_displayEpoch    = 0;
+  m_stretchVersion  = 0;
+  m_heldFirst       = -1;
+  m_heldLast        = -1;
+  m_tasks.append( m_pool.create(true) );
+  m_store.rebuild( m_tasks );
 }
 
 /****************************************** destructor *******************************************/
 
 TasksModel::~TasksModel()
 {
-  // delete all tasks in model
-  foreach( Task* t, m_tasks ) delete t;
+  // destroy all tasks in model in one go
+  m_pool.clear();
 }
 
 /****************************************** initialise *******************************************/
@@ -52,16 +61,17 @@ TasksModel::~TasksModel()
 void TasksModel::initialise()
 {
   // create initial plan blank tasks
-  m_tasks.append( new Task() );
-  m_tasks.append( new Task() );
-  m_tasks.append( new Task() );
-  m_tasks.append( new Task() );
-  m_tasks.append( new Task() );
-  m_tasks.append( new Task() );
-  m_tasks.append( new Task() );
-  m_tasks.append( new Task() );
-  m_tasks.append( new Task() );
-  m_tasks.append( new Task() );
+  m_tasks.append( m_pool.create() );
+  m_tasks.append( m_pool.create() );
+  m_tasks.append( m_pool.create() );
+  m_tasks.append( m_pool.create() );
+  m_tasks.append( m_pool.create() );
+  m_tasks.append( m_pool.create() );
+  m_tasks.append( m_pool.create() );
+  m_tasks.append( m_pool.create() );
+  m_tasks.append( m_pool.create() );
+  m_tasks.append( m_pool.create() );
+  m_store.rebuild( m_tasks );
 }
 
 /********************************************* task **********************************************/
@@ -86,37 +96,51 @@ int TasksModel::number()
   return count;
 }
 
-/***************************************** saveToStream ******************************************/
+/**************************************** saveToSnapshot *****************************************/
 
-void  TasksModel::saveToStream( QXmlStreamWriter* stream )
+void  TasksModel::saveToSnapshot( PlanSnapshot* snapshot )
 {
-  // write tasks data to xml stream
-  stream->writeStartElement( "tasks-data" );
-
+  // capture task save values, cached by each task so only tasks changed since last save are
+  // re-formatted, and predecessors which depend on task ids so are always re-formatted
+  QVector<QStringList>  values( m_tasks.size() );
+  QVector<QString>      preds( m_tasks.size() );
   foreach( Task* t, m_tasks )
   {
-    // don't write 'plan summary' task 0
-    if ( plan->index(t) == 0 ) continue;
-
-    stream->writeStartElement( "task" );
-    stream->writeAttribute( "id", QString("%1").arg(plan->index(t)) );
-    if ( !t->isNull() ) t->saveToStream( stream );
-    stream->writeEndElement();
+    int id = plan->index(t);
+    if ( !t->isNull() ) values[id] = t->saveValues();
+    if ( !t->predecessors().list().isEmpty() ) preds[id] = t->predecessorsString();
   }
 
-  foreach( Task* t, m_tasks )
+  // write tasks data to xml stream later from captured values
+  snapshot->defer( [values, preds]( QXmlStreamWriter* stream )
   {
-    if ( !t->predecessorsString().isEmpty() )
+    QStringList  names = Task::saveNames();
+    stream->writeStartElement( "tasks-data" );
+
+    // don't write 'plan summary' task 0
+    for( int id = 1 ; id < values.size() ; id++ )
     {
-      stream->writeStartElement( "predecessors" );
-      stream->writeAttribute( "task", QString("%1").arg(plan->index(t)) );
-      stream->writeAttribute( "preds", t->predecessorsString() );
+      stream->writeStartElement( "task" );
+      stream->writeAttribute( "id", QString("%1").arg(id) );
+      for( int n = 0 ; n < values.at(id).size() ; n++ )
+        stream->writeAttribute( names.at(n), values.at(id).at(n) );
       stream->writeEndElement();
     }
-  }
 
-  // close tasks-data element
-  stream->writeEndElement();
+    for( int id = 0 ; id < preds.size() ; id++ )
+    {
+      if ( !preds.at(id).isEmpty() )
+      {
+        stream->writeStartElement( "predecessors" );
+        stream->writeAttribute( "task", QString("%1").arg(id) );
+        stream->writeAttribute( "preds", preds.at(id) );
+        stream->writeEndElement();
+      }
+    }
+
+    // close tasks-data element
+    stream->writeEndElement();
+  } );
 }
 
 /**************************************** loadFromStream *****************************************/
@@ -130,26 +154,38 @@ void  TasksModel::loadFromStream( QXmlStreamReader* stream )
 
     // if task element create new task
     if ( stream->isStartElement() && stream->name() == "task" )
-      m_tasks.append( new Task(stream) );
+      m_tasks.append( m_pool.create(stream) );
 
     // if predecessors element update task
     if ( stream->isStartElement() && stream->name() == "predecessors" )
-    {
-      int      task = -1;
-      QString  preds;
-      foreach( QXmlStreamAttribute attribute, stream->attributes() )
-      {
-        if ( attribute.name() == "task" ) task  = attribute.value().toString().toInt();
-        if ( attribute.name() == "preds") preds = attribute.value().toString();
-      }
-      plan->task( task )->setPredecessors( preds );
-    }
+      loadPredecessors( stream );
 
     // when reached end of tasks data break out of loop
     if ( stream->isEndElement() && stream->name() == "tasks-data" ) break;
   }
 
-  // ensure summaries are set correctly
+  loadFinished();
+}
+
+/*************************************** loadPredecessors ****************************************/
+
+void  TasksModel::loadPredecessors( QXmlStreamReader* stream )
+{
+  // set task predecessors from predecessors element, all tasks must already be loaded
+  QXmlStreamAttributes  attributes = stream->attributes();
+  int  task = attributes.value( "task" ).toInt();
+  if ( task < 1 || task >= m_tasks.size() )
+    stream->raiseError( QString("Predecessors for invalid task '%1'").arg(task) );
+  else
+    plan->task( task )->setPredecessors( Predecessors( attributes.value( "preds" ) ) );
+}
+
+/***************************************** loadFinished ******************************************/
+
+void  TasksModel::loadFinished()
+{
+  // ensure task store and summaries are set correctly once all tasks loaded
+  m_store.rebuild( m_tasks );
   setSummaries();
 }
 
@@ -157,8 +193,11 @@ void  TasksModel::loadFromStream( QXmlStreamReader* stream )
 
 void TasksModel::schedule()
 {
-  // re-schedule tasks - first construct list of tasks in correct order
+  // re-schedule tasks - first ensure task store fields are synchronised with edited tasks
   qDebug("TasksModel::schedule() -------------------- cycle started ----------------------");
+  m_store.refresh( m_tasks );
+
+  // construct list of tasks in correct order
   QList<Task*>   scheduleList;
   scheduleList.reserve( m_tasks.size() );
 
@@ -171,31 +210,124 @@ void TasksModel::schedule()
   //TODO foreach( Task* t, scheduleList )
   //TODO   t->resourceProcess();
 
-  // re-schedule each task
+  // re-schedule each task, keeping task store up-to-date for summaries and successors
+  // bumping version of tasks whose display has changed (summaries always as depend on sub-tasks)
+  QVector<bool>  changed( m_tasks.size(), false );
   foreach( Task* t, scheduleList )
   {
     //---------qDebug("Post sort %i %s",plan->index(t),qPrintable(t->name()));
+    int  id = index(t);
     t->schedule();
+    changed[id] = !t->isSummary() &&
+                  ( t->start() != m_store.start( id ) || t->end() != m_store.end( id ) );
+    if ( t->isSummary() || changed[id] ) t->bumpVersion();
+    m_store.update( id, t );
   }
 
-  // now scheduling has completed update both tasks table view and gantt view
-  emit dataChanged( QAbstractTableModel::index( 0, 0 ), QAbstractTableModel::index( rowCount(), columnCount() ) );
-  emit ganttChanged();
+  // now scheduling has completed update changed rows of both tasks table view and gantt view
+  emitScheduleChanges( changed );
   plan->signalPlanUpdated();
 }
 
-/***************************************** planBeginning *****************************************/
+/****************************************** tasksBetween *****************************************/
 
-DateTime TasksModel::planBeginning()
+QList<Task*> TasksModel::tasksBetween( DateTime start, DateTime end )
 {
-  // return start of earliest starting task
-  DateTime  first = XDateTime::NULL_DATETIME;
-  foreach( Task* t, m_tasks )
+  // return tasks whose gantt start to end intersects the date-time range
+  QList<Task*>  tasks;
+  foreach( int id, m_store.between( start, end ) )
+    tasks.append( m_tasks.at(id) );
+
+  return tasks;
+}
+
+/************************************** emitScheduleChanges **************************************/
+
+void TasksModel::emitScheduleChanges( QVector<bool>& changed )
+{
+  // summaries changed if any sub-task changed or was edited (its work, duration or resources are
+  // aggregated even when no dates move), or all if calendars, days, default calendar or stretching
+  // changed since last scheduled, as those also change every gantt row's shading & bars
+  int            count = changed.size();
+  QVector<bool>  edited( changed );
+  foreach( int row, m_edited )
+    if ( row >= 0 && row < count ) edited[row] = true;
+  m_edited.clear();
+
+  QVector<int>  before( count + 1, 0 );     // number of changed or edited rows before each row
+  for( int row=0 ; row<count ; row++ ) before[row+1] = before[row] + ( edited[row] ? 1 : 0 );
+
+  quint32  version = plan->stretchVersion();
+  bool     calendarsEdited = ( version != m_stretchVersion );
+  m_stretchVersion = version;
+  for( int row=0 ; row<count ; row++ )
+    if ( !m_store.isNull(row) && m_store.isSummary(row) )
+      changed[row] = calendarsEdited || before[ m_store.summaryEnd(row) + 1 ] > before[row + 1];
+
+  // gantt rows to redraw also span dependency links to or from changed rows (+1 at span start, -1 after)
+  QVector<int>  gantt( count + 1, 0 );
+  for( int row=0 ; row<count ; row++ )
   {
-    if ( !t->isNull() && first == XDateTime::NULL_DATETIME ) first = t->start();
-    if ( !t->isNull() && t->start() < first ) first = t->start();
+    if ( changed[row] ) { gantt[row]++; gantt[row+1]--; }
+    if ( m_store.isNull(row) ) continue;
+
+    foreach( const Predecessors::Predecessor& pred, m_tasks.at(row)->predecessors().list() )
+    {
+      int other = index( pred.task );
+      if ( other < 0 || ( !changed[row] && !changed[other] ) ) continue;
+      gantt[ qMin( row, other ) ]++;
+      gantt[ qMax( row, other ) + 1 ]--;
+    }
+  }
+
+  // if plan held, join changed rows and gantt rows to redraw to held rows to be signalled once
+  if ( plan->isHeld() )
+  {
+    if ( calendarsEdited && count > 0 ) holdChanges( 0, count - 1 );
+    int  spans = 0;
+    for( int row=0 ; row<count ; row++ )
+    {
+      spans += gantt[row];
+      if ( changed[row] || spans > 0 ) holdChanges( row, row );
+    }
+    return;
+  }
+
+  // emit data changed for each run of changed rows
+  for( int row=0 ; row<count ; row++ )
+  {
+    if ( !changed[row] ) continue;
+    int first = row;
+    while ( row+1 < count && changed[row+1] ) row++;
+    emit dataChanged( QAbstractTableModel::index( first, 0 ),
+                      QAbstractTableModel::index( row, columnCount()-1 ) );
   }
 
+  // emit gantt changed for whole chart if calendars edited, otherwise each run of rows needing redraw
+  if ( calendarsEdited )
+  {
+    emit ganttChanged( 0, rowCount() - 1 );
+    return;
+  }
+
+  int  spans = 0;
+  for( int row=0 ; row<count ; row++ )
+  {
+    spans += gantt[row];
+    if ( spans <= 0 ) continue;
+    int first = row;
+    while ( row+1 < count && spans + gantt[row+1] > 0 ) spans += gantt[++row];
+    emit ganttChanged( first, row );
+  }
+}
+
+/***************************************** planBeginning *****************************************/
+
+DateTime TasksModel::planBeginning()
+{
+  // return start of earliest starting task (summaries can be ignored as span their subtasks)
+  DateTime  first = m_store.earliestStart( 0, m_store.size()-1 );
+  if ( first == XDateTime::MAX_DATETIME ) return XDateTime::NULL_DATETIME;
   return first;
 }
 
@@ -203,14 +335,9 @@ DateTime TasksModel::planBeginning()
 
 DateTime TasksModel::planEnd()
 {
-  // return finish of latest finishing task
-  DateTime  end = XDateTime::NULL_DATETIME;
-  foreach( Task* t, m_tasks )
-  {
-    if ( !t->isNull() && end == XDateTime::NULL_DATETIME ) end = t->end();
-    if ( !t->isNull() && t->end() > end ) end = t->end();
-  }
-
+  // return finish of latest finishing task (summaries can be ignored as span their subtasks)
+  DateTime  end = m_store.latestEnd( 0, m_store.size()-1 );
+  if ( end == XDateTime::MIN_DATETIME ) return XDateTime::NULL_DATETIME;
   return end;
 }
 
@@ -272,7 +399,7 @@ bool TasksModel::setData( const QModelIndex& index, const QVariant& value, int r
   if ( value == data( index, role ) ) return false;
 
   // set data via undo/redo command
-  plan->undostack()->push( new CommandTaskSetData( index, value ) );
+  plan->push( new CommandTaskSetData( index, value ) );
   return true;
 }
 
@@ -316,9 +443,43 @@ Qt::ItemFlags TasksModel::flags( const QModelIndex& index ) const
 
 void TasksModel::emitDataChangedRow( int row )
 {
-  // emit data changed signal for row
+  // note row edited, as summaries over it may change even if scheduling moves no dates
+  m_edited.append( row );
+
+  // if plan held, extend range of held rows to be signalled once released
+  if ( plan->isHeld() )
+  {
+    holdChanges( row, row );
+    return;
+  }
+
+  // emit data changed signal for row, including its gantt row
   emit dataChanged( QAbstractTableModel::index( row, 0 ),
                     QAbstractTableModel::index( row, columnCount() ) );
+  emit ganttChanged( row, row );
+}
+
+/****************************************** holdChanges ******************************************/
+
+void TasksModel::holdChanges( int first, int last )
+{
+  // extend range of rows changed while plan held, signalled once when released
+  if ( m_heldFirst < 0 || first < m_heldFirst ) m_heldFirst = first;
+  if ( last > m_heldLast ) m_heldLast = last;
+}
+
+/**************************************** emitHeldChanges ****************************************/
+
+void TasksModel::emitHeldChanges()
+{
+  // emit one data changed signal covering all rows changed while plan held, including by scheduling
+  if ( m_heldFirst < 0 ) return;
+  m_heldLast = qMin( m_heldLast, m_tasks.size() - 1 );
+  emit dataChanged( QAbstractTableModel::index( m_heldFirst, 0 ),
+                    QAbstractTableModel::index( m_heldLast, columnCount()-1 ) );
+  emit ganttChanged( m_heldFirst, m_heldLast );
+  m_heldFirst = -1;
+  m_heldLast  = -1;
 }
 
 /************************************* emitDataChangedColumn *************************************/
@@ -336,10 +497,15 @@ void TasksModel::setSummaries()
 {
   // recalc summaries for all tasks, start by assembling list of non-null tasks
   QList<Task*>  nonNull;
+  QList<int>    nonNullId;
   for( int t = 0 ; t < m_tasks.size() ; t++ )
   {
     Task*  task = m_tasks.at( t );
-    if ( !task->isNull() ) nonNull.append( task );
+    if ( !task->isNull() )
+    {
+      nonNull.append( task );
+      nonNullId.append( t );
+    }
   }
 
   // last non-null task cannot be summary
@@ -358,9 +524,13 @@ void TasksModel::setSummaries()
     {
       int last = t + 1;
       while ( last+1 < nonNull.size() && indent < nonNull.at(last+1)->indent() ) last++;
-      nonNull.at(t)->setSummaryEnd( plan->index( nonNull.at(last) ) );
+      nonNull.at(t)->setSummaryEnd( nonNullId.at(last) );
     }
   }
+
+  // keep task store summary & indent fields synchronised
+  foreach( int id, nonNullId )
+    m_store.update( id, m_tasks.at(id) );
 }
 
 /*************************************** nonNullTaskAbove ****************************************/
@@ -421,8 +591,10 @@ bool  TasksModel::indentRows( QSet<int> rows )
   // check for predecessors that would become forbidden
   //TODO if ( predecessorsIndentOk( rows ) == false ) return false;
 
-  // do indenting via undo/redo command
-  plan->undostack()->push( new CommandTaskIndent( rows ) );
+  // do indenting via undo/redo command, batched so rows are scheduled and signalled once
+  plan->beginBatch( "Indent" );
+  plan->push( new CommandTaskIndent( rows ) );
+  plan->endBatch();
 
   // return true to say successful indenting
   return true;
@@ -447,9 +619,280 @@ bool  TasksModel::outdentRows( QSet<int> rows )
   // check for predecessors that would become forbidden
   //TODO if ( predecessorsOutdentOk( rows ) == false ) return false;
 
-  // do outdenting via undo/redo command
-  plan->undostack()->push( new CommandTaskOutdent( rows ) );
+  // do outdenting via undo/redo command, batched so rows are scheduled and signalled once
+  plan->beginBatch( "Outdent" );
+  plan->push( new CommandTaskOutdent( rows ) );
+  plan->endBatch();
 
   // return true to say successful outdenting
   return true;
 }
+
+/******************************************* appendRows ******************************************/
+
+void  TasksModel::appendRows( int count )
+{
+  // append null tasks to end of model, signalling views once for all new rows
+  beginInsertRows( QModelIndex(), m_tasks.size(), m_tasks.size() + count - 1 );
+  for( int n = 0 ; n < count ; n++ )
+    m_tasks.append( m_pool.create() );
+  m_store.rebuild( m_tasks );
+  endInsertRows();
+}
+
+/***************************************** removeLastRows ****************************************/
+
+void  TasksModel::removeLastRows( int count )
+{
+  // remove tasks from end of model, these are always the most recently created in pool
+  beginRemoveRows( QModelIndex(), m_tasks.size() - count, m_tasks.size() - 1 );
+  for( int n = 0 ; n < count ; n++ )
+  {
+    m_tasks.removeLast();
+    m_pool.destroyLast();
+  }
+  m_store.rebuild( m_tasks );
+  endRemoveRows();
+}
+
+/******************************************* parseText *******************************************/
+
+QList<QStringList>  TasksModel::parseText( const QString& text )
+{
+  // parse tab separated text in one pass, a line per row and a tab between cells, where a cell
+  // starting with a quote runs to the closing quote so may contain tabs and new-lines ("" is a quote)
+  QList<QStringList>  lines;
+  QStringList         cells;
+  int                 size = text.size();
+  int                 pos  = 0;
+  forever
+  {
+    QString  cell;
+    int      first = pos;
+    while ( first < size && text.at(first) == ' ' ) first++;
+    if ( first < size && text.at(first) == '"' )
+    {
+      pos = first + 1;
+      forever
+      {
+        int  quote = text.indexOf( '"', pos );
+        if ( quote < 0 ) quote = size;
+        cell += text.mid( pos, quote - pos );
+        pos = quote + 1;
+        if ( pos >= size || text.at(pos) != '"' ) break;
+        cell += '"';
+        pos++;
+      }
+      pos = qMin( pos, size );
+    }
+
+    // unquoted text, or any after closing quote, runs to next tab or new-line
+    int  end = pos;
+    while ( end < size && text.at(end) != '\t' && text.at(end) != '\n' ) end++;
+    cell += text.mid( pos, end - pos ).trimmed();
+    cells.append( cell );
+    pos = end;
+
+    if ( pos == size || text.at(pos) == '\n' )
+    {
+      lines.append( cells );
+      cells.clear();
+      if ( pos == size ) break;
+    }
+    pos++;
+  }
+
+  return lines;
+}
+
+/********************************************* paste *********************************************/
+
+QString  TasksModel::paste( int row, int column, QList<QStringList> lines )
+{
+  // ignore empty line after final new-line, and task 0 'plan summary' cannot be pasted over
+  if ( !lines.isEmpty() && lines.last().join( QString() ).isEmpty() ) lines.removeLast();
+  if ( lines.isEmpty() ) return QString();
+  if ( row < 1 ) row = 1;
+  int  newRows = qMax( 0, row + lines.size() - m_tasks.size() );
+  int  total   = m_tasks.size() + newRows;
+
+  // determine which tasks will exist after paste, those currently null need a pasted title
+  QVector<bool>  exists( total, false );
+  for( int t = 1 ; t < m_tasks.size() ; t++ )
+    exists[t] = !m_tasks.at(t)->isNull();
+
+  int  title = Task::SECTION_TITLE - column;
+  for( int r = 0 ; r < lines.size() && title >= 0 ; r++ )
+    if ( title < lines.at(r).size() && !lines.at(r).at(title).isEmpty() ) exists[ row + r ] = true;
+
+  // convert cells to values, validating against the tasks and resources that will exist
+  QString                       errors;
+  int                           failures = 0;
+  QVector< QVector<QVariant> >  values( lines.size() );
+  QVector< QList<int> >         depends( total );
+  QVector<bool>                 pastedPreds( total, false );
+  for( int r = 0 ; r < lines.size() && failures < MAX_PASTE_ERRORS ; r++ )
+  {
+    int  id = row + r;
+    values[r].resize( lines.at(r).size() );
+    for( int c = 0 ; c < lines.at(r).size() ; c++ )
+    {
+      // empty cells leave task unchanged, cost is calculated so never pasted
+      const QString&  cell = lines.at(r).at(c);
+      int             col  = column + c;
+      if ( cell.isEmpty() || col > Task::SECTION_MAXIMUM || col == Task::SECTION_COST ) continue;
+
+      if ( !exists.at(id) )
+      {
+        errors += QString( "Task %1 has no title.\n" ).arg( id );
+        failures++;
+        break;
+      }
+
+      // summaries have some cells not editable, these are skipped
+      if ( id < m_tasks.size() && m_tasks.at(id)->isSummary() &&
+           !( flags( QAbstractTableModel::index( id, col ) ) & Qt::ItemIsEditable ) ) continue;
+
+      QString   error;
+      QVariant  value;
+      switch ( col )
+      {
+        case Task::SECTION_TITLE:
+        case Task::SECTION_COMMENT:
+          value = cell;
+          break;
+
+        case Task::SECTION_DURATION:
+        case Task::SECTION_WORK:
+          if ( TimeSpan( cell ).isValid() ) value = cell;
+          else error = QString( "'%1' is not a valid time span." ).arg( cell );
+          break;
+
+        case Task::SECTION_START:
+        case Task::SECTION_END:
+        case Task::SECTION_DEADLINE:
+        {
+          QDateTime  dt = QDateTime::fromString( cell, plan->datetimeFormat() );
+          if ( dt.isValid() ) value = dt;
+          else error = QString( "'%1' is not a valid date-time." ).arg( cell );
+          break;
+        }
+
+        case Task::SECTION_PREDS:
+        {
+          QString  preds = cell.simplified();
+          error = Predecessors::validate( preds, id, exists, depends[id] );
+          value = preds;
+          pastedPreds[id] = true;
+          break;
+        }
+
+        case Task::SECTION_RES:
+        {
+          QString  res = cell.simplified();
+          error = TaskResources::validate( res );
+          value = res;
+          break;
+        }
+
+        case Task::SECTION_TYPE:
+        {
+          bool  ok;
+          int   type = cell.toInt( &ok );
+          for( int t = Task::TYPE_ASAP_FDUR ; t <= Task::TYPE_FIXED_PERIOD && !ok ; t++ )
+            if ( cell == Task::typeToString( t ) ) { type = t; ok = true; }
+          if ( ok && type >= Task::TYPE_ASAP_FDUR && type <= Task::TYPE_FIXED_PERIOD ) value = type;
+          else error = QString( "'%1' is not a valid task type." ).arg( cell );
+          break;
+        }
+
+        case Task::SECTION_PRIORITY:
+        {
+          bool  ok;
+          int   priority = cell.toInt( &ok );
+          if ( ok && priority >= 0 && priority <= 999 ) value = priority;
+          else error = QString( "'%1' is not a valid priority." ).arg( cell );
+          break;
+        }
+      }
+
+      // record validation failures with the task and column they came from
+      if ( error.isEmpty() )
+        values[r][c] = value;
+      else
+      {
+        errors += QString( "Task %1 %2: %3\n" ).arg( id )
+                  .arg( Task::headerData( col ).toString() ).arg( error );
+        failures++;
+      }
+    }
+  }
+
+  // check pasted predecessors don't give circular references, including through summaries
+  if ( errors.isEmpty() && pastedPreds.contains( true ) )
+  {
+    for( int t = 1 ; t < m_tasks.size() ; t++ )
+    {
+      Task*  task = m_tasks.at(t);
+      if ( !pastedPreds.at(t) )
+        foreach( const Predecessors::Predecessor& pred, task->predecessors().list() )
+          depends[t].append( index( pred.task ) );
+
+      // summaries depend on their sub-tasks, so a sub-task depending on its summary is circular
+      if ( task->isSummary() )
+        for( int s = t + 1 ; s <= task->summaryEnd() ; s++ ) depends[t].append( s );
+    }
+
+    int  circular = circularTask( depends );
+    if ( circular >= 0 )
+      errors += QString( "Task %1 predecessors give a circular reference.\n" ).arg( circular );
+  }
+
+  // if any failures, return validation error text without changing plan
+  if ( !errors.isEmpty() )
+  {
+    errors.chop(1);
+    return errors;
+  }
+
+  // do paste via one undo/redo command, which schedules once
+  plan->push( new CommandTaskPaste( row, column, values, newRows ) );
+  return QString();
+}
+
+/****************************************** circularTask *****************************************/
+
+int  TasksModel::circularTask( const QVector< QList<int> >& depends ) const
+{
+  // depth first search of dependencies, a task reached again while still on the path is circular
+  QVector<char>               state( depends.size(), 0 );    // 0 unvisited, 1 on path, 2 done
+  QVector< QPair<int,int> >   path;                          // task & index of next dependency to visit
+  for( int first = 0 ; first < depends.size() ; first++ )
+  {
+    if ( state.at( first ) != 0 ) continue;
+    state[first] = 1;
+    path.append( qMakePair( first, 0 ) );
+
+    while ( !path.isEmpty() )
+    {
+      int  task = path.last().first;
+      int  next = path.last().second++;
+      if ( next >= depends.at( task ).size() )
+      {
+        state[task] = 2;
+        path.removeLast();
+        continue;
+      }
+
+      int  other = depends.at( task ).at( next );
+      if ( state.at( other ) == 1 ) return other;
+      if ( state.at( other ) == 0 )
+      {
+        state[other] = 1;
+        path.append( qMakePair( other, 0 ) );
+      }
+    }
+  }
+
+  return -1;
+}
@@ -23,12 +23,16 @@
 
 #include <QAbstractTableModel>
 #include <QSet>
+#include <QStringList>
 
 #include "datetime.h"
+#include "taskstore.h"
+#include "objectpool.h"
 
 class Task;
 class QXmlStreamWriter;
 class QXmlStreamReader;
+class PlanSnapshot;
 
 /*************************************************************************************************/
 /**************************** Table model containing all plan tasks ******************************/
@@ -45,21 +49,34 @@ public:
   DateTime       planBeginning();                                 // return start of earliest starting task
   DateTime       planEnd();                                       // return finish of latest finishing task
   int            number();                                        // return number of non-null tasks in plan
+  int            created() { return m_pool.created(); }           // return number of tasks ever created
+  int            blocks() { return m_pool.blocks(); }             // return number of pool blocks allocated
   void           schedule();                                      // re-schedule tasks
-  void           saveToStream( QXmlStreamWriter* );               // write tasks data to xml stream
+  void           saveToSnapshot( PlanSnapshot* );                 // capture tasks data for writing to xml stream
   void           loadFromStream( QXmlStreamReader* );             // load tasks data from xml stream
+  void           loadPredecessors( QXmlStreamReader* );           // load task predecessors from xml stream
+  void           loadFinished();                                  // set store & summaries once tasks loaded
 
   Task*          task( int n );                                   // return pointer to n'th task
-  int            index( Task* t ) { return m_tasks.indexOf(t); }  // return index of task, or -1
+  int            index( Task* t ) { return m_store.id(t); }       // return index of task, or -1
+  const TaskStore& store() const { return m_store; }             // return store of task scheduling fields
+  QList<Task*>   tasksBetween( DateTime, DateTime );              // return tasks active between date-times
 
   void           emitDataChangedRow( int );                       // emit data changed signal for row
   void           emitDataChangedColumn( int );                    // emit data changed signal for column
+  void           emitHeldChanges();                               // emit data changed signals held by plan
   bool           canIndent( int );                                // return true if task can be indented
   bool           canOutdent( int );                               // return true if task can be outdented
   bool           indentRows( QSet<int> );                         // indent selected rows
   bool           outdentRows( QSet<int> );                        // outdent selected rows
+  QString        paste( int, int, QList<QStringList> );           // paste rows of cells, return any errors
+  static QList<QStringList>  parseText( const QString& );         // parse tab separated text into rows of cells
+  void           appendRows( int );                               // append null tasks signalling model once
+  void           removeLastRows( int );                           // remove last tasks signalling model once
   Task*          nonNullTaskAbove( Task* );                       // returns task ptr or nullptr if none
   void           setSummaries();                                  // recalc summaries for all tasks
+  quint32        displayEpoch() const { return m_displayEpoch; }  // return epoch for task display caches
+  void           invalidateDisplay() { m_displayEpoch++; }        // invalidate all task display caches
   void           setOverride( QModelIndex i, QVariant v )
                    { m_overrideIndex = i; m_overrideValue = v; }  // set model override values
 
@@ -72,12 +89,27 @@ public:
   QVariant       headerData( int, Qt::Orientation, int ) const;                   // implement virtual header data
   Qt::ItemFlags  flags( const QModelIndex& ) const;                               // implement virtual return flags
 
+  static const int  MAX_PASTE_ERRORS = 20;                        // paste stops validating after this many failures
+
 signals:
-  void           ganttChanged();                                  // signal tasks could have changed so redraw gantt chart
+  void           ganttChanged( int, int );                        // signal task rows changed so redraw gantt chart rows
   void           editCell( const QModelIndex&,
                            const QString& ) const;                // signal that cell editing needs to continue
 private:
+  void           emitScheduleChanges( QVector<bool>& );           // emit signals for rows changed by scheduling
+  void           holdChanges( int, int );                         // extend rows changed while plan held
+  int            circularTask( const QVector< QList<int> >& ) const;  // return task on a dependency loop, or -1
+
   QList<Task*>    m_tasks;             // list of tasks in plan
+  ObjectPool<Task> m_pool;            // pool holding task objects
+
+  static const int  POOL_BLOCK = 1024; // tasks per pool block, plans often have thousands
+  TaskStore       m_store;             // contiguous copy of task scheduling fields
+  quint32         m_displayEpoch;      // incremented when all task display caches become invalid
+  quint32         m_stretchVersion;    // plan stretch version when last scheduled
+  int             m_heldFirst;         // first row changed while plan held, or -1 if none
+  int             m_heldLast;          // last row changed while plan held
+  QList<int>      m_edited;            // rows edited since last scheduled, summaries over them aggregate them
 
   QModelIndex     m_overrideIndex;     // with value can override model for edits in progress
   QVariant        m_overrideValue;     // with index can override model for edits in progress
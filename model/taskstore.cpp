@@ -0,0 +1,141 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "taskstore.h"
+#include "task.h"
+
+/*************************************************************************************************/
+/********************* Contiguous store of task fields used when scheduling **********************/
+/*************************************************************************************************/
+
+/****************************************** constructor ******************************************/
+
+TaskStore::TaskStore()
+{
+  // gantt intervals index built when first needed
+  m_intervalsValid = false;
+}
+
+/******************************************** rebuild ********************************************/
+
+void TaskStore::rebuild( const QList<Task*>& tasks )
+{
+  // resize arrays to match number of tasks, and re-synchronise every task
+  int  size = tasks.size();
+  m_null.resize( size );
+  m_indent.resize( size );
+  m_summaryEnd.resize( size );
+  m_type.resize( size );
+  m_priority.resize( size );
+  m_start.resize( size );
+  m_end.resize( size );
+  m_ganttStart.resize( size );
+  m_ganttEnd.resize( size );
+
+  m_intervalsValid = false;
+  m_ids.clear();
+  m_ids.reserve( size );
+  for( int id = 0 ; id < size ; id++ )
+  {
+    m_ids.insert( tasks.at(id), id );
+    update( id, tasks.at(id) );
+  }
+}
+
+/******************************************** refresh ********************************************/
+
+void TaskStore::refresh( const QList<Task*>& tasks )
+{
+  // task list only changes with a rebuild, so task ids are still valid and only fields re-copied
+  if ( tasks.size() != size() )
+  {
+    rebuild( tasks );
+    return;
+  }
+
+  for( int id = 0 ; id < size() ; id++ )
+    update( id, tasks.at(id) );
+}
+
+/********************************************* update ********************************************/
+
+void TaskStore::update( int id, const Task* task )
+{
+  // copy scheduling fields from task into store
+  Q_ASSERT( id >= 0 && id < size() );
+  m_null[id]       = task->isNull();
+  m_indent[id]     = task->m_indent;
+  m_summaryEnd[id] = task->m_summaryEnd;
+  m_type[id]       = task->m_type;
+  m_priority[id]   = task->m_priority;
+  m_start[id]      = task->m_start;
+  m_end[id]        = task->m_end;
+  m_ganttStart[id] = task->m_gantt.start();
+  m_ganttEnd[id]   = task->m_gantt.end();
+  m_intervalsValid = false;
+}
+
+/***************************************** earliestStart *****************************************/
+
+DateTime TaskStore::earliestStart( int first, int last ) const
+{
+  // return earliest start of non-null non-summary tasks in range
+  if ( last >= size() ) last = size() - 1;
+  DateTime  s = XDateTime::MAX_DATETIME;
+  for( int id = first ; id <= last ; id++ )
+    if ( !m_null[id] && m_summaryEnd[id] < 0 && m_start[id] < s ) s = m_start[id];
+
+  return s;
+}
+
+/******************************************* latestEnd *******************************************/
+
+DateTime TaskStore::latestEnd( int first, int last ) const
+{
+  // return latest end of non-null non-summary tasks in range
+  if ( last >= size() ) last = size() - 1;
+  DateTime  e = XDateTime::MIN_DATETIME;
+  for( int id = first ; id <= last ; id++ )
+    if ( !m_null[id] && m_summaryEnd[id] < 0 && m_end[id] > e ) e = m_end[id];
+
+  return e;
+}
+
+/***************************************** summaryAbove ******************************************/
+
+int TaskStore::summaryAbove( int id, int indent ) const
+{
+  // return id of nearest task above with indent less than given indent
+  while ( id > 0 && ( m_null[id] || m_indent[id] >= indent ) ) id--;
+  return id;
+}
+
+/******************************************** between ********************************************/
+
+QVector<int> TaskStore::between( DateTime start, DateTime end ) const
+{
+  // return ids of tasks whose gantt intersects range, rebuilding index if gantt data changed
+  if ( !m_intervalsValid )
+  {
+    m_intervals.build( *this );
+    m_intervalsValid = true;
+  }
+  return m_intervals.between( start, end );
+}
@@ -0,0 +1,80 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef TASKSTORE_H
+#define TASKSTORE_H
+
+#include <QVector>
+#include <QHash>
+
+#include "datetime.h"
+#include "taskintervals.h"
+
+class Task;
+
+/*************************************************************************************************/
+/********************* Contiguous store of task fields used when scheduling **********************/
+/*************************************************************************************************/
+
+class TaskStore
+{
+public:
+  TaskStore();                                                    // constructor
+
+  void       rebuild( const QList<Task*>& );                      // re-synchronise store with all tasks
+  void       refresh( const QList<Task*>& );                      // re-synchronise fields, task list unchanged
+  void       update( int, const Task* );                          // re-synchronise store for one task
+
+  int        size() const { return m_null.size(); }               // return number of tasks in store
+  int        id( const Task* t ) const { return m_ids.value( t, -1 ); }   // return task id, or -1
+
+  bool       isNull( int id ) const { return m_null[id]; }        // is task null (blank)
+  bool       isSummary( int id ) const { return m_summaryEnd[id] >= 0; }  // is task a summary
+  int        summaryEnd( int id ) const { return m_summaryEnd[id]; }      // summary last sub-task id, or -1
+  short      indent( int id ) const { return m_indent[id]; }      // task indent level
+  char       type( int id ) const { return m_type[id]; }          // task type
+  int        priority( int id ) const { return m_priority[id]; }  // task priority
+  DateTime   start( int id ) const { return m_start[id]; }        // task start (not summary derived)
+  DateTime   end( int id ) const { return m_end[id]; }            // task end (not summary derived)
+  DateTime   ganttStart( int id ) const { return m_ganttStart[id]; }  // task gantt start
+  DateTime   ganttEnd( int id ) const { return m_ganttEnd[id]; }  // task gantt end
+
+  DateTime   earliestStart( int, int ) const;                     // earliest start of non-summary tasks in range
+  DateTime   latestEnd( int, int ) const;                         // latest end of non-summary tasks in range
+  int        summaryAbove( int, int ) const;                      // id of summary above task at given indent
+  QVector<int>  between( DateTime, DateTime ) const;              // ids of tasks with gantt intersecting range
+
+private:
+  QHash<const Task*, int>  m_ids;           // task pointer to task id
+  QVector<bool>            m_null;          // task is null
+  QVector<short>           m_indent;        // task indent level
+  QVector<int>             m_summaryEnd;    // summary last sub-task id, or -1
+  QVector<char>            m_type;          // task type
+  QVector<int>             m_priority;      // task priority
+  QVector<DateTime>        m_start;         // task start date-time
+  QVector<DateTime>        m_end;           // task end date-time
+  QVector<DateTime>        m_ganttStart;    // task gantt start date-time
+  QVector<DateTime>        m_ganttEnd;      // task gantt end date-time
+
+  mutable TaskIntervals    m_intervals;     // index of task gantt intervals
+  mutable bool             m_intervalsValid;  // true if index matches gantt data
+};
+
+#endif // TASKSTORE_H
@@ -26,6 +26,8 @@
 #include <QDateTime>
 #include <cmath>
 
+#include "scanner.h"
+
 /*************************************************************************************************/
 /********************************** Quantity of time with units **********************************/
 /*************************************************************************************************/
@@ -64,34 +66,18 @@ public:
 
 /****************************************** constructor ******************************************/
 
-  TimeSpan( QString str )
+  TimeSpan( const QString& str )
   {
     // construct time-span from string
-    str = str.simplified();
-    QString lastchr = str.right(1);
-    if ( QString("0123456789.").contains(lastchr) )
-      m_units = UNIT_DAYS;   // no units specified so assume 'days'
-    else
-    {
-      if ( QString("MHdwmy").contains(lastchr) )   // check if valid units
-      {
-        m_units = lastchr.at(0).toLatin1();
-        str.chop(1);
-      }
-      else
-      {
-        m_units = UNIT_INVALID;
-        m_num   = 0.0;
-        return;
-      }
-    }
+    parse( QStringRef( &str ) );
+  }
 
-    bool  ok;
-    m_num = str.toDouble( &ok );
-    if ( !ok ) m_units = UNIT_INVALID;    // check remainder converted to number ok
+/****************************************** constructor ******************************************/
 
-    // only allow integer minutes
-    if ( m_units == UNIT_MINUTES ) m_num = floor(m_num);
+  TimeSpan( const QStringRef& ref )
+  {
+    // construct time-span from string ref, avoids temporary strings when loading
+    parse( ref );
   }
 
 /******************************************** methods ********************************************/
@@ -112,6 +98,44 @@ public:
   char       units() const   { return m_units; }
 
 private:
+  void       parse( QStringRef str )
+  {
+    // parse number and optional units in place, without temporary strings
+    str = Scanner::trimmed( str );
+    if ( str.isEmpty() )
+    {
+      m_units = UNIT_INVALID;
+      m_num   = 0.0;
+      return;
+    }
+
+    QChar lastchr = str.at( str.size() - 1 );
+    if ( ( lastchr >= '0' && lastchr <= '9' ) || lastchr == '.' )
+      m_units = UNIT_DAYS;   // no units specified so assume 'days'
+    else
+    {
+      if ( lastchr == UNIT_MINUTES || lastchr == UNIT_HOURS  || lastchr == UNIT_DAYS ||
+           lastchr == UNIT_WEEKS   || lastchr == UNIT_MONTHS || lastchr == UNIT_YEARS )   // check if valid units
+      {
+        m_units = lastchr.toLatin1();
+        str     = Scanner::trimmed( Scanner::mid( str, 0, str.size() - 1 ) );
+      }
+      else
+      {
+        m_units = UNIT_INVALID;
+        m_num   = 0.0;
+        return;
+      }
+    }
+
+    bool  ok;
+    m_num = str.toDouble( &ok );
+    if ( !ok ) m_units = UNIT_INVALID;    // check remainder converted to number ok
+
+    // only allow integer minutes
+    if ( m_units == UNIT_MINUTES ) m_num = floor(m_num);
+  }
+
   float      m_num;        // number of units time quantity
   char       m_units;      // units for time quantity
 };
@@ -0,0 +1,205 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "model/plan.h"
+#include "model/day.h"
+
+#include <QtTest>
+
+Plan*  plan;    // global variable
+
+/*************************************************************************************************/
+/************************ Benchmark day type period lookups for default days *********************/
+/*************************************************************************************************/
+
+class BenchDay : public QObject
+{
+  Q_OBJECT
+private slots:
+  void initTestCase();
+  void cleanupTestCase();
+  void doMinsZero_data() { days(); }
+  void doMinsZero();
+  void doMins_data() { days(); }
+  void doMins();
+  void doWork_data() { days(); }
+  void doWork();
+  void minsDone_data() { days(); }
+  void minsDone();
+  void minsToGo_data() { days(); }
+  void minsToGo();
+  void workDone_data() { days(); }
+  void workDone();
+  void workToGo_data() { days(); }
+  void workToGo();
+
+private:
+  void  days();                       // add default day types as test data rows
+};
+
+/***************************************** initTestCase ******************************************/
+
+void BenchDay::initTestCase()
+{
+  // days refer to plan when changed, so provide one
+  plan = new Plan();
+  plan->initialise();
+}
+
+/**************************************** cleanupTestCase ****************************************/
+
+void BenchDay::cleanupTestCase()
+{
+  // delete plan
+  delete plan;
+  plan = nullptr;
+}
+
+/********************************************* days **********************************************/
+
+void BenchDay::days()
+{
+  // every default day type from Day(int)
+  QTest::addColumn<int>( "type" );
+  QTest::newRow( "standard" )     << int( Day::DEFAULT_STANDARDWORK );
+  QTest::newRow( "short" )        << int( Day::DEFAULT_SHORT );
+  QTest::newRow( "evening" )      << int( Day::DEFAULT_EVENING );
+  QTest::newRow( "twentyfour" )   << int( Day::DEFAULT_TWENTYFOURHOURS );
+}
+
+/****************************************** doMinsZero *******************************************/
+
+void BenchDay::doMinsZero()
+{
+  // doing no work returns the time itself if working, otherwise the next period start
+  QFETCH( int, type );
+  Day  day( type );
+  for( Time t = 0 ; t <= day.end() ; t++ )
+  {
+    Time  expect = XTime::NULL_TIME;
+    for( int p = day.periods()-1 ; p >= 0 ; p-- )
+    {
+      if ( t >= day.start(p) && t <= day.end(p) ) { expect = t; break; }
+      if ( t < day.start(p) ) expect = day.start(p);
+    }
+    QCOMPARE( day.doMins( t, 0 ), expect );
+  }
+}
+
+/******************************************** doMins *********************************************/
+
+void BenchDay::doMins()
+{
+  // do every possible number of minutes from day start
+  QFETCH( int, type );
+  Day   day( type );
+  Time  start = day.start();
+  int   sum   = 0;
+  QBENCHMARK
+  {
+    for( int m = 0 ; m <= day.minutes() ; m++ )
+      sum += day.doMins( start, m );
+  }
+  QVERIFY( sum > 0 );
+}
+
+/******************************************** doWork *********************************************/
+
+void BenchDay::doWork()
+{
+  // do every hundredth of day's work from day start
+  QFETCH( int, type );
+  Day   day( type );
+  Time  start = day.start();
+  int   sum   = 0;
+  QBENCHMARK
+  {
+    for( int w = 0 ; w <= 100 ; w++ )
+      sum += day.doWork( start, day.work() * w / 100.0f );
+  }
+  QVERIFY( sum > 0 );
+}
+
+/******************************************* minsDone ********************************************/
+
+void BenchDay::minsDone()
+{
+  // minutes done at every minute of day
+  QFETCH( int, type );
+  Day  day( type );
+  int  sum = 0;
+  QBENCHMARK
+  {
+    for( Time t = 0 ; t < 1440 ; t++ )
+      sum += day.minsDone( t );
+  }
+  QVERIFY( sum > 0 );
+}
+
+/******************************************* minsToGo ********************************************/
+
+void BenchDay::minsToGo()
+{
+  // minutes to go at every minute of day
+  QFETCH( int, type );
+  Day  day( type );
+  int  sum = 0;
+  QBENCHMARK
+  {
+    for( Time t = 0 ; t < 1440 ; t++ )
+      sum += day.minsToGo( t );
+  }
+  QVERIFY( sum > 0 );
+}
+
+/******************************************* workDone ********************************************/
+
+void BenchDay::workDone()
+{
+  // work done at every minute of day
+  QFETCH( int, type );
+  Day    day( type );
+  float  sum = 0.0f;
+  QBENCHMARK
+  {
+    for( Time t = 0 ; t < 1440 ; t++ )
+      sum += day.workDone( t );
+  }
+  QVERIFY( sum > 0.0f );
+}
+
+/******************************************* workToGo ********************************************/
+
+void BenchDay::workToGo()
+{
+  // work to go at every minute of day
+  QFETCH( int, type );
+  Day    day( type );
+  float  sum = 0.0f;
+  QBENCHMARK
+  {
+    for( Time t = 0 ; t < 1440 ; t++ )
+      sum += day.workToGo( t );
+  }
+  QVERIFY( sum > 0.0f );
+}
+
+QTEST_MAIN( BenchDay )
+#include "bench_day.moc"
@@ -0,0 +1,11 @@
+#-------------------------------------------------
+#
+# Benchmark day type period lookups
+#
+#-------------------------------------------------
+
+include( ../model.pri )
+
+TARGET = bench_day
+
+SOURCES += bench_day.cpp
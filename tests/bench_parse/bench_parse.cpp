@@ -0,0 +1,411 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "model/plan.h"
+#include "model/tasksmodel.h"
+#include "model/resource.h"
+#include "model/task.h"
+#include "model/plansnapshot.h"
+#include "model/planloader.h"
+
+#include <QtTest>
+
+Plan*  plan;    // global variable
+
+/*************************************************************************************************/
+/******************* Original string splitting parsers, kept as reference only *******************/
+/*************************************************************************************************/
+
+namespace Reference
+{
+  struct Span       { float num; char units; };
+  struct Pred       { int task; char type; Span lag; };
+
+  /******************************************* timeSpan ******************************************/
+
+  Span  timeSpan( QString str )
+  {
+    // original TimeSpan( QString ) constructor
+    Span  span;
+    str = str.simplified();
+    QString lastchr = str.right(1);
+    if ( QString("0123456789.").contains(lastchr) ) span.units = TimeSpan::UNIT_DAYS;
+    else if ( QString("MHdwmy").contains(lastchr) )
+    {
+      span.units = lastchr.at(0).toLatin1();
+      str.chop(1);
+    }
+    else
+    {
+      span.units = TimeSpan::UNIT_INVALID;
+      span.num   = 0.0;
+      return span;
+    }
+
+    bool ok;
+    span.num = str.toDouble(&ok);
+    if ( !ok ) span.units = TimeSpan::UNIT_INVALID;
+    if ( span.units == TimeSpan::UNIT_MINUTES ) span.num = floor(span.num);
+    return span;
+  }
+
+  /***************************************** predecessors ****************************************/
+
+  QList<Pred>  predecessors( QString text )
+  {
+    // original Predecessors( QString ) constructor, with task as number
+    QList<Pred>  preds;
+    foreach( QString part, text.split( ',', QString::SkipEmptyParts ) )
+    {
+      part = part.trimmed();
+      int digit = 0;
+      while ( part.length() > digit && part.at(digit).isDigit() ) digit++;
+
+      Pred  pred;
+      pred.task = part.left(digit).toInt();
+      pred.type = Predecessors::TYPE_DEFAULT;
+      pred.lag  = timeSpan( "0" );
+
+      part.remove( 0, digit );
+      part = part.trimmed();
+      if ( !part.isEmpty() )
+      {
+        if ( part.startsWith( Predecessors::LABEL_FINISH_START,  Qt::CaseInsensitive ) )
+          pred.type = Predecessors::TYPE_FINISH_START;
+        if ( part.startsWith( Predecessors::LABEL_START_START,   Qt::CaseInsensitive ) )
+          pred.type = Predecessors::TYPE_START_START;
+        if ( part.startsWith( Predecessors::LABEL_START_FINISH,  Qt::CaseInsensitive ) )
+          pred.type = Predecessors::TYPE_START_FINISH;
+        if ( part.startsWith( Predecessors::LABEL_FINISH_FINISH, Qt::CaseInsensitive ) )
+          pred.type = Predecessors::TYPE_FINISH_FINISH;
+
+        part.remove( 0, 2 );
+        part = part.trimmed();
+        if ( !part.isEmpty() ) pred.lag = timeSpan( part );
+      }
+
+      preds.append( pred );
+    }
+    return preds;
+  }
+
+  /****************************************** resources ******************************************/
+
+  QString  resources( QString text )
+  {
+    // original TaskResources( QString ) constructor, returned in TaskResources::toString format
+    QString  str;
+    foreach( QString part, text.split( ',', QString::SkipEmptyParts ) )
+    {
+      QString tag, max;
+      if ( part.contains('[') )
+      {
+        tag = part.section( '[', 0, 0 ).simplified();
+        max = part.section( '[', 1 ).remove( ']' );
+      }
+      else
+      {
+        tag = part.simplified();
+        max = "0";
+      }
+
+      str += tag;
+      if ( max.toFloat() > 0.0 ) str += QString( "[%1]" ).arg( max.toFloat() );
+      str += ", ";
+    }
+
+    str.chop(2);
+    return str;
+  }
+}
+
+/*************************************************************************************************/
+/******************* Check and benchmark in-place parsing against the original *******************/
+/*************************************************************************************************/
+
+class BenchParse : public QObject
+{
+  Q_OBJECT
+private slots:
+  void initTestCase();
+  void cleanupTestCase();
+  void timeSpan_data();
+  void timeSpan();
+  void predecessors_data();
+  void predecessors();
+  void resources_data();
+  void resources();
+  void parseTimeSpans_data();
+  void parseTimeSpans();
+  void parsePredecessors_data();
+  void parsePredecessors();
+  void parseResources_data();
+  void parseResources();
+  void load();
+
+private:
+  void  parsers();                    // add reference & scanner rows for parse benchmarks
+
+  QTemporaryDir  m_dir;               // directory for benchmark plan file
+  QString        m_filename;          // benchmark plan file
+
+  static const int  TASKS = 50000;    // tasks in benchmark plan
+};
+
+/***************************************** initTestCase ******************************************/
+
+void BenchParse::initTestCase()
+{
+  // plan with typical durations, predecessors and resources on every task
+  plan = new Plan();
+  plan->initialise();
+  plan->resource(0)->setData( Resource::SECTION_INITIALS, "AB" );
+  plan->resource(1)->setData( Resource::SECTION_INITIALS, "CD" );
+  int  first = plan->tasks()->rowCount();
+  plan->tasks()->appendRows( TASKS );
+  for( int id = first ; id < first + TASKS ; id++ )
+  {
+    Task*  task = plan->task( id );
+    task->setData( Task::SECTION_TITLE, QString("Task %1").arg(id) );
+    task->setData( Task::SECTION_DURATION, QString("%1d").arg( id % 5 + 1 ) );
+    task->setData( Task::SECTION_RES, id % 2 ? "AB" : "AB[0.5], CD[2]" );
+    if ( id % 10 ) task->setData( Task::SECTION_PREDS, id % 3 ? QString("%1").arg( id - 1 )
+                                                              : QString("%1SS+1d").arg( id - 1 ) );
+  }
+  plan->tasks()->loadFinished();
+
+  // save plan to file for load benchmark
+  QVERIFY( m_dir.isValid() );
+  m_filename = m_dir.path() + "/bench.xml";
+  PlanSnapshot       snapshot;
+  QXmlStreamWriter*  stream = snapshot.stream();
+  stream->writeStartDocument();
+  stream->writeStartElement( "projectplanner" );
+  stream->writeAttribute( "version", "2014-10" );
+  plan->saveToSnapshot( &snapshot );
+  QVERIFY2( snapshot.save( m_filename ), qPrintable( snapshot.error() ) );
+}
+
+/**************************************** cleanupTestCase ****************************************/
+
+void BenchParse::cleanupTestCase()
+{
+  // delete benchmark plan
+  delete plan;
+  plan = nullptr;
+}
+
+/***************************************** timeSpan_data *****************************************/
+
+void BenchParse::timeSpan_data()
+{
+  // time-span strings as typed in cells and saved in plan files
+  QTest::addColumn<QString>( "text" );
+  QStringList  texts;
+  texts << "3" << "3d" << "2.5w" << " 2.5w " << "90M" << "90.7M" << "1.5H" << "2m" << "1y"
+        << "-1d" << "0" << "." << "d" << "x" << "3x" << "" << " " << "1e2d" << "3dd";
+  foreach( QString text, texts )
+    QTest::newRow( qPrintable( "'" + text + "'" ) ) << text;
+}
+
+/******************************************* timeSpan ********************************************/
+
+void BenchParse::timeSpan()
+{
+  // in-place parse gives same number & units as original
+  QFETCH( QString, text );
+  Reference::Span  ref  = Reference::timeSpan( text );
+  TimeSpan         span( text );
+  QCOMPARE( span.units(), ref.units );
+  QCOMPARE( span.number(), ref.num );
+}
+
+/*************************************** predecessors_data ***************************************/
+
+void BenchParse::predecessors_data()
+{
+  // predecessor strings as typed in cells and saved in plan files
+  QTest::addColumn<QString>( "text" );
+  QStringList  texts;
+  texts << "1" << "1,2" << " 1 , 2 " << "1,,2" << "1FS" << "2SS" << "3sf" << "4Ff" << "1FS+2d"
+        << "1 SS -1.5w" << "2FF 3" << "3XX2d" << "1,2FS,3SS 2d, 4ff -1d" << "FS" << " , " << "";
+  foreach( QString text, texts )
+    QTest::newRow( qPrintable( "'" + text + "'" ) ) << text;
+}
+
+/***************************************** predecessors ******************************************/
+
+void BenchParse::predecessors()
+{
+  // in-place parse gives same tasks, types & lags as original
+  QFETCH( QString, text );
+  QList<Reference::Pred>  ref = Reference::predecessors( text );
+  Predecessors            preds( text );
+  QCOMPARE( preds.list().size(), ref.size() );
+  for( int p = 0 ; p < ref.size() ; p++ )
+  {
+    const Predecessors::Predecessor&  pred = preds.list().at(p);
+    QCOMPARE( pred.task, plan->task( ref.at(p).task ) );
+    QCOMPARE( int(pred.type), int(ref.at(p).type) );
+    QCOMPARE( pred.lag.units(), ref.at(p).lag.units );
+    QCOMPARE( pred.lag.number(), ref.at(p).lag.num );
+  }
+}
+
+/***************************************** resources_data ****************************************/
+
+void BenchParse::resources_data()
+{
+  // resource assignment strings as typed in cells and saved in plan files
+  QTest::addColumn<QString>( "text" );
+  QStringList  texts;
+  texts << "AB" << "AB, CD" << " AB ,CD " << "AB[2]" << "AB[0.5], CD[2]" << "AB[50%]" << "AB[]"
+        << "AB[2" << "  Bob   Smith [3]" << "AB,,CD" << "[2]" << " , " << "";
+  foreach( QString text, texts )
+    QTest::newRow( qPrintable( "'" + text + "'" ) ) << text;
+}
+
+/******************************************* resources *******************************************/
+
+void BenchParse::resources()
+{
+  // in-place parse gives same tags & maximums as original
+  QFETCH( QString, text );
+  QCOMPARE( TaskResources( text ).toString(), Reference::resources( text ) );
+}
+
+/******************************************* parsers *********************************************/
+
+void BenchParse::parsers()
+{
+  // rows for original string splitting and in-place scanner parsing
+  QTest::addColumn<bool>( "scanner" );
+  QTest::newRow( "reference" ) << false;
+  QTest::newRow( "scanner" )   << true;
+}
+
+/************************************** parseTimeSpans_data **************************************/
+
+void BenchParse::parseTimeSpans_data()
+{
+  parsers();
+}
+
+/**************************************** parseTimeSpans *****************************************/
+
+void BenchParse::parseTimeSpans()
+{
+  // parse every task duration in benchmark plan
+  QFETCH( bool, scanner );
+  QStringList  texts;
+  for( int id = 0 ; id < TASKS ; id++ )
+    texts << QString("%1d").arg( id % 5 + 1 );
+
+  float  total = 0.0;
+  QBENCHMARK
+  {
+    total = 0.0;
+    foreach( const QString& text, texts )
+      total += scanner ? TimeSpan( text ).number() : Reference::timeSpan( text ).num;
+  }
+  QVERIFY( total > 0.0 );
+}
+
+/************************************ parsePredecessors_data *************************************/
+
+void BenchParse::parsePredecessors_data()
+{
+  parsers();
+}
+
+/*************************************** parsePredecessors ***************************************/
+
+void BenchParse::parsePredecessors()
+{
+  // parse every task predecessors in benchmark plan
+  QFETCH( bool, scanner );
+  QStringList  texts;
+  for( int id = 0 ; id < TASKS ; id++ )
+    texts << plan->task( id )->dataDisplayRole( Task::SECTION_PREDS ).toString();
+
+  int  total = 0;
+  QBENCHMARK
+  {
+    total = 0;
+    foreach( const QString& text, texts )
+      total += scanner ? Predecessors( text ).list().size() : Reference::predecessors( text ).size();
+  }
+  QVERIFY( total > 0 );
+}
+
+/************************************** parseResources_data **************************************/
+
+void BenchParse::parseResources_data()
+{
+  parsers();
+}
+
+/**************************************** parseResources *****************************************/
+
+void BenchParse::parseResources()
+{
+  // parse every task resources in benchmark plan
+  QFETCH( bool, scanner );
+  QStringList  texts;
+  for( int id = 0 ; id < TASKS ; id++ )
+    texts << plan->task( id )->dataDisplayRole( Task::SECTION_RES ).toString();
+
+  int  total = 0;
+  QBENCHMARK
+  {
+    total = 0;
+    foreach( const QString& text, texts )
+      total += scanner ? !TaskResources( text ).isEmpty() : !Reference::resources( text ).isEmpty();
+  }
+  QVERIFY( total > 0 );
+}
+
+/********************************************* load **********************************************/
+
+void BenchParse::load()
+{
+  // load whole benchmark plan file into new plan, as when opening a file
+  QFile  file( m_filename );
+  QVERIFY( file.open( QIODevice::ReadOnly ) );
+  QByteArray  data = file.readAll();
+  file.close();
+
+  Plan*  oldPlan = plan;
+  int    tasks   = 0;
+  QBENCHMARK
+  {
+    plan = new Plan();
+    PlanLoader  loader( data );
+    bool  ok = loader.load( m_filename );
+    tasks = plan->numTasks();
+    delete plan;
+    plan = oldPlan;
+    QVERIFY2( ok, qPrintable( loader.errorString() ) );
+  }
+  QCOMPARE( tasks, oldPlan->numTasks() );
+}
+
+QTEST_MAIN( BenchParse )
+#include "bench_parse.moc"
@@ -0,0 +1,11 @@
+#-------------------------------------------------
+#
+# Check and benchmark in-place parsing against the original parsers
+#
+#-------------------------------------------------
+
+include( ../model.pri )
+
+TARGET = bench_parse
+
+SOURCES += bench_parse.cpp
@@ -0,0 +1,122 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "model/plan.h"
+#include "model/tasksmodel.h"
+#include "model/taskstore.h"
+#include "model/task.h"
+
+#include <QtTest>
+
+Plan*  plan;    // global variable
+
+/*************************************************************************************************/
+/*********************** Benchmark scheduling and task store on large plans **********************/
+/*************************************************************************************************/
+
+class BenchSchedule : public QObject
+{
+  Q_OBJECT
+private slots:
+  void initTestCase();
+  void cleanupTestCase();
+  void schedule();
+  void storeRebuild();
+  void storeRefresh();
+
+private:
+  QList<Task*>  tasks();              // return all plan tasks
+
+  static const int  TASKS = 100000;   // tasks in benchmark plan
+};
+
+/***************************************** initTestCase ******************************************/
+
+void BenchSchedule::initTestCase()
+{
+  // plan of chained tasks, every tenth starting a new chain so summaries of store ranges vary
+  plan = new Plan();
+  plan->initialise();
+  int  first = plan->tasks()->rowCount();
+  plan->tasks()->appendRows( TASKS );
+  for( int id = first ; id < first + TASKS ; id++ )
+  {
+    Task*  task = plan->task( id );
+    task->setData( Task::SECTION_TITLE, QString("Task %1").arg(id) );
+    task->setData( Task::SECTION_DURATION, QString("%1d").arg( id % 5 + 1 ) );
+    if ( id % 10 ) task->setPredecessors( Predecessors( QString("%1").arg( id - 1 ) ) );
+  }
+  plan->tasks()->loadFinished();
+}
+
+/**************************************** cleanupTestCase ****************************************/
+
+void BenchSchedule::cleanupTestCase()
+{
+  // delete benchmark plan
+  delete plan;
+  plan = nullptr;
+}
+
+/******************************************* schedule ********************************************/
+
+void BenchSchedule::schedule()
+{
+  // whole scheduling pass, as after every edit
+  QBENCHMARK { plan->tasks()->schedule(); }
+  QVERIFY( plan->task( plan->tasks()->rowCount() - 1 )->end() > plan->start() );
+}
+
+/***************************************** storeRebuild ******************************************/
+
+void BenchSchedule::storeRebuild()
+{
+  // re-synchronise store including task id hash, as after rows appended or removed
+  QList<Task*>  list = tasks();
+  TaskStore     store;
+  QBENCHMARK { store.rebuild( list ); }
+  QCOMPARE( store.id( list.last() ), list.size() - 1 );
+}
+
+/***************************************** storeRefresh ******************************************/
+
+void BenchSchedule::storeRefresh()
+{
+  // re-synchronise store fields only, as at start of each scheduling pass
+  QList<Task*>  list = tasks();
+  TaskStore     store;
+  store.rebuild( list );
+  QBENCHMARK { store.refresh( list ); }
+  QCOMPARE( store.id( list.last() ), list.size() - 1 );
+}
+
+/********************************************* tasks *********************************************/
+
+QList<Task*>  BenchSchedule::tasks()
+{
+  // return all plan tasks in id order
+  QList<Task*>  list;
+  for( int id = 0 ; id < plan->tasks()->rowCount() ; id++ )
+    list.append( plan->task( id ) );
+  return list;
+}
+
+QTEST_MAIN( BenchSchedule )
+#include "bench_schedule.moc"
@@ -0,0 +1,11 @@
+#-------------------------------------------------
+#
+# Benchmark scheduling and task store on large plans
+#
+#-------------------------------------------------
+
+include( ../model.pri )
+
+TARGET = bench_schedule
+
+SOURCES += bench_schedule.cpp
@@ -0,0 +1,40 @@
+#-------------------------------------------------
+#
+# Plan model sources shared by tests and benchmarks
+#
+#-------------------------------------------------
+
+QT       += core gui widgets testlib
+
+CONFIG   += c++11 console testcase
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += $$PWD/..
+
+SOURCES += \
+    $$PWD/../model/plan.cpp \
+    $$PWD/../model/day.cpp \
+    $$PWD/../model/daysmodel.cpp \
+    $$PWD/../model/datetime.cpp \
+    $$PWD/../model/calendar.cpp \
+    $$PWD/../model/calendarsmodel.cpp \
+    $$PWD/../model/calendarcombiner.cpp \
+    $$PWD/../model/resource.cpp \
+    $$PWD/../model/resourcesmodel.cpp \
+    $$PWD/../model/task.cpp \
+    $$PWD/../model/tasksmodel.cpp \
+    $$PWD/../model/predecessors.cpp \
+    $$PWD/../model/ganttdata.cpp \
+    $$PWD/../model/ganttbatch.cpp \
+    $$PWD/../model/labelcache.cpp \
+    $$PWD/../model/taskresources.cpp \
+    $$PWD/../model/resourcefree.cpp \
+    $$PWD/../model/taskstore.cpp \
+    $$PWD/../model/taskintervals.cpp \
+    $$PWD/../model/tag.cpp \
+    $$PWD/../model/journal.cpp \
+    $$PWD/../model/plansnapshot.cpp \
+    $$PWD/../model/planloader.cpp \
+    $$PWD/../model/plancompress.cpp
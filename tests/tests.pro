@@ -0,0 +1,13 @@
+#-------------------------------------------------
+#
+# Tests and benchmarks for plan model, run each with -platform offscreen
+#
+#-------------------------------------------------
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    bench_schedule \
+    bench_day \
+    bench_parse \
+    tst_datetime
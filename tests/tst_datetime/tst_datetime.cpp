@@ -0,0 +1,154 @@
+/***************************************************************************
+ *   Copyright (C) 2014 by Richard Crook                                   *
+ *   http://code.google.com/p/projectplanner                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "model/plan.h"
+#include "model/datetime.h"
+
+#include <QtTest>
+
+Plan*  plan;    // global variable, not used by date arithmetic
+
+/*************************************************************************************************/
+/************** Test civil calendar date arithmetic against QDate for every Date *****************/
+/*************************************************************************************************/
+
+class TestDateTime : public QObject
+{
+  Q_OBJECT
+private slots:
+  void ymd();
+  void date();
+  void daysInMonth();
+  void addMonths_data();
+  void addMonths();
+  void addYears_data();
+  void addYears();
+  void truncWeek();
+};
+
+/********************************************* ymd ***********************************************/
+
+void TestDateTime::ymd()
+{
+  // every Date converted to year, month, day must match QDate
+  for( Date d = XDate::MIN_DATE ; d <= XDate::MAX_DATE ; d++ )
+  {
+    int    year, mon, day;
+    XDate::ymd( d, year, mon, day );
+    QDate  qd = XDate::qdate( d );
+    if ( year != qd.year() || mon != qd.month() || day != qd.day() )
+      QFAIL( qPrintable( QString("Date %1 gave %2-%3-%4 not %5").arg( d )
+                         .arg( year ).arg( mon ).arg( day ).arg( qd.toString( Qt::ISODate ) ) ) );
+  }
+}
+
+/********************************************* date **********************************************/
+
+void TestDateTime::date()
+{
+  // every year, month, day converted to Date must match QDate
+  for( QDate qd = XDate::MIN_QDATE ; qd <= XDate::MAX_QDATE ; qd = qd.addDays(1) )
+  {
+    Date  d = XDate::date( qd.year(), qd.month(), qd.day() );
+    if ( d != XDate::date( qd ) )
+      QFAIL( qPrintable( QString("%1 gave Date %2 not %3").arg( qd.toString( Qt::ISODate ) )
+                         .arg( d ).arg( XDate::date( qd ) ) ) );
+  }
+}
+
+/****************************************** daysInMonth ******************************************/
+
+void TestDateTime::daysInMonth()
+{
+  // every month of every supported year must match QDate
+  for( int year = 1 ; year <= 7999 ; year++ )
+    for( int mon = 1 ; mon <= 12 ; mon++ )
+      if ( XDate::daysInMonth( year, mon ) != QDate( year, mon, 1 ).daysInMonth() )
+        QFAIL( qPrintable( QString("%1-%2 days wrong").arg( year ).arg( mon ) ) );
+}
+
+/******************************************* addMonths *******************************************/
+
+void TestDateTime::addMonths_data()
+{
+  // month moves either side of zero including whole years and leap cycles
+  QTest::addColumn<int>( "months" );
+  foreach( int months, QList<int>() << -49 << -12 << -1 << 0 << 1 << 2 << 11 << 12 << 13 << 48 )
+    QTest::newRow( qPrintable( QString("%1").arg( months ) ) ) << months;
+}
+
+void TestDateTime::addMonths()
+{
+  // every Date moved by months must match QDate, where result is within supported range
+  QFETCH( int, months );
+  for( Date d = XDate::MIN_DATE ; d <= XDate::MAX_DATE ; d++ )
+  {
+    QDate  expect = XDate::qdate( d ).addMonths( months );
+    if ( expect < XDate::MIN_QDATE || expect > XDate::MAX_QDATE ) continue;
+    if ( XDate::addMonths( d, months ) != XDate::date( expect ) )
+      QFAIL( qPrintable( QString("%1 plus %2 months gave %3 not %4")
+                         .arg( XDate::qdate( d ).toString( Qt::ISODate ) ).arg( months )
+                         .arg( XDate::qdate( XDate::addMonths( d, months ) ).toString( Qt::ISODate ) )
+                         .arg( expect.toString( Qt::ISODate ) ) ) );
+  }
+}
+
+/******************************************* addYears ********************************************/
+
+void TestDateTime::addYears_data()
+{
+  // year moves either side of zero including leap and century years
+  QTest::addColumn<int>( "years" );
+  foreach( int years, QList<int>() << -400 << -100 << -4 << -1 << 0 << 1 << 3 << 4 << 100 << 400 )
+    QTest::newRow( qPrintable( QString("%1").arg( years ) ) ) << years;
+}
+
+void TestDateTime::addYears()
+{
+  // every Date moved by years must match QDate, where result is within supported range
+  QFETCH( int, years );
+  for( Date d = XDate::MIN_DATE ; d <= XDate::MAX_DATE ; d++ )
+  {
+    QDate  expect = XDate::qdate( d ).addYears( years );
+    if ( expect < XDate::MIN_QDATE || expect > XDate::MAX_QDATE ) continue;
+    if ( XDate::addYears( d, years ) != XDate::date( expect ) )
+      QFAIL( qPrintable( QString("%1 plus %2 years gave %3 not %4")
+                         .arg( XDate::qdate( d ).toString( Qt::ISODate ) ).arg( years )
+                         .arg( XDate::qdate( XDate::addYears( d, years ) ).toString( Qt::ISODate ) )
+                         .arg( expect.toString( Qt::ISODate ) ) ) );
+  }
+}
+
+/******************************************* truncWeek *******************************************/
+
+void TestDateTime::truncWeek()
+{
+  // every DateTime truncated to week must give the Monday from QDate, 1st Jan 0001 was a Monday
+  for( Date d = XDate::MIN_DATE ; d <= XDate::MAX_DATE ; d++ )
+  {
+    QDate     qd     = XDate::qdate( d );
+    DateTime  expect = 1440u * XDate::date( qd.addDays( 1 - qd.dayOfWeek() ) );
+    if ( XDateTime::trunc( 1440u * d + 720u, XDateTime::INTERVAL_WEEK ) != expect )
+      QFAIL( qPrintable( QString("%1 truncated to wrong week").arg( qd.toString( Qt::ISODate ) ) ) );
+  }
+}
+
+QTEST_APPLESS_MAIN( TestDateTime )
+#include "tst_datetime.moc"
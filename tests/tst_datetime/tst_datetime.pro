@@ -0,0 +1,11 @@
+#-------------------------------------------------
+#
+# Test civil calendar date arithmetic against QDate
+#
+#-------------------------------------------------
+
+include( ../model.pri )
+
+TARGET = tst_datetime
+
+SOURCES += tst_datetime.cpp